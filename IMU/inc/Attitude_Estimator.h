@@ -0,0 +1,71 @@
+/*
+ * Attitude_Estimator.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef ATTITUDE_ESTIMATOR_H_
+#define ATTITUDE_ESTIMATOR_H_
+
+#include <stdint.h>
+#include <cmath>
+
+namespace flyhero {
+
+enum Estimator_Type { ESTIMATOR_MAHONY, ESTIMATOR_MADGWICK, ESTIMATOR_EKF };
+
+// Fuses gyro and accel into body attitude kept as quaternion (body to world,
+// q0 scalar). Euler angles are not part of the filters, consumers convert
+// only when they really need them.
+class Attitude_Estimator {
+public:
+	struct Quaternion {
+		float q0, q1, q2, q3;
+	};
+
+private:
+	Attitude_Estimator(Attitude_Estimator const&);
+	Attitude_Estimator& operator=(Attitude_Estimator const&);
+
+protected:
+	static constexpr float PI = 3.14159265358979323846f;
+	static constexpr float DEG_TO_RAD = PI / 180;
+	static constexpr float RAD_TO_DEG = 180 / PI;
+
+	Quaternion quaternion;
+	// covered by Predict() since the last Update() [s]
+	float predicted_time;
+
+	Attitude_Estimator();
+	~Attitude_Estimator() {}
+
+	virtual void reset() = 0;
+	void normalise();
+	static void normalise(Quaternion& quaternion);
+	// time accel correction stands for, the last one does not apply to predictions
+	float correction_dt(float dt);
+	// body rates [rad/s]
+	void integrate(float x, float y, float z, float dt);
+	static void integrate(Quaternion& quaternion, float x, float y, float z, float dt);
+
+public:
+	// gyro [deg/s], accel [g] (only its direction matters to most filters), dt [s]
+	virtual void Update(const float gyro[3], const float accel[3], float dt) = 0;
+	// gyro only, cheap step for samples between full updates
+	virtual void Predict(const float gyro[3], float dt);
+	void Reset();
+	const Quaternion& Get_Quaternion();
+	virtual const char* Get_Name() = 0;
+
+	// body to world, columns are body axes in world frame
+	static void Get_Rotation_Matrix(const Quaternion& quaternion, float matrix[3][3]);
+	// rotates attitude ahead by constant gyro [deg/s] over dt [s], estimator state is left alone
+	static void Extrapolate(const Quaternion& quaternion, const float gyro[3], float dt, Quaternion& extrapolated);
+	// roll, pitch, yaw [deg], pitch is +-90 deg at most
+	static void Get_Euler(const Quaternion& quaternion, float& roll, float& pitch, float& yaw);
+};
+
+} /* namespace flyhero */
+
+#endif /* ATTITUDE_ESTIMATOR_H_ */
@@ -9,7 +9,6 @@
 #define CONFIG_H_
 
 #include <stm32f4xx_hal.h>
-#include "MPU6050.h"
 
 namespace flyhero {
 
@@ -29,33 +28,28 @@ static const uint32_t IMU_DMA_CHANNEL		= DMA_CHANNEL_1;
 static GPIO_TypeDef *const IMU_INT_BASE		= GPIOB;
 static const uint32_t IMU_INT_PIN			= GPIO_PIN_1;
 
-// we also need to implement IRQs here
-extern "C" {
-	void DMA1_Stream5_IRQHandler(void)
-	{
-		HAL_DMA_IRQHandler(MPU6050::Instance().Get_DMA_Rx_Handle());
-	}
-
-	void EXTI1_IRQHandler(void)
-	{
-		HAL_GPIO_EXTI_IRQHandler(IMU_INT_PIN);
-	}
-
-	void I2C1_EV_IRQHandler(void)
-	{
-		HAL_I2C_EV_IRQHandler(MPU6050::Instance().Get_I2C_Handle());
-	}
-
-	void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
-		if (MPU6050::Instance().Data_Read_Callback != NULL)
-			MPU6050::Instance().Data_Read_Callback();
-	}
-
-	void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
-		if (MPU6050::Instance().Data_Ready_Callback != NULL)
-			MPU6050::Instance().Data_Ready_Callback();
-	}
-}
+/* SPI sensors (MPU6000, ICM-20602), INT above is shared */
+
+static SPI_TypeDef *const IMU_SPI			= SPI1;
+// SCK, AF5 remap, PA5 - PA7 drive the LEDs
+static const uint32_t IMU_SCK_PIN			= GPIO_PIN_3;
+static GPIO_TypeDef *const IMU_SCK_BASE		= GPIOB;
+// MISO
+static const uint32_t IMU_MISO_PIN			= GPIO_PIN_4;
+static GPIO_TypeDef *const IMU_MISO_BASE	= GPIOB;
+// MOSI
+static const uint32_t IMU_MOSI_PIN			= GPIO_PIN_5;
+static GPIO_TypeDef *const IMU_MOSI_BASE	= GPIOB;
+// CS, driven by software
+static const uint32_t IMU_CS_PIN			= GPIO_PIN_4;
+static GPIO_TypeDef *const IMU_CS_BASE		= GPIOA;
+
+// DMA
+static DMA_Stream_TypeDef *const IMU_SPI_DMA_RX	= DMA2_Stream0;
+static DMA_Stream_TypeDef *const IMU_SPI_DMA_TX	= DMA2_Stream3;
+static const uint32_t IMU_SPI_DMA_CHANNEL	= DMA_CHANNEL_3;
+
+// IRQ handlers are in IMU.cpp and in the backend sources
 
 }
 
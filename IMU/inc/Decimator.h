@@ -0,0 +1,145 @@
+/*
+ * Decimator.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef DECIMATOR_H_
+#define DECIMATOR_H_
+
+#include <stdint.h>
+#include "Biquad_Bank.h"
+
+namespace flyhero {
+
+// Brings N channels down by an integer ratio, one input per call and one output
+// every ratio-th call. Boxcar averages each block of inputs, CIC2 is a second
+// order CIC - a triangle over two blocks, sinc^2 response with zeros at every
+// multiple of the output rate, twice the boxcar delay. Each input is weighted
+// into the current and the next output at once, so every call costs the same
+// and no delay line is kept. Optional low pass biquad runs at input rate ahead
+// of it for more alias rejection.
+template <uint8_t N>
+class Decimator {
+public:
+	static const uint8_t MAX_RATIO = 8;
+
+	enum Order {
+		ORDER_BOXCAR = 1,
+		ORDER_CIC2 = 2
+	};
+
+private:
+	Decimator(Decimator const&);
+	Decimator& operator=(Decimator const&);
+
+	Biquad_Bank<N> anti_alias;
+	bool anti_alias_enabled;
+	uint8_t ratio;
+	Order order;
+	uint8_t phase;
+	// weights of input at given phase in the current and in the next output
+	float current_weights[MAX_RATIO];
+	float next_weights[MAX_RATIO];
+	float current[N];
+	float next[N];
+
+public:
+	Decimator() {
+		this->anti_alias_enabled = false;
+		this->Configure(1, ORDER_BOXCAR);
+	}
+
+	// resets state, ratio 1 passes input unchanged
+	bool Configure(uint8_t ratio, Order order) {
+		if (ratio < 1 || ratio > MAX_RATIO || (order != ORDER_BOXCAR && order != ORDER_CIC2))
+			return false;
+
+		this->ratio = ratio;
+		this->order = order;
+
+		for (uint8_t i = 0; i < ratio; i++) {
+			if (order == ORDER_BOXCAR) {
+				this->current_weights[i] = 1.0f / ratio;
+				this->next_weights[i] = 0;
+			}
+			else {
+				this->current_weights[i] = float(ratio - i) / (ratio * ratio);
+				this->next_weights[i] = float(i) / (ratio * ratio);
+			}
+		}
+
+		this->Reset();
+
+		return true;
+	}
+
+	// cut frequency of 0 turns the filter off
+	void Set_Anti_Alias(float sample_frequency, float cut_frequency) {
+		this->anti_alias_enabled = cut_frequency > 0 && cut_frequency < sample_frequency / 2;
+
+		if (this->anti_alias_enabled)
+			this->anti_alias.Set_Coefficients(Biquad_Filter::FILTER_LOW_PASS, sample_frequency, cut_frequency);
+	}
+
+	void Reset() {
+		this->phase = 0;
+		this->anti_alias.Reset();
+
+		for (uint8_t i = 0; i < N; i++) {
+			this->current[i] = 0;
+			this->next[i] = 0;
+		}
+	}
+
+	uint8_t Get_Ratio() {
+		return this->ratio;
+	}
+
+	Order Get_Order() {
+		return this->order;
+	}
+
+	// group delay of the averaging [input samples], biquad comes on top
+	float Get_Delay() {
+		return this->order == ORDER_BOXCAR ? (this->ratio - 1) / 2.0f : this->ratio - 1;
+	}
+
+	// returns true when output is filled, input and output may be the same array
+	inline bool Push(const float input[N], float output[N]) {
+		float in[N];
+
+		if (this->anti_alias_enabled)
+			this->anti_alias.Apply_Filter(input, in);
+		else {
+			for (uint8_t i = 0; i < N; i++)
+				in[i] = input[i];
+		}
+
+		float current_weight = this->current_weights[this->phase];
+		float next_weight = this->next_weights[this->phase];
+
+		for (uint8_t i = 0; i < N; i++) {
+			this->current[i] += current_weight * in[i];
+			this->next[i] += next_weight * in[i];
+		}
+
+		if (++this->phase < this->ratio)
+			return false;
+
+		this->phase = 0;
+
+		for (uint8_t i = 0; i < N; i++) {
+			output[i] = this->current[i];
+			this->current[i] = this->next[i];
+			this->next[i] = 0;
+		}
+
+		return true;
+	}
+};
+
+} /* namespace flyhero */
+
+#endif /* DECIMATOR_H_ */
@@ -0,0 +1,78 @@
+/*
+ * Dynamic_Notch.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef DYNAMIC_NOTCH_H_
+#define DYNAMIC_NOTCH_H_
+
+#include <stdint.h>
+#include <cmath>
+#include "Biquad_Bank.h"
+
+namespace flyhero {
+
+// Tracks the strongest gyro vibration peaks with a Hann windowed FFT and keeps
+// a notch on each of them. Axes are analysed one after another, the work is
+// split into short steps (window, one FFT stage, peak search, tuning) so that
+// Step() costs about the same every call and fits a scheduler task budget.
+class Dynamic_Notch {
+public:
+	static const uint8_t AXES = 3;
+	static const uint8_t PEAKS = 2;
+	static const uint16_t FFT_SIZE = 128;
+
+private:
+	Dynamic_Notch(Dynamic_Notch const&);
+	Dynamic_Notch& operator=(Dynamic_Notch const&);
+
+	static const uint8_t FFT_STAGES = 7;
+	static const uint8_t STEP_WINDOW = 0;
+	static const uint8_t STEP_PEAKS = STEP_WINDOW + FFT_STAGES + 1;
+	static const uint8_t STEP_TUNE = STEP_PEAKS + 1;
+
+	const float PI = 3.14159265358979323846f;
+	const float MIN_FREQUENCY = 80;		// keep away from control bandwidth
+	const float MAX_FREQUENCY = 500;
+	const float NOTCH_Q = 3;
+	const float SMOOTHING = 0.3f;
+	// peak further than this from every tracked one takes a free notch
+	const uint8_t MATCH_BINS = 4;
+	// peak has to stand out of the band average power, strongest peak excluded
+	const float PEAK_RATIO = 4;
+
+	// notches in series, one bank per peak
+	Biquad_Bank<AXES> notch[PEAKS];
+	float samples[AXES][FFT_SIZE];
+	uint16_t sample_index;
+	uint16_t sample_count;
+	float window[FFT_SIZE];
+	float twiddle_re[FFT_SIZE / 2], twiddle_im[FFT_SIZE / 2];
+	float re[FFT_SIZE], im[FFT_SIZE];
+	float frequency[AXES][PEAKS];
+	float found[PEAKS];
+	uint16_t rate;
+	uint8_t axis;
+	uint8_t step;
+
+	void window_samples();
+	void fft_stage(uint8_t stage);
+	void find_peaks();
+	void tune();
+
+public:
+	Dynamic_Notch();
+
+	void Init(uint16_t rate);
+	// unfiltered gyro [deg/s], once per read
+	void Push(const float gyro[AXES]);
+	void Apply_Filter(float gyro[AXES]);
+	void Step();
+	float Get_Frequency(uint8_t axis, uint8_t peak);
+};
+
+} /* namespace flyhero */
+
+#endif /* DYNAMIC_NOTCH_H_ */
@@ -0,0 +1,44 @@
+/*
+ * EKF_Estimator.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef EKF_ESTIMATOR_H_
+#define EKF_ESTIMATOR_H_
+
+#include "Attitude_Estimator.h"
+
+namespace flyhero {
+
+// Extended Kalman filter with the quaternion as the only state. Gyro drives
+// the prediction, accel direction is the measurement of gravity. Accel is
+// trusted less the further its norm is from 1 g (thrust, vibration).
+class EKF_Estimator : public Attitude_Estimator {
+private:
+	static const uint8_t N = 4;
+
+	float P[N][N];
+	float gyro_noise;		// [rad/s]
+	float accel_noise;		// normalised accel
+	float initial_variance;
+
+protected:
+	void reset();
+	void predict(const float gyro[3], float dt);
+	void project();
+
+public:
+	EKF_Estimator();
+
+	// gyro [deg/s], accel [g], both standard deviation
+	void Set_Noise(float gyro_noise, float accel_noise);
+	void Update(const float gyro[3], const float accel[3], float dt);
+	void Predict(const float gyro[3], float dt);
+	const char* Get_Name();
+};
+
+} /* namespace flyhero */
+
+#endif /* EKF_ESTIMATOR_H_ */
@@ -0,0 +1,88 @@
+/*
+ * Gyro_Bias_Model.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef GYRO_BIAS_MODEL_H_
+#define GYRO_BIAS_MODEL_H_
+
+#include <stdint.h>
+#include <cmath>
+
+namespace flyhero {
+
+// Gyro bias as a piecewise linear function of die temperature, one node every
+// NODE_STEP from NODE_MIN. Nodes are learned from stationary periods, the ones
+// not seen yet follow their learned neighbours, constant outside of them, so
+// lookup never extrapolates a slope it has no data for.
+class Gyro_Bias_Model {
+public:
+	static const uint8_t AXES = 3;
+	static const uint8_t NODES = 9;
+
+	// stored as is, valid with any gyro full scale range
+	struct Table {
+		float bias[NODES][AXES];	// [deg/s]
+		float weight[NODES];		// stationary periods behind the node, 0 not learned
+	};
+
+private:
+	Gyro_Bias_Model(Gyro_Bias_Model const&);
+	Gyro_Bias_Model& operator=(Gyro_Bias_Model const&);
+
+	const float NODE_MIN = -10;		// [deg C]
+	const float NODE_STEP = 10;		// [deg C]
+	// older periods fade out so the model follows sensor aging
+	const float MAX_WEIGHT = 16;
+
+	Table table;
+	// table with the nodes not learned yet filled in, the only thing lookup reads
+	float lookup[NODES][AXES];
+	bool learned;
+	uint32_t updates;
+
+	inline void locate(float temperature, uint8_t& node, float& fraction);
+	void fill();
+
+public:
+	Gyro_Bias_Model();
+
+	void Reset();
+	// mean gyro [deg/s] over a stationary period at temperature [deg C]
+	void Learn(float temperature, const float bias[AXES]);
+	// [deg/s], zero until something is learned
+	inline void Get_Bias(float temperature, float bias[AXES]);
+	bool Is_Learned();
+	// counts Learn() calls, tells whether the table changed since it was stored
+	uint32_t Get_Updates();
+	void Get_Table(Table& table);
+	bool Set_Table(const Table& table);
+};
+
+void Gyro_Bias_Model::locate(float temperature, uint8_t& node, float& fraction) {
+	float position = (temperature - this->NODE_MIN) / this->NODE_STEP;
+
+	position = position < 0 ? 0 : position;
+	position = position > this->NODES - 1 ? this->NODES - 1 : position;
+
+	node = uint8_t(position);
+	node = node > this->NODES - 2 ? this->NODES - 2 : node;
+	fraction = position - node;
+}
+
+// one division and interpolation, cheap enough for every read
+void Gyro_Bias_Model::Get_Bias(float temperature, float bias[AXES]) {
+	uint8_t node;
+	float fraction;
+
+	this->locate(temperature, node, fraction);
+
+	for (uint8_t i = 0; i < this->AXES; i++)
+		bias[i] = this->lookup[node][i] + fraction * (this->lookup[node + 1][i] - this->lookup[node][i]);
+}
+
+} /* namespace flyhero */
+
+#endif /* GYRO_BIAS_MODEL_H_ */
@@ -0,0 +1,268 @@
+/*
+ * IMU.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef IMU_H_
+#define IMU_H_
+
+#include <stdio.h>
+#include <cmath>
+#include <stm32f4xx_hal.h>
+#include "Timer.h"
+#include "Biquad_Filter.h"
+#include "Biquad_Bank.h"
+#include "Sample_Ring.h"
+#include "Decimator.h"
+#include "Vibration_Monitor.h"
+#include "Dynamic_Notch.h"
+#include "Attitude_Estimator.h"
+#include "Mahony_Estimator.h"
+#include "Madgwick_Estimator.h"
+#include "EKF_Estimator.h"
+#include "Gyro_Bias_Model.h"
+
+namespace flyhero {
+
+enum IMU_Type { IMU_MPU6050, IMU_MPU6000 };
+
+// Sensor independent part of the IMU driver. Backends configure the sensor and
+// push raw samples into the ring, averaging, filtering, calibration and attitude
+// run on that stream here. All backends are InvenSense 6 axis parts, so they share
+// the sample layout and full scale range codes.
+class IMU {
+private:
+	static IMU_Type type;
+
+	IMU(IMU const&);
+	IMU& operator=(IMU const&);
+
+public:
+	struct Sensor_Data {
+		float x, y, z;
+	};
+
+	struct Raw_Data {
+		int16_t x, y, z;
+	};
+
+	typedef Attitude_Estimator::Quaternion Quaternion;
+
+	struct Sample {
+		uint32_t timestamp;		// data ready [us]
+		Raw_Data accel, gyro;
+		int16_t temp;
+	};
+
+	enum Calibration_State {
+		CALIBRATION_IDLE,
+		CALIBRATION_RUNNING,
+		CALIBRATION_DONE
+	};
+
+	// software offsets added to raw samples, valid only with the FSRs they were taken at
+	struct Calibration {
+		float accel_offsets[3];		// [LSB]
+		float gyro_offsets[3];		// [LSB]
+		uint8_t accel_fsr;
+		uint8_t gyro_fsr;
+	};
+
+	// 16 ms at 8 kHz
+	static const uint16_t SAMPLE_RING_SIZE = 128;
+	// accel, temp and gyro, same layout in FIFO as in output registers
+	static const uint8_t SAMPLE_SIZE = 14;
+	typedef Sample_Ring<Sample, SAMPLE_RING_SIZE> Ring;
+	// accel x, y, z, gyro x, y, z
+	typedef Decimator<6> Sample_Decimator;
+
+protected:
+	enum gyro_fsr {
+		GYRO_FSR_250 = 0x00,
+		GYRO_FSR_500 = 0x08,
+		GYRO_FSR_1000 = 0x10,
+		GYRO_FSR_2000 = 0x18,
+		GYRO_FSR_NOT_SET = 0xFF
+	};
+
+	enum accel_fsr {
+		ACCEL_FSR_2 = 0x00,
+		ACCEL_FSR_4 = 0x08,
+		ACCEL_FSR_8 = 0x10,
+		ACCEL_FSR_16 = 0x18,
+		ACCEL_FSR_NOT_SET = 0xFF
+	};
+
+	const uint8_t ADC_BITS = 16;
+	const float ACCEL_LPF_FREQUENCY = 10;
+	const float GYRO_LPF_FREQUENCY = 60;
+	// stationary windows needed in a row, each one is judged on its own noise
+	// and on how far its mean moved from the windows accepted before
+	const float CALIBRATION_WINDOW = 0.25f;		// [s]
+	const uint8_t CALIBRATION_WINDOWS = 4;
+	const float CALIBRATION_GYRO_NOISE = 0.5f;		// [deg/s] standard deviation
+	const float CALIBRATION_ACCEL_NOISE = 0.02f;	// [g] standard deviation
+	const float CALIBRATION_GYRO_DRIFT = 0.5f;		// [deg/s]
+	const float CALIBRATION_ACCEL_DRIFT = 0.02f;	// [g]
+	const uint16_t CALIBRATION_TIMEOUT = 10000;		// [ms] blocking Calibrate() only
+	// longer gap between attitude updates is a pause, not a sample period
+	const uint32_t ATTITUDE_MAX_DT = 20000;		// [us]
+
+	// accel x, y, z, gyro x, y, z
+	Biquad_Bank<6> sensor_filter;
+	Dynamic_Notch dynamic_notch;
+	bool dynamic_notch_enabled;
+	float gyro_lpf_frequency;
+	uint16_t read_rate;
+
+	Sensor_Data accel, gyro;
+	Mahony_Estimator mahony;
+	Madgwick_Estimator madgwick;
+	EKF_Estimator ekf;
+	Attitude_Estimator *estimator;
+	Quaternion quaternion;
+	// Euler angles are converted from quaternion only when asked for
+	bool euler_valid;
+	int16_t raw_temp;
+	Raw_Data raw_accel, raw_gyro;
+	uint32_t start_ticks;
+	float roll, pitch, yaw;
+	gyro_fsr g_fsr;
+	float g_mult;
+	float a_mult;
+	accel_fsr a_fsr;
+	int16_t sample_rate;
+	// set by the backend for its sensor
+	float temp_scale;		// [deg C / LSB]
+	float temp_offset;		// [deg C]
+	// ring holds decimated samples, so do all readers
+	Sample_Decimator decimator;
+	// rounding error carried to the next decimated sample, keeps sub LSB resolution of the mean
+	float decimation_error[6];
+	// raw samples ahead of decimation, rails are only seen there
+	Vibration_Monitor vibration;
+	Ring samples;
+	Ring::Reader control_reader;
+	float accel_offsets[3];
+	float gyro_offsets[3];
+	Calibration_State calibration_state;
+	Ring::Reader calibration_reader;
+	uint16_t calibration_window_size;
+	// running mean and variance of the current window, accel x, y, z, gyro x, y, z
+	uint16_t calibration_count;
+	float calibration_mean[6];
+	float calibration_m2[6];
+	// sum of means of accepted windows
+	float calibration_sum[6];
+	uint8_t calibration_windows;
+	// raw temperature sum of the current window, sum of means of accepted ones
+	int32_t calibration_temp;
+	float calibration_temp_sum;
+	// stationary periods keep teaching the bias model after calibration is done
+	bool bias_learning;
+	Gyro_Bias_Model gyro_bias;
+	volatile uint32_t data_ready_ticks;
+	// taken in EXTI, backends may start reading much later
+	volatile uint32_t interrupt_ticks;
+	volatile bool interrupt_pending;
+	// group delay of decimation, decimated samples are stamped that much earlier [us]
+	uint32_t decimation_delay;
+	// capture time of the newest sample behind accel and gyro, newest one the attitude covers [us]
+	uint32_t sample_timestamp;
+	uint32_t attitude_timestamp;
+	// attitude is rotated ahead by gyro to the time motor outputs take effect
+	bool latency_compensation;
+	uint32_t output_delay;		// [us]
+
+	IMU();
+
+	static void gpio_clock_enable(GPIO_TypeDef *base);
+	void int_init();
+	void set_gyro_range(gyro_fsr fsr);
+	void set_accel_range(accel_fsr fsr);
+	void parse_sample(const uint8_t *data, Sample& sample);
+	// called by backends for every sample read, returns true when one got into the ring
+	bool push_sample(const Sample& sample);
+	void calibration_add(const Sample& sample);
+	void calibration_window();
+	float attitude_dt();
+	void publish_attitude();
+	// data ready interrupt time of the sample read now, current time when there was none
+	uint32_t capture_ticks();
+	HAL_StatusTypeDef read_sample(Ring::Reader& reader, Sample& sample);
+	// blocking read of accel, temp and gyro output registers, SAMPLE_SIZE bytes
+	virtual HAL_StatusTypeDef read_output(uint8_t *data) = 0;
+
+public:
+	static IMU& Create_Instance(IMU_Type type);
+	static IMU& Instance();
+
+	void (*Data_Ready_Callback)();
+	void (*Data_Read_Callback)();
+
+	// from EXTI of the data ready pin
+	void Data_Ready_Handler();
+
+	virtual HAL_StatusTypeDef Init() = 0;
+	// accel is sampled at 1 kHz at most, above that only gyro data are new
+	virtual HAL_StatusTypeDef Set_Sample_Rate(uint16_t rate) = 0;
+	// sensors without FIFO in use read every sample on data ready
+	virtual HAL_StatusTypeDef Set_FIFO_Mode(bool enable);
+	virtual bool Get_FIFO_Mode();
+	virtual uint32_t Get_FIFO_Overflows();
+	// called on data ready, or periodically in FIFO mode
+	virtual HAL_StatusTypeDef Start_Read() = 0;
+	// called from DMA complete interrupt, returns true when new samples are in the ring
+	virtual bool Store_Sample() = 0;
+
+	void Reset_Integrators();
+	HAL_StatusTypeDef Calibrate();
+	void Start_Calibration();
+	Calibration_State Update_Calibration();
+	Calibration_State Get_Calibration_State();
+	bool Get_Calibration(Calibration& calibration);
+	HAL_StatusTypeDef Set_Calibration(const Calibration& calibration);
+	void Set_Bias_Learning(bool enable);
+	Gyro_Bias_Model& Get_Gyro_Bias_Model();
+	void Set_Estimator(Estimator_Type type);
+	Attitude_Estimator& Get_Estimator();
+	void Compute_Attitude();
+	void Predict_Attitude();
+	// output delay is what passes between PWM write and the new pulse [us]
+	void Set_Latency_Compensation(bool enable, uint32_t output_delay_us = 0);
+	bool Get_Latency_Compensation();
+	// capture time of the newest data behind gyro and attitude [us], Timer ticks
+	uint32_t Get_Sample_Timestamp();
+	uint32_t Get_Sample_Age();
+	void Get_Euler(float& roll, float& pitch, float& yaw);
+	void Get_Quaternion(Quaternion& quaternion);
+	void Get_Rotation_Matrix(float matrix[3][3]);
+	void Get_Raw_Accel(Raw_Data& raw_accel);
+	void Get_Raw_Gyro(Raw_Data& raw_gyro);
+	void Get_Raw_Temp(int16_t& raw_temp);
+	float Get_Temperature();
+	void Get_Accel(Sensor_Data& accel);
+	void Get_Gyro(Sensor_Data& gyro);
+	HAL_StatusTypeDef Read_Raw(Raw_Data& accel, Raw_Data& gyro);
+	uint16_t Get_Sample_Rate();
+	// rate of samples in the ring
+	uint16_t Get_Output_Rate();
+	HAL_StatusTypeDef Set_Decimation(uint8_t ratio, Sample_Decimator::Order order = Sample_Decimator::ORDER_BOXCAR,
+			float anti_alias_frequency = 0);
+	Sample_Decimator& Get_Decimator();
+	// vibration and clipping of raw samples at sample rate [LSB]
+	Vibration_Monitor& Get_Vibration_Monitor();
+	void Set_Read_Rate(uint16_t rate);
+	void Set_Gyro_LPF(float cut_frequency);
+	void Set_Dynamic_Notch(bool enable);
+	Dynamic_Notch& Get_Dynamic_Notch();
+	uint8_t Complete_Read();
+	Ring& Get_Sample_Ring();
+	bool Get_Last_Sample(Sample& sample);
+};
+
+} /* namespace flyhero */
+
+#endif /* IMU_H_ */
@@ -0,0 +1,114 @@
+/*
+ * MPU6000.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef MPU6000_H_
+#define MPU6000_H_
+
+#include "IMU.h"
+
+namespace flyhero {
+
+// SPI backend for MPU6000 and ICM-20602, told apart by WHO_AM_I. Registers are
+// written at 1 MHz at most, samples are read by DMA at 11 MHz, which leaves
+// enough time for a read on every data ready even at 8 kHz, so FIFO is not used.
+class MPU6000 : public IMU {
+public:
+	enum Device {
+		DEVICE_MPU6000,
+		DEVICE_ICM20602,
+		DEVICE_UNKNOWN
+	};
+
+private:
+	MPU6000();
+	MPU6000(MPU6000 const&);
+	MPU6000& operator=(MPU6000 const&);
+
+enum read_state {
+	READ_IDLE,
+	READ_SAMPLE
+};
+
+// the same codes on both sensors, bandwidth differs slightly on ICM-20602
+enum lpf_bandwidth {
+	LPF_256HZ = 0x00,
+	LPF_188HZ = 0x01,
+	LPF_98HZ = 0x02,
+	LPF_42HZ = 0x03,
+	LPF_20HZ = 0x04,
+	LPF_10HZ = 0x05,
+	LPF_5HZ = 0x06,
+	LPF_NOT_SET = 0xFF
+};
+
+const uint8_t WHO_AM_I_MPU6000 = 0x68;
+const uint8_t WHO_AM_I_ICM20602 = 0x12;
+// APB2 runs at 90 MHz
+const uint32_t SPI_SLOW_PRESCALER = SPI_BAUDRATEPRESCALER_128;		// 703 kHz, any register
+const uint32_t SPI_FAST_PRESCALER = SPI_BAUDRATEPRESCALER_8;		// 11.25 MHz, output registers only
+const uint16_t SPI_TIMEOUT = 10;
+const uint8_t SPI_READ = 0x80;
+const float MPU6000_TEMP_SCALE = 1 / 340.0f;		// [deg C / LSB]
+const float MPU6000_TEMP_OFFSET = 36.53f;			// [deg C]
+const float ICM20602_TEMP_SCALE = 1 / 326.8f;		// [deg C / LSB]
+const float ICM20602_TEMP_OFFSET = 25;				// [deg C]
+
+const struct {
+	uint8_t SMPRT_DIV = 0x19;
+	uint8_t CONFIG = 0x1A;
+	uint8_t GYRO_CONFIG = 0x1B;
+	uint8_t ACCEL_CONFIG = 0x1C;
+	uint8_t INT_PIN_CFG = 0x37;
+	uint8_t INT_ENABLE = 0x38;
+	uint8_t ACCEL_XOUT_H = 0x3B;
+	uint8_t SIGNAL_PATH_RESET = 0x68;
+	uint8_t USER_CTRL = 0x6A;
+	uint8_t PWR_MGMT_1 = 0x6B;
+	uint8_t PWR_MGMT_2 = 0x6C;
+	uint8_t I2C_IF = 0x70;			// ICM-20602 only
+	uint8_t WHO_AM_I = 0x75;
+} REGISTERS;
+
+SPI_HandleTypeDef hspi;
+DMA_HandleTypeDef hdma_spi_rx;
+DMA_HandleTypeDef hdma_spi_tx;
+Device device;
+lpf_bandwidth lpf;
+volatile read_state state;
+// register address goes out first, so data come one byte later
+uint8_t tx_buffer[SAMPLE_SIZE + 1];
+uint8_t rx_buffer[SAMPLE_SIZE + 1];
+
+HAL_StatusTypeDef spi_init();
+void spi_set_speed(uint32_t prescaler);
+void spi_select(bool select);
+HAL_StatusTypeDef spi_write(uint8_t reg, uint8_t data);
+HAL_StatusTypeDef spi_read(uint8_t reg, uint8_t *data, uint8_t data_size);
+HAL_StatusTypeDef set_gyro_fsr(gyro_fsr fsr);
+HAL_StatusTypeDef set_accel_fsr(accel_fsr fsr);
+HAL_StatusTypeDef set_lpf(lpf_bandwidth lpf);
+HAL_StatusTypeDef set_sample_rate(uint16_t rate);
+HAL_StatusTypeDef set_interrupt(bool enable);
+HAL_StatusTypeDef read_output(uint8_t *data);
+
+public:
+	static MPU6000& Instance();
+
+	DMA_HandleTypeDef* Get_DMA_Rx_Handle();
+	DMA_HandleTypeDef* Get_DMA_Tx_Handle();
+	SPI_HandleTypeDef* Get_SPI_Handle();
+	Device Get_Device();
+
+	HAL_StatusTypeDef Init();
+	HAL_StatusTypeDef Set_Sample_Rate(uint16_t rate);
+	HAL_StatusTypeDef Start_Read();
+	bool Store_Sample();
+};
+
+} /* namespace flyhero */
+
+#endif /* MPU6000_H_ */
@@ -8,48 +8,52 @@
 #ifndef MPU6050_H_
 #define MPU6050_H_
 
-#include <stdio.h>
-#include <cmath>
-#include <stm32f4xx_hal.h>
-#include "Timer.h"
-#include "Biquad_Filter.h"
+#include "IMU.h"
 #include "LEDs.h"
 
 namespace flyhero {
 
-class MPU6050 {
+// I2C backend, 400 kHz bus limits it to 2 kHz in FIFO bursts
+class MPU6050 : public IMU {
 public:
-	struct Sensor_Data {
-		float x, y, z;
+	// vendor specific DMP setup, written to DMP memory after the image
+	struct DMP_Patch {
+		uint16_t address;
+		const uint8_t *data;
+		uint8_t size;
 	};
 
-	struct Raw_Data {
-		int16_t x, y, z;
+	// DMP image with the setup making it push one quaternion packet per
+	// period into FIFO. Images come from the vendor, they are not part of the driver.
+	struct DMP_Firmware {
+		const uint8_t *image;
+		uint16_t size;
+		uint16_t start_address;
+		const DMP_Patch *patches;
+		uint8_t patch_count;
+		uint16_t rate;		// quaternion packets per second
 	};
 
-	struct Quaternion {
-		float q0, q1, q2, q3;
-	};
+	// samples taken from FIFO by one DMA transfer at most
+	static const uint8_t FIFO_BURST_SAMPLES = 8;
+	// quaternion w, x, y, z in q30
+	static const uint8_t DMP_PACKET_SIZE = 16;
 
 private:
+	struct DMP_Sample {
+		uint32_t timestamp;		// count read [us]
+		Quaternion quaternion;
+	};
+
 	MPU6050();
 	MPU6050(MPU6050 const&);
 	MPU6050& operator=(MPU6050 const&);
 
-enum gyro_fsr {
-	GYRO_FSR_250 = 0x00,
-	GYRO_FSR_500 = 0x08,
-	GYRO_FSR_1000 = 0x10,
-	GYRO_FSR_2000 = 0x18,
-	GYRO_FSR_NOT_SET = 0xFF
-};
-
-enum accel_fsr {
-	ACCEL_FSR_2 = 0x00,
-	ACCEL_FSR_4 = 0x08,
-	ACCEL_FSR_8 = 0x10,
-	ACCEL_FSR_16 = 0x18,
-	ACCEL_FSR_NOT_SET = 0xFF
+enum read_state {
+	READ_IDLE,
+	READ_SAMPLE,
+	READ_FIFO_COUNT,
+	READ_FIFO_DATA
 };
 
 enum lpf_bandwidth {
@@ -63,13 +67,13 @@ enum lpf_bandwidth {
 	LPF_NOT_SET = 0xFF
 };
 
-const float COMPLEMENTARY_COEFFICIENT = 0.995f;
-const double PI = 3.14159265358979323846;
-const float RAD_TO_DEG = 180 / this->PI;
-const float DEG_TO_RAD = this->PI / 180;
-const uint8_t ADC_BITS = 16;
 const uint8_t I2C_ADDRESS = 0xD0;
 const uint16_t I2C_TIMEOUT = 500;
+const uint16_t FIFO_SIZE = 1024;
+const uint16_t DMP_BANK_SIZE = 256;
+const uint8_t DMP_CHUNK_SIZE = 16;
+const float TEMP_SCALE = 1 / 340.0f;		// [deg C / LSB]
+const float TEMP_OFFSET = 36.53f;			// [deg C]
 
 const struct {
 	uint8_t ACCEL_X_OFFSET = 0x06;
@@ -87,44 +91,36 @@ const struct {
 	uint8_t USER_CTRL = 0x6A;
 	uint8_t PWR_MGMT_1 = 0x6B;
 	uint8_t PWR_MGMT_2 = 0x6C;
+	uint8_t BANK_SEL = 0x6D;
+	uint8_t MEM_START_ADDR = 0x6E;
+	uint8_t MEM_R_W = 0x6F;
+	uint8_t PRGM_START_H = 0x70;
 	uint8_t FIFO_COUNT_H = 0x72;
 	uint8_t FIFO_COUNT_L = 0x73;
 	uint8_t FIFO_R_W = 0x74;
 	uint8_t WHO_AM_I = 0x75;
 } REGISTERS;
 
-Biquad_Filter accel_x_filter, accel_y_filter, accel_z_filter;
-Biquad_Filter gyro_x_filter, gyro_y_filter, gyro_z_filter;
-
-Sensor_Data accel, gyro;
-Sensor_Data mahony_integral;
-Quaternion quaternion;
-float mahony_Kp, mahony_Ki;
-int16_t raw_temp;
-Raw_Data raw_accel, raw_gyro;
-uint32_t start_ticks;
-float roll, pitch, yaw;
 I2C_HandleTypeDef hi2c;
 DMA_HandleTypeDef hdma_i2c_rx;
-gyro_fsr g_fsr; // TODO better variable/enum name
-float g_mult;
-float a_mult;
-accel_fsr a_fsr;
 lpf_bandwidth lpf;
-int16_t sample_rate;
-uint8_t data_buffer[14];
-float accel_offsets[3];
-float gyro_offsets[3];
-volatile uint32_t data_ready_ticks;
-volatile float delta_t;
-
-float atan2(float y, float x);
-inline float inv_sqrt(float x);
-inline double atan(double z);
+uint8_t data_buffer[FIFO_BURST_SAMPLES * SAMPLE_SIZE];
+bool fifo_mode;
+volatile bool fifo_reset_pending;
+volatile read_state state;
+uint16_t fifo_samples;
+uint8_t fifo_burst;
+uint32_t fifo_read_ticks;
+uint32_t fifo_timestamp;
+bool fifo_synced;
+volatile uint32_t fifo_overflows;
+const DMP_Firmware *dmp_firmware;
+bool dmp_mode;
+uint8_t dmp_reads;
+Sample_Ring<DMP_Sample, 4> dmp_samples;
 
 void i2c_reset_bus();
 HAL_StatusTypeDef i2c_init();
-void int_init();
 HAL_StatusTypeDef i2c_write(uint8_t reg, uint8_t data);
 HAL_StatusTypeDef i2c_write(uint8_t reg, uint8_t *data, uint8_t data_size);
 HAL_StatusTypeDef i2c_read(uint8_t reg, uint8_t *data);
@@ -134,30 +130,33 @@ HAL_StatusTypeDef set_accel_fsr(accel_fsr fsr);
 HAL_StatusTypeDef set_lpf(lpf_bandwidth lpf);
 HAL_StatusTypeDef set_sample_rate(uint16_t rate);
 HAL_StatusTypeDef set_interrupt(bool enable);
+HAL_StatusTypeDef fifo_reset();
+uint8_t fifo_packet_size();
+HAL_StatusTypeDef fifo_start_count_read();
+bool fifo_count_read();
+bool fifo_data_read();
+void dmp_data_read();
+HAL_StatusTypeDef dmp_memory(uint16_t address, const uint8_t *data, uint16_t size);
+HAL_StatusTypeDef dmp_load(const DMP_Firmware *firmware);
+HAL_StatusTypeDef read_output(uint8_t *data);
 
 public:
 	static MPU6050& Instance();
 
-	void (*Data_Ready_Callback)();
-	void (*Data_Read_Callback)();
-
 	DMA_HandleTypeDef* Get_DMA_Rx_Handle();
 	I2C_HandleTypeDef* Get_I2C_Handle();
 
-	void Reset_Integrators();
 	HAL_StatusTypeDef Init();
-	HAL_StatusTypeDef Calibrate();
-	void Compute_Euler();
-	void Compute_Mahony();
-	void Get_Euler(float& roll, float& pitch, float& yaw);
-	void Get_Raw_Accel(Raw_Data& raw_accel);
-	void Get_Raw_Gyro(Raw_Data& raw_gyro);
-	void Get_Raw_Temp(int16_t& raw_temp);
-	void Get_Accel(Sensor_Data& accel);
-	void Get_Gyro(Sensor_Data& gyro);
-	HAL_StatusTypeDef Read_Raw(Raw_Data& accel, Raw_Data& gyro);
+	HAL_StatusTypeDef Init(const DMP_Firmware *dmp_firmware);
+	void Compute_DMP();
+	HAL_StatusTypeDef Set_Sample_Rate(uint16_t rate);
+	HAL_StatusTypeDef Set_FIFO_Mode(bool enable);
+	bool Get_FIFO_Mode();
+	uint32_t Get_FIFO_Overflows();
+	HAL_StatusTypeDef Set_DMP_Mode(bool enable);
+	bool Get_DMP_Mode();
 	HAL_StatusTypeDef Start_Read();
-	void Complete_Read();
+	bool Store_Sample();
 };
 
 } /* namespace The_Eye */
@@ -0,0 +1,35 @@
+/*
+ * Madgwick_Estimator.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef MADGWICK_ESTIMATOR_H_
+#define MADGWICK_ESTIMATOR_H_
+
+#include "Attitude_Estimator.h"
+
+namespace flyhero {
+
+// Gradient descent step towards the attitude where gravity matches accel,
+// beta [rad/s] limits how fast accel may pull the gyro integration.
+// http://x-io.co.uk/open-source-imu-and-ahrs-algorithms/
+class Madgwick_Estimator : public Attitude_Estimator {
+private:
+	float beta;
+
+protected:
+	void reset();
+
+public:
+	Madgwick_Estimator();
+
+	void Set_Beta(float beta);
+	void Update(const float gyro[3], const float accel[3], float dt);
+	const char* Get_Name();
+};
+
+} /* namespace flyhero */
+
+#endif /* MADGWICK_ESTIMATOR_H_ */
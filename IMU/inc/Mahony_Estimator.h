@@ -0,0 +1,38 @@
+/*
+ * Mahony_Estimator.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef MAHONY_ESTIMATOR_H_
+#define MAHONY_ESTIMATOR_H_
+
+#include "Attitude_Estimator.h"
+
+namespace flyhero {
+
+// Complementary filter on SO(3), accel error drives a PI correction of gyro.
+// http://x-io.co.uk/open-source-imu-and-ahrs-algorithms/
+class Mahony_Estimator : public Attitude_Estimator {
+private:
+	float Kp, Ki;
+	float integral[3];
+
+protected:
+	void reset();
+
+public:
+	Mahony_Estimator();
+
+	// Kp [rad/s] is the inverse of the time constant accel pulls attitude with,
+	// Ki [rad/s^2] how fast gyro bias is learned, both do not depend on sample rate
+	void Set_Gains(float Kp, float Ki);
+	void Update(const float gyro[3], const float accel[3], float dt);
+	void Predict(const float gyro[3], float dt);
+	const char* Get_Name();
+};
+
+} /* namespace flyhero */
+
+#endif /* MAHONY_ESTIMATOR_H_ */
@@ -0,0 +1,121 @@
+/*
+ * Sample_Ring.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef SAMPLE_RING_H_
+#define SAMPLE_RING_H_
+
+#include <stdint.h>
+#include <atomic>
+
+namespace flyhero {
+
+// Lock-free ring with one producer (usually an ISR) and any number of
+// readers, each keeping its own position. Producer never waits, a reader
+// that falls behind loses the oldest items and gets them counted.
+template <typename T, uint16_t SIZE>
+class Sample_Ring {
+	static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "SIZE must be power of 2");
+
+public:
+	struct Reader {
+		uint32_t position;
+		uint32_t lost;
+	};
+
+private:
+	Sample_Ring(Sample_Ring const&);
+	Sample_Ring& operator=(Sample_Ring const&);
+
+	T items[SIZE];
+	// number of pushed items, wraps around
+	volatile uint32_t head;
+
+public:
+	Sample_Ring() {
+		this->head = 0;
+	}
+
+	// producer only, the slot no reader looks at, Commit() publishes it
+	T& Next() {
+		return this->items[this->head & (SIZE - 1)];
+	}
+
+	// producer only
+	void Commit() {
+		// item has to be complete before readers can see it
+		std::atomic_thread_fence(std::memory_order_release);
+		this->head = this->head + 1;
+	}
+
+	// producer only
+	void Push(const T& item) {
+		this->Next() = item;
+		this->Commit();
+	}
+
+	// reader starts with the next pushed item
+	void Attach(Reader& reader) {
+		reader.position = this->head;
+		reader.lost = 0;
+	}
+
+	uint32_t Available(const Reader& reader) {
+		uint32_t available = this->head - reader.position;
+
+		return available < SIZE ? available : SIZE - 1;
+	}
+
+	bool Read(Reader& reader, T& item) {
+		while (true) {
+			uint32_t head = this->head;
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (head == reader.position)
+				return false;
+
+			// slot being written is head & (SIZE - 1), skip what is lost
+			if (head - reader.position > SIZE - 1) {
+				reader.lost += head - reader.position - (SIZE - 1);
+				reader.position = head - (SIZE - 1);
+			}
+
+			item = this->items[reader.position & (SIZE - 1)];
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			// producer did not get to our slot while copying
+			if (this->head - reader.position <= SIZE - 1) {
+				reader.position++;
+				return true;
+			}
+		}
+	}
+
+	// newest item without consuming anything
+	bool Read_Latest(T& item) {
+		while (true) {
+			uint32_t head = this->head;
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (head == 0)
+				return false;
+
+			item = this->items[(head - 1) & (SIZE - 1)];
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (this->head - (head - 1) <= SIZE - 1)
+				return true;
+		}
+	}
+
+	uint32_t Get_Count() {
+		return this->head;
+	}
+};
+
+} /* namespace flyhero */
+
+#endif /* SAMPLE_RING_H_ */
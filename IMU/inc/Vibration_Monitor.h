@@ -0,0 +1,100 @@
+/*
+ * Vibration_Monitor.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef VIBRATION_MONITOR_H_
+#define VIBRATION_MONITOR_H_
+
+#include <stdint.h>
+#include <cmath>
+#include "Sample_Ring.h"
+
+namespace flyhero {
+
+// Health statistics of raw samples at full sample rate, accel x, y, z and
+// gyro x, y, z. Samples are summed over windows of fixed duration, a finished
+// window is published through a ring so that readers never see a torn one.
+// RMS and peak are taken around the window mean, so gravity, bias and slow
+// motion do not count as vibration. Samples at the ADC rails are counted as clipped.
+class Vibration_Monitor {
+public:
+	static const uint8_t AXES = 6;
+	static const uint32_t DEFAULT_WINDOW = 100000;		// [us]
+
+	// all values in LSB of the full scale range the samples were taken at
+	struct Window {
+		uint32_t timestamp;		// newest sample in the window [us]
+		uint16_t samples;
+		float rms[AXES];
+		uint16_t peak[AXES];		// max deviation from the mean
+		uint16_t clips[AXES];
+	};
+
+private:
+	Vibration_Monitor(Vibration_Monitor const&);
+	Vibration_Monitor& operator=(Vibration_Monitor const&);
+
+	static const int16_t CLIP_LEVEL = 32767;
+
+	Sample_Ring<Window, 4> windows;
+	uint32_t window_length;
+	uint32_t window_start;
+	uint16_t count;
+	int32_t sum[AXES];
+	int64_t sum_squares[AXES];
+	int16_t min[AXES], max[AXES];
+	uint16_t clips[AXES];
+	uint32_t total_clips[AXES];
+
+	void publish(uint32_t timestamp);
+
+public:
+	Vibration_Monitor();
+
+	void Set_Window(uint32_t length_us);
+	void Reset();
+
+	// sample ISR, a few operations per axis and a window close every window length
+	inline void Add(const int16_t data[AXES], uint32_t timestamp);
+
+	// newest finished window
+	bool Get_Window(Window& window);
+	// clipped samples since Reset(), read from another context may lag by a sample
+	uint32_t Get_Total_Clips(uint8_t axis);
+};
+
+void Vibration_Monitor::Add(const int16_t data[AXES], uint32_t timestamp) {
+	if (this->count == 0)
+		this->window_start = timestamp;
+
+	for (uint8_t i = 0; i < AXES; i++) {
+		int32_t value = data[i];
+		uint16_t magnitude = uint16_t(value < 0 ? -value : value);
+
+		this->sum[i] += value;
+		this->sum_squares[i] += value * value;
+
+		if (value < this->min[i])
+			this->min[i] = value;
+		if (value > this->max[i])
+			this->max[i] = value;
+
+		// -32768 is at the rail as well
+		if (magnitude >= CLIP_LEVEL) {
+			this->clips[i]++;
+			this->total_clips[i]++;
+		}
+	}
+
+	this->count++;
+
+	if (timestamp - this->window_start >= this->window_length || this->count == 0xFFFF)
+		this->publish(timestamp);
+}
+
+} /* namespace flyhero */
+
+#endif /* VIBRATION_MONITOR_H_ */
@@ -0,0 +1,126 @@
+/*
+ * Attitude_Estimator.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Attitude_Estimator.h"
+#include "Fast_Math.h"
+
+namespace flyhero {
+
+constexpr float Attitude_Estimator::PI;
+constexpr float Attitude_Estimator::DEG_TO_RAD;
+constexpr float Attitude_Estimator::RAD_TO_DEG;
+
+Attitude_Estimator::Attitude_Estimator() {
+	this->quaternion.q0 = 1;
+	this->quaternion.q1 = 0;
+	this->quaternion.q2 = 0;
+	this->quaternion.q3 = 0;
+	this->predicted_time = 0;
+}
+
+// level, integrators cleared
+void Attitude_Estimator::Reset() {
+	this->quaternion.q0 = 1;
+	this->quaternion.q1 = 0;
+	this->quaternion.q2 = 0;
+	this->quaternion.q3 = 0;
+	this->predicted_time = 0;
+
+	this->reset();
+}
+
+const Attitude_Estimator::Quaternion& Attitude_Estimator::Get_Quaternion() {
+	return this->quaternion;
+}
+
+void Attitude_Estimator::Get_Rotation_Matrix(const Quaternion& q, float matrix[3][3]) {
+	matrix[0][0] = 1 - 2 * (q.q2 * q.q2 + q.q3 * q.q3);
+	matrix[0][1] = 2 * (q.q1 * q.q2 - q.q0 * q.q3);
+	matrix[0][2] = 2 * (q.q1 * q.q3 + q.q0 * q.q2);
+	matrix[1][0] = 2 * (q.q1 * q.q2 + q.q0 * q.q3);
+	matrix[1][1] = 1 - 2 * (q.q1 * q.q1 + q.q3 * q.q3);
+	matrix[1][2] = 2 * (q.q2 * q.q3 - q.q0 * q.q1);
+	matrix[2][0] = 2 * (q.q1 * q.q3 - q.q0 * q.q2);
+	matrix[2][1] = 2 * (q.q0 * q.q1 + q.q2 * q.q3);
+	matrix[2][2] = 1 - 2 * (q.q1 * q.q1 + q.q2 * q.q2);
+}
+
+void Attitude_Estimator::Predict(const float gyro[3], float dt) {
+	this->integrate(gyro[0] * DEG_TO_RAD, gyro[1] * DEG_TO_RAD, gyro[2] * DEG_TO_RAD, dt);
+	this->normalise();
+
+	this->predicted_time += dt;
+}
+
+void Attitude_Estimator::Extrapolate(const Quaternion& quaternion, const float gyro[3], float dt, Quaternion& extrapolated) {
+	extrapolated = quaternion;
+
+	Attitude_Estimator::integrate(extrapolated, gyro[0] * DEG_TO_RAD, gyro[1] * DEG_TO_RAD, gyro[2] * DEG_TO_RAD, dt);
+	Attitude_Estimator::normalise(extrapolated);
+}
+
+// https://en.wikipedia.org/wiki/Conversion_between_quaternions_and_Euler_angles#Quaternion_to_Euler_Angles_Conversion
+void Attitude_Estimator::Get_Euler(const Quaternion& q, float& roll, float& pitch, float& yaw) {
+	float q2_sqr = q.q2 * q.q2;
+
+	float t0 = 2 * (q.q0 * q.q1 + q.q2 * q.q3);
+	float t1 = 1 - 2 * (q.q1 * q.q1 + q2_sqr);
+	roll = Fast_Math::Atan2(t0, t1) * RAD_TO_DEG;
+
+	float t2 = 2 * (q.q0 * q.q2 - q.q3 * q.q1);
+	pitch = Fast_Math::Asin(t2) * RAD_TO_DEG;
+
+	float t3 = 2 * (q.q0 * q.q3 + q.q1 * q.q2);
+	float t4 = 1 - 2 * (q2_sqr + q.q3 * q.q3);
+	yaw = Fast_Math::Atan2(t3, t4) * RAD_TO_DEG;
+}
+
+// not the bit trick inverse square root, it leaves norm off by up to 0.2 % which
+// shows in rotation matrix, square root is a single FPU instruction on target
+void Attitude_Estimator::normalise() {
+	Attitude_Estimator::normalise(this->quaternion);
+}
+
+void Attitude_Estimator::normalise(Quaternion& q) {
+	float recip_norm = Fast_Math::Inv_Sqrt(q.q0 * q.q0 + q.q1 * q.q1 + q.q2 * q.q2 + q.q3 * q.q3);
+
+	q.q0 *= recip_norm;
+	q.q1 *= recip_norm;
+	q.q2 *= recip_norm;
+	q.q3 *= recip_norm;
+}
+
+// accel error is applied once per update, over the whole time since the previous
+// one, so gains keep their meaning with any number of predictions between
+float Attitude_Estimator::correction_dt(float dt) {
+	dt += this->predicted_time;
+	this->predicted_time = 0;
+
+	return dt;
+}
+
+// first order, q += q * (0, w) / 2 * dt, has to be normalised after
+void Attitude_Estimator::integrate(float x, float y, float z, float dt) {
+	Attitude_Estimator::integrate(this->quaternion, x, y, z, dt);
+}
+
+void Attitude_Estimator::integrate(Quaternion& q, float x, float y, float z, float dt) {
+	float qa = q.q0;
+	float qb = q.q1;
+	float qc = q.q2;
+
+	x *= 0.5f * dt;
+	y *= 0.5f * dt;
+	z *= 0.5f * dt;
+
+	q.q0 += -qb * x - qc * y - q.q3 * z;
+	q.q1 += qa * x + qc * z - q.q3 * y;
+	q.q2 += qa * y - qb * z + q.q3 * x;
+	q.q3 += qa * z + qb * y - qc * x;
+}
+
+} /* namespace flyhero */
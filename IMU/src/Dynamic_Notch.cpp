@@ -0,0 +1,251 @@
+/*
+ * Dynamic_Notch.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Dynamic_Notch.h"
+#include "Fast_Math.h"
+
+namespace flyhero {
+
+Dynamic_Notch::Dynamic_Notch() {
+	for (uint16_t i = 0; i < this->FFT_SIZE; i++) {
+		this->window[i] = 0.5f - 0.5f * std::cos(2 * this->PI * i / (this->FFT_SIZE - 1));
+		this->re[i] = 0;
+		this->im[i] = 0;
+	}
+
+	for (uint16_t i = 0; i < this->FFT_SIZE / 2; i++) {
+		this->twiddle_re[i] = std::cos(2 * this->PI * i / this->FFT_SIZE);
+		this->twiddle_im[i] = -std::sin(2 * this->PI * i / this->FFT_SIZE);
+	}
+
+	this->rate = 1000;
+	this->Init(1000);
+}
+
+// drops collected data and all notches
+void Dynamic_Notch::Init(uint16_t rate) {
+	this->rate = rate;
+	this->sample_index = 0;
+	this->sample_count = 0;
+	this->axis = 0;
+	this->step = this->STEP_WINDOW;
+
+	for (uint8_t i = 0; i < this->AXES; i++) {
+		for (uint16_t j = 0; j < this->FFT_SIZE; j++)
+			this->samples[i][j] = 0;
+
+		for (uint8_t j = 0; j < this->PEAKS; j++) {
+			this->frequency[i][j] = 0;
+			this->notch[j].Bypass(i);
+		}
+	}
+}
+
+void Dynamic_Notch::Push(const float gyro[AXES]) {
+	for (uint8_t i = 0; i < this->AXES; i++)
+		this->samples[i][this->sample_index] = gyro[i];
+
+	this->sample_index = (this->sample_index + 1) & (this->FFT_SIZE - 1);
+
+	if (this->sample_count < this->FFT_SIZE)
+		this->sample_count++;
+}
+
+void Dynamic_Notch::Apply_Filter(float gyro[AXES]) {
+	for (uint8_t i = 0; i < this->PEAKS; i++)
+		this->notch[i].Apply_Filter(gyro, gyro);
+}
+
+void Dynamic_Notch::Step() {
+	if (this->sample_count < this->FFT_SIZE)
+		return;
+
+	if (this->step == this->STEP_WINDOW)
+		this->window_samples();
+	else if (this->step < this->STEP_PEAKS)
+		this->fft_stage(this->step - 1);
+	else if (this->step == this->STEP_PEAKS)
+		this->find_peaks();
+	else {
+		this->tune();
+
+		this->axis = (this->axis + 1) % this->AXES;
+		this->step = this->STEP_WINDOW;
+
+		return;
+	}
+
+	this->step++;
+}
+
+float Dynamic_Notch::Get_Frequency(uint8_t axis, uint8_t peak) {
+	if (axis >= this->AXES || peak >= this->PEAKS)
+		return 0;
+
+	return this->frequency[axis][peak];
+}
+
+// oldest sample first, without mean, stored in bit reversed order
+void Dynamic_Notch::window_samples() {
+	const float *samples = this->samples[this->axis];
+	float mean = 0;
+
+	for (uint16_t i = 0; i < this->FFT_SIZE; i++)
+		mean += samples[i];
+
+	mean /= this->FFT_SIZE;
+
+	for (uint16_t i = 0; i < this->FFT_SIZE; i++) {
+		uint16_t reversed = 0;
+
+		for (uint8_t bit = 0; bit < this->FFT_STAGES; bit++)
+			reversed |= ((i >> bit) & 0x01) << (this->FFT_STAGES - 1 - bit);
+
+		uint16_t index = (this->sample_index + i) & (this->FFT_SIZE - 1);
+
+		this->re[reversed] = (samples[index] - mean) * this->window[i];
+		this->im[reversed] = 0;
+	}
+}
+
+// radix 2 decimation in time
+void Dynamic_Notch::fft_stage(uint8_t stage) {
+	uint16_t half = 1 << stage;
+	uint16_t twiddle_step = this->FFT_SIZE / (2 * half);
+
+	for (uint16_t start = 0; start < this->FFT_SIZE; start += 2 * half) {
+		for (uint16_t k = 0; k < half; k++) {
+			uint16_t top = start + k;
+			uint16_t bottom = top + half;
+
+			float w_re = this->twiddle_re[k * twiddle_step];
+			float w_im = this->twiddle_im[k * twiddle_step];
+
+			float t_re = this->re[bottom] * w_re - this->im[bottom] * w_im;
+			float t_im = this->re[bottom] * w_im + this->im[bottom] * w_re;
+
+			this->re[bottom] = this->re[top] - t_re;
+			this->im[bottom] = this->im[top] - t_im;
+			this->re[top] += t_re;
+			this->im[top] += t_im;
+		}
+	}
+}
+
+void Dynamic_Notch::find_peaks() {
+	float bin_width = float(this->rate) / this->FFT_SIZE;
+	uint16_t first = uint16_t(this->MIN_FREQUENCY / bin_width) + 1;
+	uint16_t last = uint16_t(this->MAX_FREQUENCY / bin_width);
+
+	if (last > this->FFT_SIZE / 2 - 2)
+		last = this->FFT_SIZE / 2 - 2;
+
+	for (uint8_t i = 0; i < this->PEAKS; i++)
+		this->found[i] = 0;
+
+	if (first > last)
+		return;
+
+	// power spectrum replaces real part, imaginary is not needed any more
+	float sum = 0;
+	uint16_t strongest = first;
+
+	for (uint16_t i = first - 1; i <= last + 1; i++) {
+		this->re[i] = this->re[i] * this->re[i] + this->im[i] * this->im[i];
+
+		if (i >= first && i <= last) {
+			sum += this->re[i];
+
+			if (this->re[i] > this->re[strongest])
+				strongest = i;
+		}
+	}
+
+	// noise floor without the main lobe of the strongest peak so that it does not hide weaker ones
+	uint16_t floor_bins = last - first + 1;
+
+	for (int16_t i = int16_t(strongest) - 2; i <= strongest + 2; i++) {
+		if (i >= first && i <= last) {
+			sum -= this->re[i];
+			floor_bins--;
+		}
+	}
+
+	float threshold = floor_bins > 0 ? this->PEAK_RATIO * sum / floor_bins : 0;
+	uint16_t bins[PEAKS] = { 0 };
+
+	// strongest local maxima, kept sorted by power
+	for (uint16_t i = first; i <= last; i++) {
+		float power = this->re[i];
+
+		if (power < threshold || power <= this->re[i - 1] || power < this->re[i + 1])
+			continue;
+
+		for (uint8_t j = 0; j < this->PEAKS; j++) {
+			if (bins[j] == 0 || power > this->re[bins[j]]) {
+				for (uint8_t k = this->PEAKS - 1; k > j; k--)
+					bins[k] = bins[k - 1];
+
+				bins[j] = i;
+				break;
+			}
+		}
+	}
+
+	for (uint8_t i = 0; i < this->PEAKS; i++) {
+		if (bins[i] == 0)
+			continue;
+
+		// parabolic interpolation on magnitudes, stays in power order
+		float left = Fast_Math::Sqrt(this->re[bins[i] - 1]);
+		float center = Fast_Math::Sqrt(this->re[bins[i]]);
+		float right = Fast_Math::Sqrt(this->re[bins[i] + 1]);
+		float denominator = left - 2 * center + right;
+		float delta = denominator != 0 ? 0.5f * (left - right) / denominator : 0;
+
+		this->found[i] = (bins[i] + delta) * bin_width;
+	}
+}
+
+// every peak moves the nearest notch, free notch is taken when no tracked one is close
+void Dynamic_Notch::tune() {
+	float *frequency = this->frequency[this->axis];
+	float free_distance = this->MATCH_BINS * float(this->rate) / this->FFT_SIZE;
+	bool used[PEAKS] = { false };
+
+	for (uint8_t i = 0; i < this->PEAKS; i++) {
+		// peak not present in this window, notches stay where they are
+		if (this->found[i] == 0)
+			break;
+
+		uint8_t best = this->PEAKS;
+		float best_distance = 0;
+
+		for (uint8_t j = 0; j < this->PEAKS; j++) {
+			if (used[j])
+				continue;
+
+			float distance = frequency[j] == 0 ? free_distance : std::fabs(this->found[i] - frequency[j]);
+
+			if (best == this->PEAKS || distance < best_distance) {
+				best = j;
+				best_distance = distance;
+			}
+		}
+
+		used[best] = true;
+
+		if (frequency[best] == 0)
+			frequency[best] = this->found[i];
+		else
+			frequency[best] += this->SMOOTHING * (this->found[i] - frequency[best]);
+
+		this->notch[best].Tune(this->axis, Biquad_Filter::FILTER_NOTCH, this->rate, frequency[best], this->NOTCH_Q);
+	}
+}
+
+} /* namespace flyhero */
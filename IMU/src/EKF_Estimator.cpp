@@ -0,0 +1,210 @@
+/*
+ * EKF_Estimator.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "EKF_Estimator.h"
+#include "Fast_Math.h"
+
+namespace flyhero {
+
+EKF_Estimator::EKF_Estimator() {
+	this->initial_variance = 1;
+	this->Set_Noise(1, 0.05f);
+	this->reset();
+}
+
+void EKF_Estimator::Set_Noise(float gyro_noise, float accel_noise) {
+	this->gyro_noise = gyro_noise * DEG_TO_RAD;
+	this->accel_noise = accel_noise;
+}
+
+void EKF_Estimator::Update(const float gyro[3], const float accel[3], float dt) {
+	Quaternion& q = this->quaternion;
+
+	this->predict(gyro, dt);
+
+	float norm = accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2];
+
+	if (norm <= 0) {
+		this->normalise();
+		this->project();
+		return;
+	}
+
+	float recip_norm = Fast_Math::Inv_Sqrt(norm);
+	float a[3] = { accel[0] * recip_norm, accel[1] * recip_norm, accel[2] * recip_norm };
+
+	// expected gravity direction in body frame and its Jacobian
+	float h[3] = {
+		2 * (q.q1 * q.q3 - q.q0 * q.q2),
+		2 * (q.q0 * q.q1 + q.q2 * q.q3),
+		q.q0 * q.q0 - q.q1 * q.q1 - q.q2 * q.q2 + q.q3 * q.q3
+	};
+	float H[3][N] = {
+		{ -2 * q.q2, 2 * q.q3, -2 * q.q0, 2 * q.q1 },
+		{ 2 * q.q1, 2 * q.q0, 2 * q.q3, 2 * q.q2 },
+		{ 2 * q.q0, -2 * q.q1, -2 * q.q2, 2 * q.q3 }
+	};
+
+	// linear acceleration is not gravity, 0.5 g off the norm doubles the deviation
+	float deviation = (1 / recip_norm - 1) * 2;
+	float r = this->accel_noise * this->accel_noise * (1 + deviation * deviation);
+
+	// S = H P H^T + R
+	float PHt[N][3];
+	float S[3][3];
+
+	for (uint8_t i = 0; i < N; i++) {
+		for (uint8_t j = 0; j < 3; j++)
+			PHt[i][j] = this->P[i][0] * H[j][0] + this->P[i][1] * H[j][1] + this->P[i][2] * H[j][2] + this->P[i][3] * H[j][3];
+	}
+
+	for (uint8_t i = 0; i < 3; i++) {
+		for (uint8_t j = 0; j < 3; j++)
+			S[i][j] = H[i][0] * PHt[0][j] + H[i][1] * PHt[1][j] + H[i][2] * PHt[2][j] + H[i][3] * PHt[3][j] + (i == j ? r : 0);
+	}
+
+	// inverse of symmetric 3x3 by cofactors
+	float c00 = S[1][1] * S[2][2] - S[1][2] * S[2][1];
+	float c01 = S[1][2] * S[2][0] - S[1][0] * S[2][2];
+	float c02 = S[1][0] * S[2][1] - S[1][1] * S[2][0];
+	float determinant = S[0][0] * c00 + S[0][1] * c01 + S[0][2] * c02;
+
+	if (determinant == 0) {
+		this->normalise();
+		this->project();
+		return;
+	}
+
+	float inv_det = 1 / determinant;
+	float S_inv[3][3] = {
+		{ c00 * inv_det, (S[0][2] * S[2][1] - S[0][1] * S[2][2]) * inv_det, (S[0][1] * S[1][2] - S[0][2] * S[1][1]) * inv_det },
+		{ c01 * inv_det, (S[0][0] * S[2][2] - S[0][2] * S[2][0]) * inv_det, (S[0][2] * S[1][0] - S[0][0] * S[1][2]) * inv_det },
+		{ c02 * inv_det, (S[0][1] * S[2][0] - S[0][0] * S[2][1]) * inv_det, (S[0][0] * S[1][1] - S[0][1] * S[1][0]) * inv_det }
+	};
+
+	// K = P H^T S^-1
+	float K[N][3];
+
+	for (uint8_t i = 0; i < N; i++) {
+		for (uint8_t j = 0; j < 3; j++)
+			K[i][j] = PHt[i][0] * S_inv[0][j] + PHt[i][1] * S_inv[1][j] + PHt[i][2] * S_inv[2][j];
+	}
+
+	float y[3] = { a[0] - h[0], a[1] - h[1], a[2] - h[2] };
+
+	q.q0 += K[0][0] * y[0] + K[0][1] * y[1] + K[0][2] * y[2];
+	q.q1 += K[1][0] * y[0] + K[1][1] * y[1] + K[1][2] * y[2];
+	q.q2 += K[2][0] * y[0] + K[2][1] * y[1] + K[2][2] * y[2];
+	q.q3 += K[3][0] * y[0] + K[3][1] * y[1] + K[3][2] * y[2];
+
+	// P = P - K (P H^T)^T, kept symmetric
+	for (uint8_t i = 0; i < N; i++) {
+		for (uint8_t j = i; j < N; j++) {
+			float value = this->P[i][j] - (K[i][0] * PHt[j][0] + K[i][1] * PHt[j][1] + K[i][2] * PHt[j][2]);
+
+			this->P[i][j] = value;
+			this->P[j][i] = value;
+		}
+	}
+
+	this->normalise();
+	this->project();
+}
+
+// covariance is propagated as well, skipped corrections only make it grow
+void EKF_Estimator::Predict(const float gyro[3], float dt) {
+	this->predict(gyro, dt);
+	this->normalise();
+	this->project();
+}
+
+// q = F q with F = I + dt / 2 * Omega(w), P = F P F^T + Q
+void EKF_Estimator::predict(const float gyro[3], float dt) {
+	Quaternion& q = this->quaternion;
+	float wx = gyro[0] * DEG_TO_RAD * 0.5f * dt;
+	float wy = gyro[1] * DEG_TO_RAD * 0.5f * dt;
+	float wz = gyro[2] * DEG_TO_RAD * 0.5f * dt;
+
+	float F[N][N] = {
+		{ 1, -wx, -wy, -wz },
+		{ wx, 1, wz, -wy },
+		{ wy, -wz, 1, wx },
+		{ wz, wy, -wx, 1 }
+	};
+	float x[N] = { q.q0, q.q1, q.q2, q.q3 };
+	float FP[N][N];
+
+	q.q0 = F[0][0] * x[0] + F[0][1] * x[1] + F[0][2] * x[2] + F[0][3] * x[3];
+	q.q1 = F[1][0] * x[0] + F[1][1] * x[1] + F[1][2] * x[2] + F[1][3] * x[3];
+	q.q2 = F[2][0] * x[0] + F[2][1] * x[1] + F[2][2] * x[2] + F[2][3] * x[3];
+	q.q3 = F[3][0] * x[0] + F[3][1] * x[1] + F[3][2] * x[2] + F[3][3] * x[3];
+
+	for (uint8_t i = 0; i < N; i++) {
+		for (uint8_t j = 0; j < N; j++)
+			FP[i][j] = F[i][0] * this->P[0][j] + F[i][1] * this->P[1][j] + F[i][2] * this->P[2][j] + F[i][3] * this->P[3][j];
+	}
+
+	// gyro noise maps to the quaternion through Xi(q), Xi Xi^T = I - q q^T for unit q
+	float c = 0.25f * dt * dt * this->gyro_noise * this->gyro_noise;
+	float x_new[N] = { q.q0, q.q1, q.q2, q.q3 };
+
+	for (uint8_t i = 0; i < N; i++) {
+		for (uint8_t j = 0; j < N; j++) {
+			this->P[i][j] = FP[i][0] * F[j][0] + FP[i][1] * F[j][1] + FP[i][2] * F[j][2] + FP[i][3] * F[j][3]
+					+ c * ((i == j ? 1 : 0) - x_new[i] * x_new[j]);
+		}
+	}
+}
+
+const char* EKF_Estimator::Get_Name() {
+	return "ekf";
+}
+
+// attitude unknown, first accel readings pull it in
+void EKF_Estimator::reset() {
+	for (uint8_t i = 0; i < N; i++) {
+		for (uint8_t j = 0; j < N; j++)
+			this->P[i][j] = i == j ? this->initial_variance : 0;
+	}
+
+	this->project();
+}
+
+// Only tilt is uncertain. Covariance along q would let updates change the norm
+// which normalisation throws away, heading is not observed by accel and its
+// variance would only grow until float precision breaks the filter. Both
+// directions are removed, P = (I - v v^T) P (I - v v^T) for each of them.
+void EKF_Estimator::project() {
+	const Quaternion& q = this->quaternion;
+	// q itself and rotation about world Z
+	float directions[2][N] = {
+		{ q.q0, q.q1, q.q2, q.q3 },
+		{ -q.q3, -q.q2, q.q1, q.q0 }
+	};
+
+	for (uint8_t k = 0; k < 2; k++) {
+		const float *v = directions[k];
+		float Pv[N];
+		float vPv = 0;
+
+		for (uint8_t i = 0; i < N; i++) {
+			Pv[i] = this->P[i][0] * v[0] + this->P[i][1] * v[1] + this->P[i][2] * v[2] + this->P[i][3] * v[3];
+			vPv += v[i] * Pv[i];
+		}
+
+		for (uint8_t i = 0; i < N; i++) {
+			for (uint8_t j = i; j < N; j++) {
+				float value = this->P[i][j] - v[i] * Pv[j] - Pv[i] * v[j] + v[i] * v[j] * vPv;
+
+				this->P[i][j] = value;
+				this->P[j][i] = value;
+			}
+		}
+	}
+}
+
+} /* namespace flyhero */
@@ -0,0 +1,137 @@
+/*
+ * Gyro_Bias_Model.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Gyro_Bias_Model.h"
+
+namespace flyhero {
+
+Gyro_Bias_Model::Gyro_Bias_Model() {
+	this->Reset();
+}
+
+void Gyro_Bias_Model::Reset() {
+	for (uint8_t i = 0; i < this->NODES; i++) {
+		for (uint8_t j = 0; j < this->AXES; j++)
+			this->table.bias[i][j] = 0;
+
+		this->table.weight[i] = 0;
+	}
+
+	this->updates = 0;
+	this->fill();
+}
+
+// The period pulls the two nodes around its temperature towards itself, each by
+// its share of the period over the periods the node has seen. A node learned
+// for the first time starts from the value lookup had for it.
+void Gyro_Bias_Model::Learn(float temperature, const float bias[AXES]) {
+	float current[AXES];
+	uint8_t node;
+	float fraction;
+
+	if (!std::isfinite(temperature))
+		return;
+
+	for (uint8_t i = 0; i < this->AXES; i++) {
+		if (!std::isfinite(bias[i]))
+			return;
+	}
+
+	this->Get_Bias(temperature, current);
+	this->locate(temperature, node, fraction);
+
+	float share[2] = { 1 - fraction, fraction };
+
+	for (uint8_t k = 0; k < 2; k++) {
+		uint8_t n = node + k;
+
+		if (share[k] <= 0)
+			continue;
+
+		if (this->table.weight[n] <= 0) {
+			for (uint8_t i = 0; i < this->AXES; i++)
+				this->table.bias[n][i] = this->lookup[n][i];
+		}
+
+		this->table.weight[n] += share[k];
+
+		if (this->table.weight[n] > this->MAX_WEIGHT)
+			this->table.weight[n] = this->MAX_WEIGHT;
+
+		float gain = share[k] / this->table.weight[n];
+
+		for (uint8_t i = 0; i < this->AXES; i++)
+			this->table.bias[n][i] += gain * (bias[i] - current[i]);
+	}
+
+	this->updates++;
+	this->fill();
+}
+
+bool Gyro_Bias_Model::Is_Learned() {
+	return this->learned;
+}
+
+uint32_t Gyro_Bias_Model::Get_Updates() {
+	return this->updates;
+}
+
+void Gyro_Bias_Model::Get_Table(Table& table) {
+	table = this->table;
+}
+
+// refuses tables with garbage, current model stays then
+bool Gyro_Bias_Model::Set_Table(const Table& table) {
+	for (uint8_t i = 0; i < this->NODES; i++) {
+		if (!(table.weight[i] >= 0 && table.weight[i] <= this->MAX_WEIGHT))
+			return false;
+
+		for (uint8_t j = 0; j < this->AXES; j++) {
+			if (!std::isfinite(table.bias[i][j]))
+				return false;
+		}
+	}
+
+	this->table = table;
+	this->fill();
+
+	return true;
+}
+
+// linear between learned nodes, the outermost learned ones hold beyond them
+void Gyro_Bias_Model::fill() {
+	int8_t previous = -1;
+
+	for (uint8_t i = 0; i < this->NODES; i++) {
+		if (this->table.weight[i] <= 0)
+			continue;
+
+		for (uint8_t j = previous + 1; j < i; j++) {
+			for (uint8_t k = 0; k < this->AXES; k++) {
+				if (previous < 0)
+					this->lookup[j][k] = this->table.bias[i][k];
+				else
+					this->lookup[j][k] = this->table.bias[previous][k]
+							+ (this->table.bias[i][k] - this->table.bias[previous][k]) * (j - previous) / (i - previous);
+			}
+		}
+
+		for (uint8_t k = 0; k < this->AXES; k++)
+			this->lookup[i][k] = this->table.bias[i][k];
+
+		previous = i;
+	}
+
+	this->learned = previous >= 0;
+
+	for (uint8_t j = previous + 1; j < this->NODES; j++) {
+		for (uint8_t k = 0; k < this->AXES; k++)
+			this->lookup[j][k] = this->learned ? this->table.bias[previous][k] : 0;
+	}
+}
+
+} /* namespace flyhero */
@@ -0,0 +1,861 @@
+/*
+ * IMU.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "IMU.h"
+#include "MPU6050.h"
+#include "MPU6000.h"
+#include "Config.h"
+
+namespace flyhero {
+
+// data ready interrupt is wired the same for all backends
+extern "C" {
+	void EXTI1_IRQHandler(void)
+	{
+		HAL_GPIO_EXTI_IRQHandler(IMU_INT_PIN);
+	}
+
+	void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+		IMU::Instance().Data_Ready_Handler();
+	}
+}
+
+IMU_Type IMU::type = IMU_MPU6050;
+
+IMU& IMU::Create_Instance(IMU_Type type) {
+	IMU::type = type;
+
+	return IMU::Instance();
+}
+
+IMU& IMU::Instance() {
+	switch (IMU::type) {
+	case IMU_MPU6000:
+		return MPU6000::Instance();
+	case IMU_MPU6050:
+	default:
+		return MPU6050::Instance();
+	}
+}
+
+IMU::IMU()
+	: sensor_filter(Biquad_Filter::FILTER_LOW_PASS, 1000, this->ACCEL_LPF_FREQUENCY)
+{
+	this->dynamic_notch_enabled = false;
+	this->gyro_lpf_frequency = this->GYRO_LPF_FREQUENCY;
+	this->Set_Read_Rate(1000);
+	this->g_fsr = GYRO_FSR_NOT_SET;
+	this->g_mult = 0;
+	this->a_mult = 0;
+	this->a_fsr = ACCEL_FSR_NOT_SET;
+	this->sample_rate = -1;
+	this->temp_scale = 0;
+	this->temp_offset = 0;
+	this->roll = 0;
+	this->pitch = 0;
+	this->yaw = 0;
+	this->start_ticks = 0;
+	this->data_ready_ticks = 0;
+	this->interrupt_ticks = 0;
+	this->interrupt_pending = false;
+	this->decimation_delay = 0;
+	this->sample_timestamp = 0;
+	this->attitude_timestamp = 0;
+	this->latency_compensation = false;
+	this->output_delay = 0;
+	this->Data_Ready_Callback = NULL;
+	this->Data_Read_Callback = NULL;
+	this->quaternion.q0 = 1;
+	this->quaternion.q1 = 0;
+	this->quaternion.q2 = 0;
+	this->quaternion.q3 = 0;
+	this->euler_valid = true;
+	this->estimator = &this->mahony;
+	this->raw_temp = 0;
+	this->calibration_state = CALIBRATION_IDLE;
+	this->calibration_window_size = 0;
+	this->calibration_count = 0;
+	this->calibration_windows = 0;
+	this->calibration_temp = 0;
+	this->calibration_temp_sum = 0;
+	this->bias_learning = false;
+
+	for (uint8_t i = 0; i < 3; i++) {
+		this->accel_offsets[i] = 0;
+		this->gyro_offsets[i] = 0;
+	}
+
+	for (uint8_t i = 0; i < 6; i++)
+		this->decimation_error[i] = 0;
+
+	this->samples.Attach(this->control_reader);
+}
+
+void IMU::gpio_clock_enable(GPIO_TypeDef *base) {
+	switch ((uintptr_t)base) {
+	case GPIOA_BASE:
+		if (__GPIOA_IS_CLK_DISABLED())
+			__GPIOA_CLK_ENABLE();
+		break;
+	case GPIOB_BASE:
+		if (__GPIOB_IS_CLK_DISABLED())
+			__GPIOB_CLK_ENABLE();
+		break;
+	case GPIOC_BASE:
+		if (__GPIOC_IS_CLK_DISABLED())
+			__GPIOC_CLK_ENABLE();
+		break;
+	case GPIOD_BASE:
+		if (__GPIOD_IS_CLK_DISABLED())
+			__GPIOD_CLK_ENABLE();
+		break;
+	case GPIOE_BASE:
+		if (__GPIOE_IS_CLK_DISABLED())
+			__GPIOE_CLK_ENABLE();
+		break;
+	case GPIOF_BASE:
+		if (__GPIOF_IS_CLK_DISABLED())
+			__GPIOF_CLK_ENABLE();
+		break;
+	case GPIOG_BASE:
+		if (__GPIOG_IS_CLK_DISABLED())
+			__GPIOG_CLK_ENABLE();
+		break;
+	case GPIOH_BASE:
+		if (__GPIOH_IS_CLK_DISABLED())
+			__GPIOH_CLK_ENABLE();
+		break;
+	}
+}
+
+void IMU::int_init() {
+	IMU::gpio_clock_enable(IMU_INT_BASE);
+
+	GPIO_InitTypeDef exti;
+
+	exti.Pin = IMU_INT_PIN;
+	exti.Mode = GPIO_MODE_IT_RISING;
+	exti.Pull = GPIO_NOPULL;
+	exti.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	HAL_GPIO_Init(IMU_INT_BASE, &exti);
+
+	switch (IMU_INT_PIN) {
+	case GPIO_PIN_0:
+		HAL_NVIC_SetPriority(EXTI0_IRQn, 2, 0);
+		HAL_NVIC_EnableIRQ(EXTI0_IRQn);
+		break;
+	case GPIO_PIN_1:
+		HAL_NVIC_SetPriority(EXTI1_IRQn, 2, 0);
+		HAL_NVIC_EnableIRQ(EXTI1_IRQn);
+		break;
+	case GPIO_PIN_2:
+		HAL_NVIC_SetPriority(EXTI2_IRQn, 2, 0);
+		HAL_NVIC_EnableIRQ(EXTI2_IRQn);
+		break;
+	case GPIO_PIN_3:
+		HAL_NVIC_SetPriority(EXTI3_IRQn, 2, 0);
+		HAL_NVIC_EnableIRQ(EXTI3_IRQn);
+		break;
+	case GPIO_PIN_4:
+		HAL_NVIC_SetPriority(EXTI4_IRQn, 2, 0);
+		HAL_NVIC_EnableIRQ(EXTI4_IRQn);
+		break;
+	case GPIO_PIN_5:
+	case GPIO_PIN_6:
+	case GPIO_PIN_7:
+	case GPIO_PIN_8:
+	case GPIO_PIN_9:
+		HAL_NVIC_SetPriority(EXTI9_5_IRQn, 2, 0);
+		HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+		break;
+	case GPIO_PIN_10:
+	case GPIO_PIN_11:
+	case GPIO_PIN_12:
+	case GPIO_PIN_13:
+	case GPIO_PIN_14:
+	case GPIO_PIN_15:
+		HAL_NVIC_SetPriority(EXTI15_10_IRQn, 2, 0);
+		HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+		break;
+	}
+}
+
+// register codes are the same for all backends
+void IMU::set_gyro_range(gyro_fsr fsr) {
+	this->g_fsr = fsr;
+
+	switch (fsr) {
+	case GYRO_FSR_250:
+		this->g_mult = 250;
+		break;
+	case GYRO_FSR_500:
+		this->g_mult = 500;
+		break;
+	case GYRO_FSR_1000:
+		this->g_mult = 1000;
+		break;
+	case GYRO_FSR_2000:
+		this->g_mult = 2000;
+		break;
+	case GYRO_FSR_NOT_SET:
+		this->g_mult = 0;
+		return;
+	}
+
+	this->g_mult /= pow(2, this->ADC_BITS - 1);
+}
+
+void IMU::set_accel_range(accel_fsr fsr) {
+	this->a_fsr = fsr;
+
+	switch (fsr) {
+	case ACCEL_FSR_2:
+		this->a_mult = 2;
+		break;
+	case ACCEL_FSR_4:
+		this->a_mult = 4;
+		break;
+	case ACCEL_FSR_8:
+		this->a_mult = 8;
+		break;
+	case ACCEL_FSR_16:
+		this->a_mult = 16;
+		break;
+	case ACCEL_FSR_NOT_SET:
+		this->a_mult = 0;
+		return;
+	}
+
+	this->a_mult /= pow(2, this->ADC_BITS - 1);
+}
+
+HAL_StatusTypeDef IMU::Set_FIFO_Mode(bool enable) {
+	return enable ? HAL_ERROR : HAL_OK;
+}
+
+bool IMU::Get_FIFO_Mode() {
+	return false;
+}
+
+uint32_t IMU::Get_FIFO_Overflows() {
+	return 0;
+}
+
+uint16_t IMU::Get_Sample_Rate() {
+	return this->sample_rate;
+}
+
+uint16_t IMU::Get_Output_Rate() {
+	return this->sample_rate / this->decimator.Get_Ratio();
+}
+
+// Has to be set after Set_Sample_Rate() and before callbacks are assigned, calibration
+// and read rate follow the output rate. Anti alias frequency of 0 leaves the biquad off.
+HAL_StatusTypeDef IMU::Set_Decimation(uint8_t ratio, Sample_Decimator::Order order, float anti_alias_frequency) {
+	if (this->sample_rate <= 0 || anti_alias_frequency < 0 || anti_alias_frequency >= this->sample_rate / 2.0f)
+		return HAL_ERROR;
+
+	if (!this->decimator.Configure(ratio, order))
+		return HAL_ERROR;
+
+	this->decimator.Set_Anti_Alias(this->sample_rate, anti_alias_frequency);
+	this->decimation_delay = uint32_t(this->decimator.Get_Delay() * 1000000 / this->sample_rate + 0.5f);
+
+	for (uint8_t i = 0; i < 6; i++)
+		this->decimation_error[i] = 0;
+
+	return HAL_OK;
+}
+
+IMU::Sample_Decimator& IMU::Get_Decimator() {
+	return this->decimator;
+}
+
+Vibration_Monitor& IMU::Get_Vibration_Monitor() {
+	return this->vibration;
+}
+
+// filters run once per Complete_Read(), default is 1 kHz
+void IMU::Set_Read_Rate(uint16_t rate) {
+	this->read_rate = rate;
+
+	for (uint8_t i = 0; i < 3; i++) {
+		this->sensor_filter.Set_Coefficients(i, Biquad_Filter::FILTER_LOW_PASS, rate, this->ACCEL_LPF_FREQUENCY);
+		this->sensor_filter.Set_Coefficients(i + 3, Biquad_Filter::FILTER_LOW_PASS, rate, this->gyro_lpf_frequency);
+	}
+
+	this->dynamic_notch.Init(rate);
+}
+
+// with vibrations removed by dynamic notch the cut may go up to lower the lag
+void IMU::Set_Gyro_LPF(float cut_frequency) {
+	this->gyro_lpf_frequency = cut_frequency;
+
+	for (uint8_t i = 3; i < 6; i++)
+		this->sensor_filter.Set_Coefficients(i, Biquad_Filter::FILTER_LOW_PASS, this->read_rate, cut_frequency);
+}
+
+// analysis itself runs in Get_Dynamic_Notch().Step()
+void IMU::Set_Dynamic_Notch(bool enable) {
+	if (enable && !this->dynamic_notch_enabled)
+		this->dynamic_notch.Init(this->read_rate);
+
+	this->dynamic_notch_enabled = enable;
+}
+
+Dynamic_Notch& IMU::Get_Dynamic_Notch() {
+	return this->dynamic_notch;
+}
+
+void IMU::parse_sample(const uint8_t *data, Sample& sample) {
+	sample.accel.x = (data[0] << 8) | data[1];
+	sample.accel.y = (data[2] << 8) | data[3];
+	sample.accel.z = (data[4] << 8) | data[5];
+
+	sample.temp = (data[6] << 8) | data[7];
+
+	sample.gyro.x = (data[8] << 8) | data[9];
+	sample.gyro.y = (data[10] << 8) | data[11];
+	sample.gyro.z = (data[12] << 8) | data[13];
+}
+
+// Sample ISR part, fixed cost per sample. Decimated sample takes temperature and
+// timestamp of the newest sample in it.
+bool IMU::push_sample(const Sample& sample) {
+	float data[6] = {
+		float(sample.accel.x), float(sample.accel.y), float(sample.accel.z),
+		float(sample.gyro.x), float(sample.gyro.y), float(sample.gyro.z)
+	};
+	int16_t raw[6] = {
+		sample.accel.x, sample.accel.y, sample.accel.z,
+		sample.gyro.x, sample.gyro.y, sample.gyro.z
+	};
+	int16_t rounded[6];
+
+	this->vibration.Add(raw, sample.timestamp);
+
+	if (!this->decimator.Push(data, data))
+		return false;
+
+	for (uint8_t i = 0; i < 6; i++) {
+		float value = data[i] + this->decimation_error[i];
+
+		if (value > 32767)
+			value = 32767;
+		else if (value < -32768)
+			value = -32768;
+
+		rounded[i] = int16_t(std::floor(value + 0.5f));
+		this->decimation_error[i] = value - rounded[i];
+	}
+
+	Sample decimated = sample;
+
+	decimated.accel.x = rounded[0];
+	decimated.accel.y = rounded[1];
+	decimated.accel.z = rounded[2];
+	decimated.gyro.x = rounded[3];
+	decimated.gyro.y = rounded[4];
+	decimated.gyro.z = rounded[5];
+	decimated.timestamp = sample.timestamp - this->decimation_delay;
+
+	this->samples.Push(decimated);
+
+	return true;
+}
+
+// averages samples received since last call down to control rate, returns their count
+uint8_t IMU::Complete_Read() {
+	Sample sample = Sample();
+	int32_t accel_sum[3] = { 0 };
+	int32_t gyro_sum[3] = { 0 };
+	uint8_t count = 0;
+
+	while (this->samples.Read(this->control_reader, sample)) {
+		accel_sum[0] += sample.accel.x;
+		accel_sum[1] += sample.accel.y;
+		accel_sum[2] += sample.accel.z;
+		gyro_sum[0] += sample.gyro.x;
+		gyro_sum[1] += sample.gyro.y;
+		gyro_sum[2] += sample.gyro.z;
+
+		count++;
+	}
+
+	if (count == 0)
+		return 0;
+
+	this->raw_accel = sample.accel;
+	this->raw_gyro = sample.gyro;
+	this->raw_temp = sample.temp;
+	this->sample_timestamp = sample.timestamp;
+
+	float scale = 1.0f / count;
+
+	float data[6];
+	float gyro_bias[3];
+
+	// calibration offsets hold only at the temperature they were taken at
+	if (this->gyro_bias.Is_Learned())
+		this->gyro_bias.Get_Bias(this->raw_temp * this->temp_scale + this->temp_offset, gyro_bias);
+	else {
+		for (uint8_t i = 0; i < 3; i++)
+			gyro_bias[i] = -this->gyro_offsets[i] * this->g_mult;
+	}
+
+	for (uint8_t i = 0; i < 3; i++) {
+		data[i] = (accel_sum[i] * scale + this->accel_offsets[i]) * this->a_mult;
+		data[i + 3] = gyro_sum[i] * scale * this->g_mult - gyro_bias[i];
+	}
+
+	if (this->dynamic_notch_enabled) {
+		this->dynamic_notch.Push(data + 3);
+		this->dynamic_notch.Apply_Filter(data + 3);
+	}
+
+	this->sensor_filter.Apply_Filter(data, data);
+
+	this->accel.x = data[0];
+	this->accel.y = data[1];
+	this->accel.z = data[2];
+	this->gyro.x = data[3];
+	this->gyro.y = data[4];
+	this->gyro.z = data[5];
+
+	return count;
+}
+
+IMU::Ring& IMU::Get_Sample_Ring() {
+	return this->samples;
+}
+
+bool IMU::Get_Last_Sample(Sample& sample) {
+	return this->samples.Read_Latest(sample);
+}
+
+void IMU::Get_Raw_Accel(Raw_Data& raw_accel) {
+	raw_accel = this->raw_accel;
+}
+
+void IMU::Get_Raw_Gyro(Raw_Data& raw_gyro) {
+	raw_gyro = this->raw_gyro;
+}
+
+void IMU::Get_Raw_Temp(int16_t& raw_temp) {
+	raw_temp = this->raw_temp;
+}
+
+// die temperature [deg C]
+float IMU::Get_Temperature() {
+	return this->raw_temp * this->temp_scale + this->temp_offset;
+}
+
+void IMU::Get_Accel(Sensor_Data& accel) {
+	accel = this->accel;
+}
+
+void IMU::Get_Gyro(Sensor_Data& gyro) {
+	gyro = this->gyro;
+}
+
+HAL_StatusTypeDef IMU::Read_Raw(Raw_Data& accel, Raw_Data& gyro) {
+	uint8_t tmp[SAMPLE_SIZE];
+	Sample sample;
+
+	if (this->read_output(tmp))
+		return HAL_ERROR;
+
+	this->parse_sample(tmp, sample);
+
+	accel = sample.accel;
+	gyro = sample.gyro;
+
+	return HAL_OK;
+}
+
+// until the data ready -> DMA chain is set up (callbacks assigned) samples are polled
+HAL_StatusTypeDef IMU::read_sample(Ring::Reader& reader, Sample& sample) {
+	if (this->Data_Ready_Callback == NULL) {
+		uint8_t tmp[SAMPLE_SIZE];
+
+		do {
+			if (this->read_output(tmp))
+				return HAL_ERROR;
+
+			this->parse_sample(tmp, sample);
+			sample.timestamp = Timer::Get_Tick_Count();
+		} while (!this->push_sample(sample));
+	}
+
+	uint32_t timestamp = HAL_GetTick();
+
+	while (!this->samples.Read(reader, sample)) {
+		if (HAL_GetTick() - timestamp > 10)
+			return HAL_TIMEOUT;
+	}
+
+	return HAL_OK;
+}
+
+// Blocking variant for setups where samples are polled (no callbacks assigned yet),
+// offset registers keep their factory values.
+HAL_StatusTypeDef IMU::Calibrate() {
+	Ring::Reader reader;
+	Sample sample;
+	uint32_t timestamp = HAL_GetTick();
+
+	this->samples.Attach(reader);
+	this->Start_Calibration();
+
+	while (this->Update_Calibration() == CALIBRATION_RUNNING) {
+		if (this->read_sample(reader, sample))
+			return HAL_ERROR;
+
+		if (HAL_GetTick() - timestamp > this->CALIBRATION_TIMEOUT)
+			return HAL_TIMEOUT;
+	}
+
+	// control starts with fresh samples
+	this->samples.Attach(this->control_reader);
+
+	return HAL_OK;
+}
+
+// Offsets are gathered from the sample stream in the background, Update_Calibration()
+// has to be called often enough for the ring not to overflow (16 ms at 8 kHz).
+// Current offsets stay applied until new ones are known.
+void IMU::Start_Calibration() {
+	this->samples.Attach(this->calibration_reader);
+
+	this->calibration_window_size = uint16_t(this->Get_Output_Rate() * this->CALIBRATION_WINDOW);
+	this->calibration_count = 0;
+	this->calibration_windows = 0;
+	this->calibration_state = CALIBRATION_RUNNING;
+}
+
+IMU::Calibration_State IMU::Update_Calibration() {
+	Sample sample;
+
+	if (this->calibration_state != CALIBRATION_RUNNING && !this->bias_learning)
+		return this->calibration_state;
+
+	while (this->samples.Read(this->calibration_reader, sample)) {
+		this->calibration_add(sample);
+
+		if (this->calibration_count >= this->calibration_window_size) {
+			this->calibration_window();
+
+			if (this->calibration_state != CALIBRATION_RUNNING && !this->bias_learning)
+				break;
+		}
+	}
+
+	return this->calibration_state;
+}
+
+IMU::Calibration_State IMU::Get_Calibration_State() {
+	return this->calibration_state;
+}
+
+bool IMU::Get_Calibration(Calibration& calibration) {
+	if (this->calibration_state != CALIBRATION_DONE)
+		return false;
+
+	for (uint8_t i = 0; i < 3; i++) {
+		calibration.accel_offsets[i] = this->accel_offsets[i];
+		calibration.gyro_offsets[i] = this->gyro_offsets[i];
+	}
+
+	calibration.accel_fsr = this->a_fsr;
+	calibration.gyro_fsr = this->g_fsr;
+
+	return true;
+}
+
+// offsets in LSB do not fit other full scale ranges
+HAL_StatusTypeDef IMU::Set_Calibration(const Calibration& calibration) {
+	if (calibration.accel_fsr != this->a_fsr || calibration.gyro_fsr != this->g_fsr)
+		return HAL_ERROR;
+
+	for (uint8_t i = 0; i < 3; i++) {
+		if (!std::isfinite(calibration.accel_offsets[i]) || !std::isfinite(calibration.gyro_offsets[i]))
+			return HAL_ERROR;
+	}
+
+	for (uint8_t i = 0; i < 3; i++) {
+		this->accel_offsets[i] = calibration.accel_offsets[i];
+		this->gyro_offsets[i] = calibration.gyro_offsets[i];
+	}
+
+	this->calibration_state = CALIBRATION_DONE;
+
+	return HAL_OK;
+}
+
+// Gyro bias is learned over temperature from every stationary period found by
+// calibration, with learning enabled also after calibration is done. The same
+// Update_Calibration() call drives it. Periods are judged on their own, the
+// frame does not have to be level.
+void IMU::Set_Bias_Learning(bool enable) {
+	if (enable && !this->bias_learning && this->calibration_state != CALIBRATION_RUNNING) {
+		this->samples.Attach(this->calibration_reader);
+
+		this->calibration_window_size = uint16_t(this->Get_Output_Rate() * this->CALIBRATION_WINDOW);
+		this->calibration_count = 0;
+		this->calibration_windows = 0;
+	}
+
+	this->bias_learning = enable;
+}
+
+Gyro_Bias_Model& IMU::Get_Gyro_Bias_Model() {
+	return this->gyro_bias;
+}
+
+// Welford update, numerically fine in float for a window of a few hundred samples
+void IMU::calibration_add(const Sample& sample) {
+	float data[6] = {
+		float(sample.accel.x), float(sample.accel.y), float(sample.accel.z),
+		float(sample.gyro.x), float(sample.gyro.y), float(sample.gyro.z)
+	};
+
+	if (this->calibration_count == 0) {
+		for (uint8_t i = 0; i < 6; i++) {
+			this->calibration_mean[i] = 0;
+			this->calibration_m2[i] = 0;
+		}
+
+		this->calibration_temp = 0;
+	}
+
+	this->calibration_count++;
+	this->calibration_temp += sample.temp;
+
+	for (uint8_t i = 0; i < 6; i++) {
+		float delta = data[i] - this->calibration_mean[i];
+
+		this->calibration_mean[i] += delta / this->calibration_count;
+		this->calibration_m2[i] += delta * (data[i] - this->calibration_mean[i]);
+	}
+}
+
+// Window is accepted when the sensor was still during it and its mean agrees with the
+// windows accepted before (slow rotation has low noise but moving mean). Any motion
+// starts over, the frame may have been moved to a different attitude.
+void IMU::calibration_window() {
+	bool still = true;
+	float temp = float(this->calibration_temp) / this->calibration_count;
+
+	for (uint8_t i = 0; i < 6; i++) {
+		float mult = i < 3 ? this->a_mult : this->g_mult;
+		float noise = i < 3 ? this->CALIBRATION_ACCEL_NOISE : this->CALIBRATION_GYRO_NOISE;
+		float drift = i < 3 ? this->CALIBRATION_ACCEL_DRIFT : this->CALIBRATION_GYRO_DRIFT;
+		float variance = this->calibration_m2[i] / (this->calibration_count - 1);
+
+		if (variance * mult * mult > noise * noise)
+			still = false;
+
+		if (this->calibration_windows > 0
+				&& std::fabs(this->calibration_mean[i] - this->calibration_sum[i] / this->calibration_windows) * mult > drift)
+			still = false;
+	}
+
+	this->calibration_count = 0;
+
+	if (!still) {
+		this->calibration_windows = 0;
+		return;
+	}
+
+	for (uint8_t i = 0; i < 6; i++) {
+		if (this->calibration_windows == 0)
+			this->calibration_sum[i] = 0;
+
+		this->calibration_sum[i] += this->calibration_mean[i];
+	}
+
+	if (this->calibration_windows == 0)
+		this->calibration_temp_sum = 0;
+
+	this->calibration_temp_sum += temp;
+	this->calibration_windows++;
+
+	if (this->calibration_windows < this->CALIBRATION_WINDOWS)
+		return;
+
+	// still gyro reads its bias
+	float bias[3];
+
+	for (uint8_t i = 0; i < 3; i++)
+		bias[i] = this->calibration_sum[i + 3] / this->calibration_windows * this->g_mult;
+
+	this->gyro_bias.Learn(this->calibration_temp_sum / this->calibration_windows * this->temp_scale + this->temp_offset, bias);
+
+	if (this->calibration_state == CALIBRATION_RUNNING) {
+		// level frame, accel Z reads +1 g
+		for (uint8_t i = 0; i < 3; i++) {
+			this->accel_offsets[i] = -this->calibration_sum[i] / this->calibration_windows;
+			this->gyro_offsets[i] = -this->calibration_sum[i + 3] / this->calibration_windows;
+		}
+
+		this->accel_offsets[2] += 1 / this->a_mult;
+
+		this->calibration_state = CALIBRATION_DONE;
+	}
+
+	// next period is judged on its own
+	this->calibration_windows = 0;
+}
+
+void IMU::Set_Estimator(Estimator_Type type) {
+	switch (type) {
+	case ESTIMATOR_MAHONY:
+		this->estimator = &this->mahony;
+		break;
+	case ESTIMATOR_MADGWICK:
+		this->estimator = &this->madgwick;
+		break;
+	case ESTIMATOR_EKF:
+		this->estimator = &this->ekf;
+		break;
+	}
+
+	this->estimator->Reset();
+}
+
+Attitude_Estimator& IMU::Get_Estimator() {
+	return *this->estimator;
+}
+
+// Integrates over the time covered by samples since the previous attitude
+// update, so it may run at any rate and sample jitter does not matter.
+void IMU::Compute_Attitude() {
+	float dt = this->attitude_dt();
+
+	if (dt == 0)
+		return;
+
+	float gyro[3] = { this->gyro.x, this->gyro.y, this->gyro.z };
+	float accel[3] = { this->accel.x, this->accel.y, this->accel.z };
+
+	this->estimator->Update(gyro, accel, dt);
+
+	this->publish_attitude();
+}
+
+// gyro only, keeps attitude current between accel corrections at a fraction of the cost
+void IMU::Predict_Attitude() {
+	float dt = this->attitude_dt();
+
+	if (dt == 0)
+		return;
+
+	float gyro[3] = { this->gyro.x, this->gyro.y, this->gyro.z };
+
+	this->estimator->Predict(gyro, dt);
+
+	this->publish_attitude();
+}
+
+// quaternion for consumers, Euler angles are converted on demand
+void IMU::publish_attitude() {
+	const Quaternion& quaternion = this->estimator->Get_Quaternion();
+
+	if (this->latency_compensation) {
+		float gyro[3] = { this->gyro.x, this->gyro.y, this->gyro.z };
+		float horizon = (this->Get_Sample_Age() + this->output_delay) * 0.000001f;
+
+		Attitude_Estimator::Extrapolate(quaternion, gyro, horizon, this->quaternion);
+	}
+	else
+		this->quaternion = quaternion;
+
+	this->euler_valid = false;
+}
+
+void IMU::Set_Latency_Compensation(bool enable, uint32_t output_delay_us) {
+	this->latency_compensation = enable;
+	this->output_delay = output_delay_us;
+}
+
+bool IMU::Get_Latency_Compensation() {
+	return this->latency_compensation;
+}
+
+uint32_t IMU::Get_Sample_Timestamp() {
+	return this->sample_timestamp;
+}
+
+uint32_t IMU::Get_Sample_Age() {
+	return Timer::Get_Tick_Count() - this->sample_timestamp;
+}
+
+void IMU::Data_Ready_Handler() {
+	this->interrupt_ticks = Timer::Get_Tick_Count();
+	this->interrupt_pending = true;
+
+	if (this->Data_Ready_Callback != NULL)
+		this->Data_Ready_Callback();
+}
+
+// each interrupt stamps one read only, polled reads have nothing better than now
+uint32_t IMU::capture_ticks() {
+	if (!this->interrupt_pending)
+		return Timer::Get_Tick_Count();
+
+	this->interrupt_pending = false;
+
+	return this->interrupt_ticks;
+}
+
+// zero when no sample came since the last update, nominal period after a pause
+float IMU::attitude_dt() {
+	uint32_t elapsed = this->sample_timestamp - this->attitude_timestamp;
+
+	this->attitude_timestamp = this->sample_timestamp;
+
+	if (elapsed == 0)
+		return 0;
+
+	if (elapsed > this->ATTITUDE_MAX_DT)
+		return 1.0f / this->read_rate;
+
+	return elapsed * 0.000001f;
+}
+
+// converted once per attitude update, only for those who need angles
+void IMU::Get_Euler(float& roll, float& pitch, float& yaw) {
+	if (!this->euler_valid) {
+		Attitude_Estimator::Get_Euler(this->quaternion, this->roll, this->pitch, this->yaw);
+		this->euler_valid = true;
+	}
+
+	roll = this->roll;
+	pitch = this->pitch;
+	yaw = this->yaw;
+}
+
+void IMU::Get_Quaternion(Quaternion& quaternion) {
+	quaternion = this->quaternion;
+}
+
+void IMU::Get_Rotation_Matrix(float matrix[3][3]) {
+	Attitude_Estimator::Get_Rotation_Matrix(this->quaternion, matrix);
+}
+
+void IMU::Reset_Integrators() {
+	this->roll = 0;
+	this->pitch = 0;
+	this->yaw = 0;
+
+	this->euler_valid = true;
+
+	this->estimator->Reset();
+	this->quaternion = this->estimator->Get_Quaternion();
+}
+
+} /* namespace flyhero */
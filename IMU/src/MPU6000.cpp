@@ -0,0 +1,482 @@
+/*
+ * MPU6000.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "MPU6000.h"
+#include "Config.h"
+
+namespace flyhero {
+
+// vectors follow IMU_SPI_DMA_RX and IMU_SPI_DMA_TX in Config.h
+extern "C" {
+	void DMA2_Stream0_IRQHandler(void)
+	{
+		HAL_DMA_IRQHandler(MPU6000::Instance().Get_DMA_Rx_Handle());
+	}
+
+	void DMA2_Stream3_IRQHandler(void)
+	{
+		HAL_DMA_IRQHandler(MPU6000::Instance().Get_DMA_Tx_Handle());
+	}
+
+	void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi) {
+		if (!MPU6000::Instance().Store_Sample())
+			return;
+
+		if (MPU6000::Instance().Data_Read_Callback != NULL)
+			MPU6000::Instance().Data_Read_Callback();
+	}
+}
+
+static IRQn_Type dma_irq(DMA_Stream_TypeDef *stream) {
+	switch ((uintptr_t)stream) {
+	case DMA1_Stream0_BASE:
+		return DMA1_Stream0_IRQn;
+	case DMA1_Stream1_BASE:
+		return DMA1_Stream1_IRQn;
+	case DMA1_Stream2_BASE:
+		return DMA1_Stream2_IRQn;
+	case DMA1_Stream3_BASE:
+		return DMA1_Stream3_IRQn;
+	case DMA1_Stream4_BASE:
+		return DMA1_Stream4_IRQn;
+	case DMA1_Stream5_BASE:
+		return DMA1_Stream5_IRQn;
+	case DMA1_Stream6_BASE:
+		return DMA1_Stream6_IRQn;
+	case DMA1_Stream7_BASE:
+		return DMA1_Stream7_IRQn;
+	case DMA2_Stream0_BASE:
+		return DMA2_Stream0_IRQn;
+	case DMA2_Stream1_BASE:
+		return DMA2_Stream1_IRQn;
+	case DMA2_Stream2_BASE:
+		return DMA2_Stream2_IRQn;
+	case DMA2_Stream3_BASE:
+		return DMA2_Stream3_IRQn;
+	case DMA2_Stream4_BASE:
+		return DMA2_Stream4_IRQn;
+	case DMA2_Stream5_BASE:
+		return DMA2_Stream5_IRQn;
+	case DMA2_Stream6_BASE:
+		return DMA2_Stream6_IRQn;
+	default:
+		return DMA2_Stream7_IRQn;
+	}
+}
+
+MPU6000& MPU6000::Instance() {
+	static MPU6000 instance;
+
+	return instance;
+}
+
+MPU6000::MPU6000() {
+	this->device = DEVICE_UNKNOWN;
+	this->lpf = LPF_NOT_SET;
+	this->state = READ_IDLE;
+	this->hspi.Init.BaudRatePrescaler = this->SPI_SLOW_PRESCALER;
+
+	// only the register address is sent, the rest clocks data out
+	this->tx_buffer[0] = this->REGISTERS.ACCEL_XOUT_H | this->SPI_READ;
+
+	for (uint8_t i = 1; i < sizeof(this->tx_buffer); i++)
+		this->tx_buffer[i] = 0;
+}
+
+DMA_HandleTypeDef* MPU6000::Get_DMA_Rx_Handle() {
+	return &this->hdma_spi_rx;
+}
+
+DMA_HandleTypeDef* MPU6000::Get_DMA_Tx_Handle() {
+	return &this->hdma_spi_tx;
+}
+
+SPI_HandleTypeDef* MPU6000::Get_SPI_Handle() {
+	return &this->hspi;
+}
+
+MPU6000::Device MPU6000::Get_Device() {
+	return this->device;
+}
+
+HAL_StatusTypeDef MPU6000::spi_init() {
+	GPIO_InitTypeDef GPIO_InitStructure;
+
+	IMU::gpio_clock_enable(IMU_SCK_BASE);
+	IMU::gpio_clock_enable(IMU_MISO_BASE);
+	IMU::gpio_clock_enable(IMU_MOSI_BASE);
+	IMU::gpio_clock_enable(IMU_CS_BASE);
+
+	switch ((uintptr_t)IMU_SPI) {
+	case SPI1_BASE:
+		if (__SPI1_IS_CLK_DISABLED())
+			__SPI1_CLK_ENABLE();
+		GPIO_InitStructure.Alternate = GPIO_AF5_SPI1;
+		break;
+	case SPI2_BASE:
+		if (__SPI2_IS_CLK_DISABLED())
+			__SPI2_CLK_ENABLE();
+		GPIO_InitStructure.Alternate = GPIO_AF5_SPI2;
+		break;
+	case SPI3_BASE:
+		if (__SPI3_IS_CLK_DISABLED())
+			__SPI3_CLK_ENABLE();
+		GPIO_InitStructure.Alternate = GPIO_AF6_SPI3;
+		break;
+	}
+
+	if (__DMA1_IS_CLK_DISABLED())
+		__DMA1_CLK_ENABLE();
+	if (__DMA2_IS_CLK_DISABLED())
+		__DMA2_CLK_ENABLE();
+
+	// deselect before the pin becomes an output
+	HAL_GPIO_WritePin(IMU_CS_BASE, IMU_CS_PIN, GPIO_PIN_SET);
+
+	GPIO_InitStructure.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStructure.Pull = GPIO_NOPULL;
+	GPIO_InitStructure.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+
+	GPIO_InitStructure.Pin = IMU_SCK_PIN;
+	HAL_GPIO_Init(IMU_SCK_BASE, &GPIO_InitStructure);
+
+	GPIO_InitStructure.Pin = IMU_MISO_PIN;
+	HAL_GPIO_Init(IMU_MISO_BASE, &GPIO_InitStructure);
+
+	GPIO_InitStructure.Pin = IMU_MOSI_PIN;
+	HAL_GPIO_Init(IMU_MOSI_BASE, &GPIO_InitStructure);
+
+	GPIO_InitStructure.Pin = IMU_CS_PIN;
+	GPIO_InitStructure.Mode = GPIO_MODE_OUTPUT_PP;
+	GPIO_InitStructure.Pull = GPIO_PULLUP;
+	HAL_GPIO_Init(IMU_CS_BASE, &GPIO_InitStructure);
+
+	// mode 3, registers are written slowly until Init() is done
+	this->hspi.Instance = IMU_SPI;
+	this->hspi.Init.Mode = SPI_MODE_MASTER;
+	this->hspi.Init.Direction = SPI_DIRECTION_2LINES;
+	this->hspi.Init.DataSize = SPI_DATASIZE_8BIT;
+	this->hspi.Init.CLKPolarity = SPI_POLARITY_HIGH;
+	this->hspi.Init.CLKPhase = SPI_PHASE_2EDGE;
+	this->hspi.Init.NSS = SPI_NSS_SOFT;
+	this->hspi.Init.BaudRatePrescaler = this->SPI_SLOW_PRESCALER;
+	this->hspi.Init.FirstBit = SPI_FIRSTBIT_MSB;
+	this->hspi.Init.TIMode = SPI_TIMODE_DISABLE;
+	this->hspi.Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
+	this->hspi.Init.CRCPolynomial = 7;
+	if (HAL_SPI_Init(&this->hspi))
+		return HAL_ERROR;
+
+	this->hdma_spi_rx.Instance = IMU_SPI_DMA_RX;
+	this->hdma_spi_rx.Init.Channel = IMU_SPI_DMA_CHANNEL;
+	this->hdma_spi_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+	this->hdma_spi_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+	this->hdma_spi_rx.Init.MemInc = DMA_MINC_ENABLE;
+	this->hdma_spi_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	this->hdma_spi_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	this->hdma_spi_rx.Init.Mode = DMA_NORMAL;
+	this->hdma_spi_rx.Init.Priority = DMA_PRIORITY_HIGH;
+	this->hdma_spi_rx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+	HAL_DMA_Init(&this->hdma_spi_rx);
+
+	__HAL_LINKDMA(&this->hspi, hdmarx, this->hdma_spi_rx);
+
+	this->hdma_spi_tx.Instance = IMU_SPI_DMA_TX;
+	this->hdma_spi_tx.Init = this->hdma_spi_rx.Init;
+	this->hdma_spi_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+	HAL_DMA_Init(&this->hdma_spi_tx);
+
+	__HAL_LINKDMA(&this->hspi, hdmatx, this->hdma_spi_tx);
+
+	HAL_NVIC_SetPriority(dma_irq(IMU_SPI_DMA_RX), 2, 0);
+	HAL_NVIC_EnableIRQ(dma_irq(IMU_SPI_DMA_RX));
+	HAL_NVIC_SetPriority(dma_irq(IMU_SPI_DMA_TX), 2, 0);
+	HAL_NVIC_EnableIRQ(dma_irq(IMU_SPI_DMA_TX));
+
+	return HAL_OK;
+}
+
+// BR may be changed only while SPI is off, HAL turns it on with the next transfer
+void MPU6000::spi_set_speed(uint32_t prescaler) {
+	if (this->hspi.Init.BaudRatePrescaler == prescaler)
+		return;
+
+	this->hspi.Init.BaudRatePrescaler = prescaler;
+
+	__HAL_SPI_DISABLE(&this->hspi);
+	this->hspi.Instance->CR1 = (this->hspi.Instance->CR1 & ~SPI_CR1_BR) | prescaler;
+}
+
+void MPU6000::spi_select(bool select) {
+	HAL_GPIO_WritePin(IMU_CS_BASE, IMU_CS_PIN, select ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+// blocking transfers run at the slow clock and only while no sample read is pending
+HAL_StatusTypeDef MPU6000::spi_write(uint8_t reg, uint8_t data) {
+	uint8_t tx[2] = { reg, data };
+	uint8_t rx[2];
+
+	if (this->state != READ_IDLE)
+		return HAL_BUSY;
+
+	this->spi_set_speed(this->SPI_SLOW_PRESCALER);
+
+	this->spi_select(true);
+	HAL_StatusTypeDef status = HAL_SPI_TransmitReceive(&this->hspi, tx, rx, 2, this->SPI_TIMEOUT);
+	this->spi_select(false);
+
+	return status;
+}
+
+HAL_StatusTypeDef MPU6000::spi_read(uint8_t reg, uint8_t *data, uint8_t data_size) {
+	uint8_t tx[SAMPLE_SIZE + 1] = { 0 };
+	uint8_t rx[SAMPLE_SIZE + 1];
+
+	if (data_size > this->SAMPLE_SIZE)
+		return HAL_ERROR;
+
+	if (this->state != READ_IDLE)
+		return HAL_BUSY;
+
+	tx[0] = reg | this->SPI_READ;
+
+	this->spi_set_speed(this->SPI_SLOW_PRESCALER);
+
+	this->spi_select(true);
+	HAL_StatusTypeDef status = HAL_SPI_TransmitReceive(&this->hspi, tx, rx, data_size + 1, this->SPI_TIMEOUT);
+	this->spi_select(false);
+
+	if (status != HAL_OK)
+		return status;
+
+	for (uint8_t i = 0; i < data_size; i++)
+		data[i] = rx[i + 1];
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef MPU6000::Init() {
+	uint8_t tmp;
+
+	// init SPI bus including DMA streams
+	if (this->spi_init())
+		return HAL_ERROR;
+
+	// init INT pin on STM32
+	this->int_init();
+
+	// reset device
+	if (this->spi_write(this->REGISTERS.PWR_MGMT_1, 0x80))
+		return HAL_ERROR;
+
+	// wait until reset done
+	do {
+		HAL_Delay(1);
+
+		if (this->spi_read(this->REGISTERS.PWR_MGMT_1, &tmp, 1))
+			return HAL_ERROR;
+	} while (tmp & 0x80);
+
+	// registers are at their defaults again, nothing cached from before holds
+	this->g_fsr = GYRO_FSR_NOT_SET;
+	this->a_fsr = ACCEL_FSR_NOT_SET;
+	this->lpf = LPF_NOT_SET;
+	this->sample_rate = -1;
+
+	// reset analog devices
+	if (this->spi_write(this->REGISTERS.SIGNAL_PATH_RESET, 0x07))
+		return HAL_ERROR;
+	HAL_Delay(100);
+
+	// wake up, set clock source PLL with X gyro axis (auto select on ICM-20602)
+	if (this->spi_write(this->REGISTERS.PWR_MGMT_1, 0x01))
+		return HAL_ERROR;
+
+	HAL_Delay(50);
+
+	// check SPI connection and tell the sensors apart
+	uint8_t who_am_i;
+	if (this->spi_read(this->REGISTERS.WHO_AM_I, &who_am_i, 1))
+		return HAL_ERROR;
+
+	if (who_am_i == this->WHO_AM_I_MPU6000) {
+		this->device = DEVICE_MPU6000;
+		this->temp_scale = this->MPU6000_TEMP_SCALE;
+		this->temp_offset = this->MPU6000_TEMP_OFFSET;
+	}
+	else if (who_am_i == this->WHO_AM_I_ICM20602) {
+		this->device = DEVICE_ICM20602;
+		this->temp_scale = this->ICM20602_TEMP_SCALE;
+		this->temp_offset = this->ICM20602_TEMP_OFFSET;
+	}
+	else {
+		this->device = DEVICE_UNKNOWN;
+		return HAL_ERROR;
+	}
+
+	// disable I2C interface, it could take SPI traffic for its own
+	if (this->device == DEVICE_MPU6000) {
+		if (this->spi_write(this->REGISTERS.USER_CTRL, 0x10))
+			return HAL_ERROR;
+	}
+	else if (this->spi_write(this->REGISTERS.I2C_IF, 0x40))
+		return HAL_ERROR;
+
+	// do not disable any sensor
+	if (this->spi_write(this->REGISTERS.PWR_MGMT_2, 0x00))
+		return HAL_ERROR;
+
+	// disable interrupt
+	if (this->set_interrupt(false))
+		return HAL_ERROR;
+
+	// set INT pin active high, push-pull, 50 us pulse
+	if (this->spi_write(this->REGISTERS.INT_PIN_CFG, 0x00))
+		return HAL_ERROR;
+
+	// set gyro full scale range
+	if (this->set_gyro_fsr(GYRO_FSR_2000))
+		return HAL_ERROR;
+
+	// set accel full scale range
+	if (this->set_accel_fsr(ACCEL_FSR_16))
+		return HAL_ERROR;
+
+	// set low pass filter to 188 Hz (both acc and gyro sample at 1 kHz)
+	if (this->set_lpf(LPF_188HZ))
+		return HAL_ERROR;
+
+	// set sample rate to 1 kHz
+	if (this->set_sample_rate(1000))
+		return HAL_ERROR;
+
+	if (this->set_interrupt(true))
+		return HAL_ERROR;
+
+	this->start_ticks = Timer::Get_Tick_Count();
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef MPU6000::set_gyro_fsr(gyro_fsr fsr) {
+	if (fsr == GYRO_FSR_NOT_SET)
+		return HAL_ERROR;
+
+	if (this->g_fsr == fsr)
+		return HAL_OK;
+
+	if (this->spi_write(this->REGISTERS.GYRO_CONFIG, fsr) == HAL_OK) {
+		this->set_gyro_range(fsr);
+
+		return HAL_OK;
+	}
+
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef MPU6000::set_accel_fsr(accel_fsr fsr) {
+	if (fsr == ACCEL_FSR_NOT_SET)
+		return HAL_ERROR;
+
+	if (this->a_fsr == fsr)
+		return HAL_OK;
+
+	if (this->spi_write(this->REGISTERS.ACCEL_CONFIG, fsr) == HAL_OK) {
+		this->set_accel_range(fsr);
+
+		return HAL_OK;
+	}
+
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef MPU6000::set_lpf(lpf_bandwidth lpf) {
+	if (this->lpf == lpf)
+		return HAL_OK;
+
+	if (this->spi_write(this->REGISTERS.CONFIG, lpf) == HAL_OK) {
+		this->lpf = lpf;
+		return HAL_OK;
+	}
+
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef MPU6000::set_sample_rate(uint16_t rate) {
+	if (this->sample_rate == rate)
+		return HAL_OK;
+
+	// gyro output rate is 8 kHz with DLPF disabled, 1 kHz otherwise
+	uint16_t gyro_rate = (this->lpf == LPF_256HZ) ? 8000 : 1000;
+
+	if (rate == 0 || rate > gyro_rate || gyro_rate / rate > 256)
+		return HAL_ERROR;
+
+	uint8_t val = gyro_rate / rate - 1;
+
+	if (this->spi_write(this->REGISTERS.SMPRT_DIV, val) == HAL_OK) {
+		this->sample_rate = rate;
+		return HAL_OK;
+	}
+
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef MPU6000::set_interrupt(bool enable) {
+	return this->spi_write(this->REGISTERS.INT_ENABLE, enable ? 0x01 : 0x00);
+}
+
+HAL_StatusTypeDef MPU6000::read_output(uint8_t *data) {
+	return this->spi_read(this->REGISTERS.ACCEL_XOUT_H, data, this->SAMPLE_SIZE);
+}
+
+HAL_StatusTypeDef MPU6000::Set_Sample_Rate(uint16_t rate) {
+	if (this->set_lpf(rate > 1000 ? LPF_256HZ : LPF_188HZ))
+		return HAL_ERROR;
+
+	return this->set_sample_rate(rate);
+}
+
+// 15 bytes take 11 us at the fast clock
+HAL_StatusTypeDef MPU6000::Start_Read() {
+	if (this->state != READ_IDLE || HAL_SPI_GetState(&this->hspi) != HAL_SPI_STATE_READY)
+		return HAL_BUSY;
+
+	this->data_ready_ticks = this->capture_ticks();
+
+	this->spi_set_speed(this->SPI_FAST_PRESCALER);
+
+	this->state = READ_SAMPLE;
+	this->spi_select(true);
+
+	HAL_StatusTypeDef status = HAL_SPI_TransmitReceive_DMA(&this->hspi, this->tx_buffer, this->rx_buffer, sizeof(this->rx_buffer));
+
+	if (status != HAL_OK) {
+		this->spi_select(false);
+		this->state = READ_IDLE;
+	}
+
+	return status;
+}
+
+bool MPU6000::Store_Sample() {
+	Sample sample;
+
+	if (this->state != READ_SAMPLE)
+		return false;
+
+	this->spi_select(false);
+
+	this->parse_sample(this->rx_buffer + 1, sample);
+	sample.timestamp = this->data_ready_ticks;
+
+	this->state = READ_IDLE;
+
+	return this->push_sample(sample);
+}
+
+} /* namespace flyhero */
@@ -10,44 +10,50 @@
 
 namespace flyhero {
 
+// vectors follow IMU_I2C and IMU_DMA in Config.h
+extern "C" {
+	void DMA1_Stream5_IRQHandler(void)
+	{
+		HAL_DMA_IRQHandler(MPU6050::Instance().Get_DMA_Rx_Handle());
+	}
+
+	void I2C1_EV_IRQHandler(void)
+	{
+		HAL_I2C_EV_IRQHandler(MPU6050::Instance().Get_I2C_Handle());
+	}
+
+	void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+		// FIFO count read only chains the data read
+		if (!MPU6050::Instance().Store_Sample())
+			return;
+
+		if (MPU6050::Instance().Data_Read_Callback != NULL)
+			MPU6050::Instance().Data_Read_Callback();
+	}
+}
+
 MPU6050& MPU6050::Instance() {
 	static MPU6050 instance;
 
 	return instance;
 }
 
-MPU6050::MPU6050()
-	: accel_x_filter(Biquad_Filter::FILTER_LOW_PASS, 1000, 10)
-	, accel_y_filter(Biquad_Filter::FILTER_LOW_PASS, 1000, 10)
-	, accel_z_filter(Biquad_Filter::FILTER_LOW_PASS, 1000, 10)
-	, gyro_x_filter(Biquad_Filter::FILTER_LOW_PASS, 1000, 60)
-	, gyro_y_filter(Biquad_Filter::FILTER_LOW_PASS, 1000, 60)
-	, gyro_z_filter(Biquad_Filter::FILTER_LOW_PASS, 1000, 60)
-{
-	this->g_fsr = GYRO_FSR_NOT_SET;
-	this->g_mult = 0;
-	this->a_mult = 0;
-	this->a_fsr = ACCEL_FSR_NOT_SET;
+MPU6050::MPU6050() {
 	this->lpf = LPF_NOT_SET;
-	this->sample_rate = -1;
-	this->roll = 0;
-	this->pitch = 0;
-	this->yaw = 0;
-	this->start_ticks = 0;
-	this->data_ready_ticks = 0;
-	this->delta_t = 0;
-	this->Data_Ready_Callback = NULL;
-	this->Data_Read_Callback = NULL;
-	this->quaternion.q0 = 1;
-	this->quaternion.q1 = 0;
-	this->quaternion.q2 = 0;
-	this->quaternion.q3 = 0;
-	this->raw_temp = 0;
-	this->mahony_Kp = 2;
-	this->mahony_Ki = 0.1f;
-	this->mahony_integral.x = 0;
-	this->mahony_integral.y = 0;
-	this->mahony_integral.z = 0;
+	this->temp_scale = this->TEMP_SCALE;
+	this->temp_offset = this->TEMP_OFFSET;
+	this->fifo_mode = false;
+	this->fifo_reset_pending = false;
+	this->state = READ_IDLE;
+	this->fifo_samples = 0;
+	this->fifo_burst = 0;
+	this->fifo_read_ticks = 0;
+	this->fifo_timestamp = 0;
+	this->fifo_synced = false;
+	this->fifo_overflows = 0;
+	this->dmp_firmware = NULL;
+	this->dmp_mode = false;
+	this->dmp_reads = 0;
 }
 
 DMA_HandleTypeDef* MPU6050::Get_DMA_Rx_Handle() {
@@ -115,7 +121,7 @@ void MPU6050::i2c_reset_bus() {
 	}*/
 
 	// 12. Configure the SCL and SDA I/Os as Alternate function Open-Drain
-	switch (uint32_t(IMU_I2C)) {
+	switch ((uintptr_t)IMU_I2C) {
 	case I2C1_BASE:
 		GPIO_InitStructure.Alternate    = GPIO_AF4_I2C1;
 		break;
@@ -149,7 +155,7 @@ void MPU6050::i2c_reset_bus() {
 
 HAL_StatusTypeDef MPU6050::i2c_init() {
 	// enable SCL GPIO base clock
-	switch ((uint32_t)IMU_SCL_BASE) {
+	switch ((uintptr_t)IMU_SCL_BASE) {
 	case GPIOA_BASE:
 		if (__GPIOA_IS_CLK_DISABLED())
 			__GPIOA_CLK_ENABLE();
@@ -185,7 +191,7 @@ HAL_StatusTypeDef MPU6050::i2c_init() {
 	}
 
 	// enable SDA GPIO base clock
-	switch ((uint32_t)IMU_SDA_BASE) {
+	switch ((uintptr_t)IMU_SDA_BASE) {
 	case GPIOA_BASE:
 		if (__GPIOA_IS_CLK_DISABLED())
 			__GPIOA_CLK_ENABLE();
@@ -221,7 +227,7 @@ HAL_StatusTypeDef MPU6050::i2c_init() {
 	}
 
 	// enable I2C clock
-	switch ((uint32_t)IMU_I2C) {
+	switch ((uintptr_t)IMU_I2C) {
 	case I2C1_BASE:
 		if (__I2C1_IS_CLK_DISABLED())
 			__I2C1_CLK_ENABLE();
@@ -237,7 +243,7 @@ HAL_StatusTypeDef MPU6050::i2c_init() {
 	}
 
 	// enable DMA clock
-	switch ((uint32_t)IMU_DMA) {
+	switch ((uintptr_t)IMU_DMA) {
 	case DMA1_Stream0_BASE:
 	case DMA1_Stream1_BASE:
 	case DMA1_Stream2_BASE:
@@ -289,7 +295,7 @@ HAL_StatusTypeDef MPU6050::i2c_init() {
 
 	__HAL_LINKDMA(&this->hi2c, hdmarx, this->hdma_i2c_rx);
 
-	switch ((uint32_t)IMU_DMA) {
+	switch ((uintptr_t)IMU_DMA) {
 	case DMA1_Stream0_BASE:
 		HAL_NVIC_SetPriority(DMA1_Stream0_IRQn, 2, 0);
 		HAL_NVIC_EnableIRQ(DMA1_Stream0_IRQn);
@@ -356,7 +362,7 @@ HAL_StatusTypeDef MPU6050::i2c_init() {
 		break;
 	}
 
-	switch ((uint32_t)IMU_I2C) {
+	switch ((uintptr_t)IMU_I2C) {
 	case I2C1_BASE:
 		HAL_NVIC_SetPriority(I2C1_EV_IRQn, 1, 0);
 		HAL_NVIC_EnableIRQ(I2C1_EV_IRQn);
@@ -374,92 +380,11 @@ HAL_StatusTypeDef MPU6050::i2c_init() {
 	return HAL_OK;
 }
 
-void MPU6050::int_init() {
-	switch ((uint32_t)IMU_INT_BASE) {
-	case GPIOA_BASE:
-		if (__GPIOA_IS_CLK_DISABLED())
-			__GPIOA_CLK_ENABLE();
-		break;
-	case GPIOB_BASE:
-		if (__GPIOB_IS_CLK_DISABLED())
-			__GPIOB_CLK_ENABLE();
-		break;
-	case GPIOC_BASE:
-		if (__GPIOC_IS_CLK_DISABLED())
-			__GPIOC_CLK_ENABLE();
-		break;
-	case GPIOD_BASE:
-		if (__GPIOD_IS_CLK_DISABLED())
-			__GPIOD_CLK_ENABLE();
-		break;
-	case GPIOE_BASE:
-		if (__GPIOE_IS_CLK_DISABLED())
-			__GPIOE_CLK_ENABLE();
-		break;
-	case GPIOF_BASE:
-		if (__GPIOF_IS_CLK_DISABLED())
-			__GPIOF_CLK_ENABLE();
-		break;
-	case GPIOG_BASE:
-		if (__GPIOG_IS_CLK_DISABLED())
-			__GPIOG_CLK_ENABLE();
-		break;
-	case GPIOH_BASE:
-		if (__GPIOH_IS_CLK_DISABLED())
-			__GPIOH_CLK_ENABLE();
-		break;
-	}
-
-	GPIO_InitTypeDef exti;
-
-	exti.Pin = IMU_INT_PIN;
-	exti.Mode = GPIO_MODE_IT_RISING;
-	exti.Pull = GPIO_NOPULL;
-	exti.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
-	HAL_GPIO_Init(IMU_INT_BASE, &exti);
-
-	switch (IMU_INT_PIN) {
-	case GPIO_PIN_0:
-		HAL_NVIC_SetPriority(EXTI0_IRQn, 2, 0);
-		HAL_NVIC_EnableIRQ(EXTI0_IRQn);
-		break;
-	case GPIO_PIN_1:
-		HAL_NVIC_SetPriority(EXTI1_IRQn, 2, 0);
-		HAL_NVIC_EnableIRQ(EXTI1_IRQn);
-		break;
-	case GPIO_PIN_2:
-		HAL_NVIC_SetPriority(EXTI2_IRQn, 2, 0);
-		HAL_NVIC_EnableIRQ(EXTI2_IRQn);
-		break;
-	case GPIO_PIN_3:
-		HAL_NVIC_SetPriority(EXTI3_IRQn, 2, 0);
-		HAL_NVIC_EnableIRQ(EXTI3_IRQn);
-		break;
-	case GPIO_PIN_4:
-		HAL_NVIC_SetPriority(EXTI4_IRQn, 2, 0);
-		HAL_NVIC_EnableIRQ(EXTI4_IRQn);
-		break;
-	case GPIO_PIN_5:
-	case GPIO_PIN_6:
-	case GPIO_PIN_7:
-	case GPIO_PIN_8:
-	case GPIO_PIN_9:
-		HAL_NVIC_SetPriority(EXTI9_5_IRQn, 2, 0);
-		HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
-		break;
-	case GPIO_PIN_10:
-	case GPIO_PIN_11:
-	case GPIO_PIN_12:
-	case GPIO_PIN_13:
-	case GPIO_PIN_14:
-	case GPIO_PIN_15:
-		HAL_NVIC_SetPriority(EXTI15_10_IRQn, 2, 0);
-		HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
-		break;
-	}
+HAL_StatusTypeDef MPU6050::Init() {
+	return this->Init(NULL);
 }
 
-HAL_StatusTypeDef MPU6050::Init() {
+HAL_StatusTypeDef MPU6050::Init(const DMP_Firmware *dmp_firmware) {
 	uint8_t tmp;
 
 	// init I2C bus including DMA peripheral
@@ -478,6 +403,15 @@ HAL_StatusTypeDef MPU6050::Init() {
 		this->i2c_read(this->REGISTERS.PWR_MGMT_1, &tmp);
 	} while (tmp & 0x80);
 
+	// registers are at their defaults again, nothing cached from before holds
+	this->g_fsr = GYRO_FSR_NOT_SET;
+	this->a_fsr = ACCEL_FSR_NOT_SET;
+	this->lpf = LPF_NOT_SET;
+	this->sample_rate = -1;
+	this->fifo_mode = false;
+	this->dmp_firmware = NULL;
+	this->dmp_mode = false;
+
 	// reset analog devices - should not be needed
 	if (this->i2c_write(this->REGISTERS.SIGNAL_PATH_RESET, 0x07))
 		return HAL_ERROR;
@@ -529,6 +463,10 @@ HAL_StatusTypeDef MPU6050::Init() {
 	if (this->set_sample_rate(1000))
 		return HAL_ERROR;
 
+	// DMP runs only after Set_DMP_Mode()
+	if (dmp_firmware != NULL && this->dmp_load(dmp_firmware))
+		return HAL_ERROR;
+
 	if (this->set_interrupt(true))
 		return HAL_ERROR;
 
@@ -545,26 +483,7 @@ HAL_StatusTypeDef MPU6050::set_gyro_fsr(gyro_fsr fsr) {
 		return HAL_OK;
 
 	if (this->i2c_write(this->REGISTERS.GYRO_CONFIG, fsr) == HAL_OK) {
-		this->g_fsr = fsr;
-
-		switch (this->g_fsr) {
-		case GYRO_FSR_250:
-			this->g_mult = 250;
-			break;
-		case GYRO_FSR_500:
-			this->g_mult = 500;
-			break;
-		case GYRO_FSR_1000:
-			this->g_mult = 1000;
-			break;
-		case GYRO_FSR_2000:
-			this->g_mult = 2000;
-			break;
-		case GYRO_FSR_NOT_SET:
-			return HAL_ERROR;
-		}
-
-		this->g_mult /= pow(2, this->ADC_BITS - 1);
+		this->set_gyro_range(fsr);
 
 		return HAL_OK;
 	}
@@ -580,26 +499,7 @@ HAL_StatusTypeDef MPU6050::set_accel_fsr(accel_fsr fsr) {
 		return HAL_OK;
 
 	if (this->i2c_write(this->REGISTERS.ACCEL_CONFIG, fsr) == HAL_OK) {
-		this->a_fsr = fsr;
-
-		switch (this->a_fsr) {
-		case ACCEL_FSR_2:
-			this->a_mult = 2;
-			break;
-		case ACCEL_FSR_4:
-			this->a_mult = 4;
-			break;
-		case ACCEL_FSR_8:
-			this->a_mult = 8;
-			break;
-		case ACCEL_FSR_16:
-			this->a_mult = 16;
-			break;
-		case ACCEL_FSR_NOT_SET:
-			return HAL_ERROR;
-		}
-
-		this->a_mult /= pow(2, this->ADC_BITS - 1);
+		this->set_accel_range(fsr);
 
 		return HAL_OK;
 	}
@@ -623,7 +523,13 @@ HAL_StatusTypeDef MPU6050::set_sample_rate(uint16_t rate) {
 	if (this->sample_rate == rate)
 		return HAL_OK;
 
-	uint8_t val = (1000 - rate) / rate;
+	// gyro output rate is 8 kHz with DLPF disabled, 1 kHz otherwise
+	uint16_t gyro_rate = (this->lpf == LPF_256HZ) ? 8000 : 1000;
+
+	if (rate == 0 || rate > gyro_rate || gyro_rate / rate > 256)
+		return HAL_ERROR;
+
+	uint8_t val = gyro_rate / rate - 1;
 
 	if (this->i2c_write(this->REGISTERS.SMPRT_DIV, val) == HAL_OK) {
 		this->sample_rate = rate;
@@ -637,380 +543,378 @@ HAL_StatusTypeDef MPU6050::set_interrupt(bool enable) {
 	return this->i2c_write(this->REGISTERS.INT_ENABLE, enable ? 0x01 : 0x00);
 }
 
-HAL_StatusTypeDef MPU6050::i2c_write(uint8_t reg, uint8_t data) {
-	return HAL_I2C_Mem_Write(&this->hi2c, this->I2C_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, &data, 1, this->I2C_TIMEOUT);
-}
+// FIFO_RESET works only while FIFO is disabled
+HAL_StatusTypeDef MPU6050::fifo_reset() {
+	// keep I2C master setting from Init() and DMP running
+	uint8_t user_ctrl = this->dmp_mode ? 0xA0 : 0x20;
 
-HAL_StatusTypeDef MPU6050::i2c_write(uint8_t reg, uint8_t *data, uint8_t data_size) {
-	return HAL_I2C_Mem_Write(&this->hi2c, this->I2C_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, data, data_size, this->I2C_TIMEOUT);
-}
+	if (this->i2c_write(this->REGISTERS.USER_CTRL, user_ctrl))
+		return HAL_ERROR;
 
-HAL_StatusTypeDef MPU6050::i2c_read(uint8_t reg, uint8_t *data) {
-	return HAL_I2C_Mem_Read(&this->hi2c, this->I2C_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, data, 1, this->I2C_TIMEOUT);
+	if (this->i2c_write(this->REGISTERS.USER_CTRL, user_ctrl | 0x04))
+		return HAL_ERROR;
+
+	if (this->i2c_write(this->REGISTERS.USER_CTRL, user_ctrl | 0x40))
+		return HAL_ERROR;
+
+	this->fifo_synced = false;
+	this->fifo_reset_pending = false;
+
+	return HAL_OK;
 }
 
-HAL_StatusTypeDef MPU6050::i2c_read(uint8_t reg, uint8_t *data, uint8_t data_size) {
-	return HAL_I2C_Mem_Read(&this->hi2c, this->I2C_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, data, data_size, this->I2C_TIMEOUT);
+uint8_t MPU6050::fifo_packet_size() {
+	return this->dmp_mode ? this->DMP_PACKET_SIZE : this->SAMPLE_SIZE;
 }
 
-HAL_StatusTypeDef MPU6050::Start_Read() {
-	if (this->data_ready_ticks != 0)
-		this->delta_t = (Timer::Get_Tick_Count() - this->data_ready_ticks) * 0.000001;
-	this->data_ready_ticks = Timer::Get_Tick_Count();
+// DMP memory is accessed in banks, a transfer must not cross them.
+// Every chunk is read back, the DMP would run garbage otherwise.
+HAL_StatusTypeDef MPU6050::dmp_memory(uint16_t address, const uint8_t *data, uint16_t size) {
+	uint8_t chunk[DMP_CHUNK_SIZE];
+	uint8_t verify[DMP_CHUNK_SIZE];
+
+	while (size > 0) {
+		uint16_t bank_left = this->DMP_BANK_SIZE - (address % this->DMP_BANK_SIZE);
+		uint8_t length = size < this->DMP_CHUNK_SIZE ? size : this->DMP_CHUNK_SIZE;
+
+		if (length > bank_left)
+			length = bank_left;
+
+		for (uint8_t i = 0; i < length; i++)
+			chunk[i] = data[i];
+
+		for (uint8_t pass = 0; pass < 2; pass++) {
+			if (this->i2c_write(this->REGISTERS.BANK_SEL, address >> 8))
+				return HAL_ERROR;
+
+			if (this->i2c_write(this->REGISTERS.MEM_START_ADDR, address & 0xFF))
+				return HAL_ERROR;
+
+			if (pass == 0 && this->i2c_write(this->REGISTERS.MEM_R_W, chunk, length))
+				return HAL_ERROR;
+
+			if (pass == 1 && this->i2c_read(this->REGISTERS.MEM_R_W, verify, length))
+				return HAL_ERROR;
+		}
+
+		for (uint8_t i = 0; i < length; i++) {
+			if (verify[i] != chunk[i])
+				return HAL_ERROR;
+		}
+
+		address += length;
+		data += length;
+		size -= length;
+	}
 
-	return HAL_I2C_Mem_Read_DMA(&this->hi2c, this->I2C_ADDRESS, this->REGISTERS.ACCEL_XOUT_H, I2C_MEMADD_SIZE_8BIT, this->data_buffer, 14);
+	return HAL_OK;
 }
 
-void MPU6050::Complete_Read() {
-	this->raw_accel.x = (this->data_buffer[0] << 8) | this->data_buffer[1];
-	this->raw_accel.y = (this->data_buffer[2] << 8) | this->data_buffer[3];
-	this->raw_accel.z = (this->data_buffer[4] << 8) | this->data_buffer[5];
+HAL_StatusTypeDef MPU6050::dmp_load(const DMP_Firmware *firmware) {
+	if (firmware->image == NULL || firmware->rate == 0)
+		return HAL_ERROR;
+
+	if (this->dmp_memory(0, firmware->image, firmware->size))
+		return HAL_ERROR;
+
+	uint8_t start[2] = { uint8_t(firmware->start_address >> 8), uint8_t(firmware->start_address & 0xFF) };
 
-	this->raw_temp = (this->data_buffer[6] << 8) | this->data_buffer[7];
+	if (this->i2c_write(this->REGISTERS.PRGM_START_H, start, 2))
+		return HAL_ERROR;
+
+	for (uint8_t i = 0; i < firmware->patch_count; i++) {
+		const DMP_Patch& patch = firmware->patches[i];
+
+		if (this->dmp_memory(patch.address, patch.data, patch.size))
+			return HAL_ERROR;
+	}
 
-	this->raw_gyro.x = (this->data_buffer[8] << 8) | this->data_buffer[9];
-	this->raw_gyro.y = (this->data_buffer[10] << 8) | this->data_buffer[11];
-	this->raw_gyro.z = (this->data_buffer[12] << 8) | this->data_buffer[13];
+	this->dmp_firmware = firmware;
 
-	this->accel.x = this->accel_x_filter.Apply_Filter((this->raw_accel.x + this->accel_offsets[0]) * this->a_mult);
-	this->accel.y = this->accel_y_filter.Apply_Filter((this->raw_accel.y + this->accel_offsets[1]) * this->a_mult);
-	this->accel.z = this->accel_z_filter.Apply_Filter((this->raw_accel.z + this->accel_offsets[2]) * this->a_mult);
+	return HAL_OK;
+}
 
-	this->gyro.x = this->gyro_x_filter.Apply_Filter((this->raw_gyro.x + this->gyro_offsets[0]) * this->g_mult);
-	this->gyro.y = this->gyro_y_filter.Apply_Filter((this->raw_gyro.y + this->gyro_offsets[1]) * this->g_mult);
-	this->gyro.z = this->gyro_z_filter.Apply_Filter((this->raw_gyro.z + this->gyro_offsets[2]) * this->g_mult);
+HAL_StatusTypeDef MPU6050::i2c_write(uint8_t reg, uint8_t data) {
+	return HAL_I2C_Mem_Write(&this->hi2c, this->I2C_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, &data, 1, this->I2C_TIMEOUT);
 }
 
-void MPU6050::Get_Raw_Accel(Raw_Data& raw_accel) {
-	raw_accel = this->raw_accel;
+HAL_StatusTypeDef MPU6050::i2c_write(uint8_t reg, uint8_t *data, uint8_t data_size) {
+	return HAL_I2C_Mem_Write(&this->hi2c, this->I2C_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, data, data_size, this->I2C_TIMEOUT);
 }
 
-void MPU6050::Get_Raw_Gyro(Raw_Data& raw_gyro) {
-	raw_gyro = this->raw_gyro;
+HAL_StatusTypeDef MPU6050::i2c_read(uint8_t reg, uint8_t *data) {
+	return HAL_I2C_Mem_Read(&this->hi2c, this->I2C_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, data, 1, this->I2C_TIMEOUT);
 }
 
-void MPU6050::Get_Raw_Temp(int16_t& raw_temp) {
-	raw_temp = this->raw_temp;
+HAL_StatusTypeDef MPU6050::i2c_read(uint8_t reg, uint8_t *data, uint8_t data_size) {
+	return HAL_I2C_Mem_Read(&this->hi2c, this->I2C_ADDRESS, reg, I2C_MEMADD_SIZE_8BIT, data, data_size, this->I2C_TIMEOUT);
 }
 
-void MPU6050::Get_Accel(Sensor_Data& accel) {
-	accel = this->accel;
+HAL_StatusTypeDef MPU6050::read_output(uint8_t *data) {
+	return this->i2c_read(this->REGISTERS.ACCEL_XOUT_H, data, this->SAMPLE_SIZE);
 }
 
-void MPU6050::Get_Gyro(Sensor_Data& gyro) {
-	gyro = this->gyro;
+HAL_StatusTypeDef MPU6050::Set_Sample_Rate(uint16_t rate) {
+	if (this->set_lpf(rate > 1000 ? LPF_256HZ : LPF_188HZ))
+		return HAL_ERROR;
+
+	return this->set_sample_rate(rate);
 }
 
-HAL_StatusTypeDef MPU6050::Read_Raw(Raw_Data& accel, Raw_Data& gyro) {
-	uint8_t tmp[14];
+// Sensor buffers samples and Start_Read() takes all of them in one burst, it has
+// to be called periodically instead of from data ready interrupt which is off.
+// Calibrate() before enabling, it polls output registers.
+HAL_StatusTypeDef MPU6050::Set_FIFO_Mode(bool enable) {
+	if (this->state != READ_IDLE)
+		return HAL_BUSY;
 
-	if (HAL_I2C_Mem_Read(&this->hi2c, this->I2C_ADDRESS, this->REGISTERS.ACCEL_XOUT_H, I2C_MEMADD_SIZE_8BIT, tmp, 14, this->I2C_TIMEOUT))
+	// FIFO belongs to DMP then
+	if (this->dmp_mode)
 		return HAL_ERROR;
 
-	accel.x = (tmp[0] << 8) | tmp[1];
-	accel.y = (tmp[2] << 8) | tmp[3];
-	accel.z = (tmp[4] << 8) | tmp[5];
+	if (enable) {
+		if (this->set_interrupt(false))
+			return HAL_ERROR;
 
-	gyro.x = (tmp[8] << 8) | tmp[9];
-	gyro.y = (tmp[10] << 8) | tmp[11];
-	gyro.z = (tmp[12] << 8) | tmp[13];
+		// temp, gyro x, y, z and accel
+		if (this->i2c_write(this->REGISTERS.FIFO_EN, 0xF8))
+			return HAL_ERROR;
 
-	return HAL_OK;
-}
+		if (this->fifo_reset())
+			return HAL_ERROR;
+	}
+	else {
+		if (this->i2c_write(this->REGISTERS.FIFO_EN, 0x00))
+			return HAL_ERROR;
+
+		if (this->i2c_write(this->REGISTERS.USER_CTRL, 0x20))
+			return HAL_ERROR;
 
-HAL_StatusTypeDef MPU6050::Calibrate() {
-	gyro_fsr prev_g_fsr = this->g_fsr;
-	accel_fsr prev_a_fsr = this->a_fsr;
+		if (this->set_interrupt(true))
+			return HAL_ERROR;
+	}
 
-	this->set_gyro_fsr(GYRO_FSR_1000);
-	this->set_accel_fsr(ACCEL_FSR_16);
+	this->fifo_mode = enable;
 
-	// wait until internal sensor calibration done
-	//while (Timer::Get_Tick_Count() - this->start_ticks < 40000000);
+	return HAL_OK;
+}
 
-	uint8_t offset_data[6] = { 0x00 };
+bool MPU6050::Get_FIFO_Mode() {
+	return this->fifo_mode;
+}
 
-	// gyro offsets should be already zeroed
-	// for accel we need to read factory values and preserve bit 0 of LSB for each axis
-	// http://www.digikey.com/en/pdf/i/invensense/mpu-hardware-offset-registers
-	this->i2c_read(this->REGISTERS.ACCEL_X_OFFSET, offset_data, 6);
+// FIFO was found full or misaligned, samples were dropped
+uint32_t MPU6050::Get_FIFO_Overflows() {
+	return this->fifo_overflows;
+}
 
-	int16_t accel_offsets[3];
-	accel_offsets[0] = (offset_data[0] << 8) | offset_data[1];
-	accel_offsets[1] = (offset_data[2] << 8) | offset_data[3];
-	accel_offsets[2] = (offset_data[4] << 8) | offset_data[5];
+// DMP computes attitude from raw samples in the sensor and pushes quaternions
+// into FIFO. Raw samples are still read one by one for the rate loop, every
+// few reads the DMA chain continues with the FIFO so no extra interrupt is needed.
+// Requires firmware passed to Init() and the sample rate set before.
+HAL_StatusTypeDef MPU6050::Set_DMP_Mode(bool enable) {
+	if (this->state != READ_IDLE)
+		return HAL_BUSY;
 
-	int32_t offsets[6] = { 0 };
-	Raw_Data gyro, accel;
+	if (this->fifo_mode || (enable && this->dmp_firmware == NULL))
+		return HAL_ERROR;
 
-	// we want accel Z to be 2048 (+ 1g)
+	// no raw samples in FIFO
+	if (this->i2c_write(this->REGISTERS.FIFO_EN, 0x00))
+		return HAL_ERROR;
 
-	for (uint16_t i = 0; i < 500; i++) {
-		this->Read_Raw(accel, gyro);
+	if (enable) {
+		// DMP_RESET and FIFO_RESET while both are disabled
+		if (this->i2c_write(this->REGISTERS.USER_CTRL, 0x20))
+			return HAL_ERROR;
 
-		offsets[0] += accel.x;
-		offsets[1] += accel.y;
-		offsets[2] += accel.z - 2048;
-		offsets[3] += gyro.x;
-		offsets[4] += gyro.y;
-		offsets[5] += gyro.z;
-	}
+		if (this->i2c_write(this->REGISTERS.USER_CTRL, 0x2C))
+			return HAL_ERROR;
 
-	int16_t gyro_x, gyro_y, gyro_z, accel_x, accel_y, accel_z;
-	accel_x = -offsets[0] / 500;
-	accel_y = -offsets[1] / 500;
-	accel_z = -offsets[2] / 500;
-	gyro_x = -offsets[3] / 500;
-	gyro_y = -offsets[4] / 500;
-	gyro_z = -offsets[5] / 500;
-
-	accel_offsets[0] += accel_x;
-	accel_offsets[1] += accel_y;
-	accel_offsets[2] += accel_z;
-
-	if (offset_data[1] & 0x01)
-		accel_offsets[0] |= 0x01;
-	else
-		accel_offsets[0] &= 0xFFFE;
-
-	if (offset_data[3] & 0x01)
-		accel_offsets[1] |= 0x01;
-	else
-		accel_offsets[1] &= 0xFFFE;
-
-	if (offset_data[5] & 0x01)
-		accel_offsets[2] |= 0x01;
-	else
-		accel_offsets[2] &= 0xFFFE;
-
-	offset_data[0] = accel_offsets[0] >> 8;
-	offset_data[1] = accel_offsets[0] & 0xFF;
-	offset_data[2] = accel_offsets[1] >> 8;
-	offset_data[3] = accel_offsets[1] & 0xFF;
-	offset_data[4] = accel_offsets[2] >> 8;
-	offset_data[5] = accel_offsets[2] & 0xFF;
-
-	this->i2c_write(this->REGISTERS.ACCEL_X_OFFSET, offset_data, 6);
-
-	offset_data[0] = gyro_x >> 8;
-	offset_data[1] = gyro_x & 0xFF;
-	offset_data[2] = gyro_y >> 8;
-	offset_data[3] = gyro_y & 0xFF;
-	offset_data[4] = gyro_z >> 8;
-	offset_data[5] = gyro_z & 0xFF;
-
-	this->i2c_write(this->REGISTERS.GYRO_X_OFFSET, offset_data, 6);
-
-	// set gyro & accel FSR to its original value
-	this->set_gyro_fsr(prev_g_fsr);
-	this->set_accel_fsr(prev_a_fsr);
-
-	Timer::Delay_ms(5000);
-
-	// lets measure offsets again to be applied on STM
-	this->accel_offsets[0] = this->accel_offsets[1] = this->accel_offsets[2] = 0;
-	this->gyro_offsets[0] = this->gyro_offsets[1] = this->gyro_offsets[2] = 0;
-
-	for (uint16_t i = 0; i < 500; i++) {
-		this->Read_Raw(accel, gyro);
-
-		this->accel_offsets[0] += accel.x;
-		this->accel_offsets[1] += accel.y;
-		this->accel_offsets[2] += accel.z - 2048;
-		this->gyro_offsets[0] += gyro.x;
-		this->gyro_offsets[1] += gyro.y;
-		this->gyro_offsets[2] += gyro.z;
+		if (this->i2c_write(this->REGISTERS.USER_CTRL, 0xE0))
+			return HAL_ERROR;
 	}
+	else if (this->i2c_write(this->REGISTERS.USER_CTRL, 0x20))
+		return HAL_ERROR;
 
-	this->accel_offsets[0] /= -500;
-	this->accel_offsets[1] /= -500;
-	this->accel_offsets[2] /= -500;
-	this->gyro_offsets[0] /= -500;
-	this->gyro_offsets[1] /= -500;
-	this->gyro_offsets[2] /= -500;
+	this->dmp_mode = enable;
+	this->dmp_reads = 0;
+	this->fifo_reset_pending = false;
+	this->fifo_synced = false;
 
 	return HAL_OK;
 }
 
-void MPU6050::Compute_Euler() {
-	// 70 us
-	float accel_roll = this->atan2(this->accel.y, this->accel.z);
+bool MPU6050::Get_DMP_Mode() {
+	return this->dmp_mode;
+}
 
-	// 70 us
-	float accel_pitch = this->atan2(-this->accel.x, std::sqrt((float)(this->accel.y * this->accel.y + this->accel.z * this->accel.z)));
+HAL_StatusTypeDef MPU6050::fifo_start_count_read() {
+	this->fifo_read_ticks = Timer::Get_Tick_Count();
+	this->state = READ_FIFO_COUNT;
 
-	// 13 us
-	this->roll = this->COMPLEMENTARY_COEFFICIENT * (this->roll + this->gyro.y * this->delta_t) + (1 - this->COMPLEMENTARY_COEFFICIENT) * accel_roll;
+	HAL_StatusTypeDef status = HAL_I2C_Mem_Read_DMA(&this->hi2c, this->I2C_ADDRESS, this->REGISTERS.FIFO_COUNT_H, I2C_MEMADD_SIZE_8BIT, this->data_buffer, 2);
 
-	// 13 us
-	this->pitch = this->COMPLEMENTARY_COEFFICIENT * (this->pitch + this->gyro.x * this->delta_t) + (1 - this->COMPLEMENTARY_COEFFICIENT) * accel_pitch;
+	if (status != HAL_OK)
+		this->state = READ_IDLE;
 
-	// 4 us
-	this->yaw += this->gyro.z * this->delta_t;
+	return status;
 }
 
-// http://x-io.co.uk/open-source-imu-and-ahrs-algorithms/
-void MPU6050::Compute_Mahony() {
-	float recip_norm;
+// in FIFO mode reads the count first, data follow from the DMA complete interrupt
+HAL_StatusTypeDef MPU6050::Start_Read() {
+	if (this->state != READ_IDLE)
+		return HAL_BUSY;
 
-	Sensor_Data gyro_rad;
-	gyro_rad.x = this->gyro.x * this->DEG_TO_RAD;
-	gyro_rad.y = this->gyro.y * this->DEG_TO_RAD;
-	gyro_rad.z = this->gyro.z * this->DEG_TO_RAD;
+	this->data_ready_ticks = this->capture_ticks();
 
-	Sensor_Data accel = this->accel;
-	Sensor_Data half_v, half_e;
+	// blocking, the FIFO is rarely lost
+	if (this->fifo_reset_pending && this->fifo_reset())
+		return HAL_ERROR;
 
-	// normalise accelerometer measurement
-	recip_norm = this->inv_sqrt(accel.x * accel.x + accel.y * accel.y + accel.z * accel.z);
-	accel.x *= recip_norm;
-	accel.y *= recip_norm;
-	accel.z *= recip_norm;
+	if (this->fifo_mode)
+		return this->fifo_start_count_read();
 
-	// estimated direction of gravity and vector perpendicular to magnetic flux
-	half_v.x = this->quaternion.q1 * this->quaternion.q3 - this->quaternion.q0 * this->quaternion.q2;
-	half_v.y = this->quaternion.q0 * this->quaternion.q1 + this->quaternion.q2 * this->quaternion.q3;
-	half_v.z = this->quaternion.q0 * this->quaternion.q0 - 0.5f + this->quaternion.q3 * this->quaternion.q3;
+	this->state = READ_SAMPLE;
 
-	// error is sum of cross product between estimated and measured direction of gravity
-	half_e.x = (accel.y * half_v.z - accel.z * half_v.y);
-	half_e.y = (accel.z * half_v.x - accel.x * half_v.z);
-	half_e.z = (accel.x * half_v.y - accel.y * half_v.x);
+	HAL_StatusTypeDef status = HAL_I2C_Mem_Read_DMA(&this->hi2c, this->I2C_ADDRESS, this->REGISTERS.ACCEL_XOUT_H, I2C_MEMADD_SIZE_8BIT, this->data_buffer, this->SAMPLE_SIZE);
 
-	if (this->mahony_Ki > 0) {
-		this->mahony_integral.x += 2 * this->mahony_Ki * half_e.x * 0.001f;
-		this->mahony_integral.y += 2 * this->mahony_Ki * half_e.y * 0.001f;
-		this->mahony_integral.z += 2 * this->mahony_Ki * half_e.z * 0.001f;
+	if (status != HAL_OK)
+		this->state = READ_IDLE;
 
-		gyro_rad.x += this->mahony_integral.x;
-		gyro_rad.y += this->mahony_integral.y;
-		gyro_rad.z += this->mahony_integral.z;
-	}
+	return status;
+}
+
+// returns true when the burst read was started
+bool MPU6050::fifo_count_read() {
+	uint16_t count = (this->data_buffer[0] << 8) | this->data_buffer[1];
 
-	gyro_rad.x += 2 * this->mahony_Kp * half_e.x;
-	gyro_rad.y += 2 * this->mahony_Kp * half_e.y;
-	gyro_rad.z += 2 * this->mahony_Kp * half_e.z;
+	uint8_t packet_size = this->fifo_packet_size();
+	uint8_t max_burst = sizeof(this->data_buffer) / packet_size;
 
-	// integrate rate of change of quaternion
-	gyro_rad.x *= 0.5f * 0.001f;		// pre-multiply common factors
-	gyro_rad.y *= 0.5f * 0.001f;
-	gyro_rad.z *= 0.5f * 0.001f;
+	// sensor drops the oldest bytes when full, packets would be shifted
+	if (count >= this->FIFO_SIZE || count % packet_size != 0) {
+		this->fifo_overflows++;
+		this->fifo_reset_pending = true;
 
-	float qa = this->quaternion.q0;
-	float qb = this->quaternion.q1;
-	float qc = this->quaternion.q2;
+		return false;
+	}
 
-	this->quaternion.q0 += (-qb * gyro_rad.x - qc * gyro_rad.y - this->quaternion.q3 * gyro_rad.z);
-	this->quaternion.q1 += (qa * gyro_rad.x + qc * gyro_rad.z - this->quaternion.q3 * gyro_rad.y);
-	this->quaternion.q2 += (qa * gyro_rad.y - qb * gyro_rad.z + this->quaternion.q3 * gyro_rad.x);
-	this->quaternion.q3 += (qa * gyro_rad.z + qb * gyro_rad.y - qc * gyro_rad.x);
+	this->fifo_samples = count / packet_size;
 
-	// normalise quaternion
-	recip_norm = this->inv_sqrt(this->quaternion.q0 * this->quaternion.q0 +
-			this->quaternion.q1 * this->quaternion.q1 +
-			this->quaternion.q2 * this->quaternion.q2 +
-			this->quaternion.q3 * this->quaternion.q3);
+	if (this->fifo_samples == 0)
+		return false;
 
-	this->quaternion.q0 *= recip_norm;
-	this->quaternion.q1 *= recip_norm;
-	this->quaternion.q2 *= recip_norm;
-	this->quaternion.q3 *= recip_norm;
+	// rest is left for the next read
+	this->fifo_burst = this->fifo_samples < max_burst ? this->fifo_samples : max_burst;
+	this->state = READ_FIFO_DATA;
 
-	// convert quaternion to euler
-	// https://en.wikipedia.org/wiki/Conversion_between_quaternions_and_Euler_angles#Quaternion_to_Euler_Angles_Conversion
+	return HAL_I2C_Mem_Read_DMA(&this->hi2c, this->I2C_ADDRESS, this->REGISTERS.FIFO_R_W, I2C_MEMADD_SIZE_8BIT,
+			this->data_buffer, this->fifo_burst * packet_size) == HAL_OK;
+}
 
-	float q2_sqr = this->quaternion.q2 * this->quaternion.q2;
+// only the newest quaternion is of any use
+void MPU6050::dmp_data_read() {
+	const uint8_t *data = this->data_buffer + (this->fifo_burst - 1) * this->DMP_PACKET_SIZE;
+	DMP_Sample sample;
+	float q[4];
 
-	float t0 = +2.0 * (this->quaternion.q0 * this->quaternion.q1 + this->quaternion.q2 * this->quaternion.q3);
-	float t1 = +1.0 - 2.0 * (this->quaternion.q1 * this->quaternion.q1 + q2_sqr);
-	this->roll = this->atan2(t0, t1);
+	for (uint8_t i = 0; i < 4; i++) {
+		int32_t value = (int32_t(data[4 * i]) << 24) | (int32_t(data[4 * i + 1]) << 16)
+				| (int32_t(data[4 * i + 2]) << 8) | data[4 * i + 3];
 
-	float t2 = +2.0 * (this->quaternion.q0 * this->quaternion.q2 - this->quaternion.q3 * this->quaternion.q1);
-	t2 = ((t2 > 1.0) ? 1.0 : t2);
-	t2 = ((t2 < -1.0) ? -1.0 : t2);
-	this->pitch = std::asin(t2);
-	this->pitch *= this->RAD_TO_DEG;
+		q[i] = value * (1.0f / (1 << 30));
+	}
 
-	float t3 = +2.0 * (this->quaternion.q0 * this->quaternion.q3 + this->quaternion.q1 * this->quaternion.q2);
-	float t4 = +1.0 - 2.0 * (q2_sqr + this->quaternion.q3 * this->quaternion.q3);
-	this->yaw = this->atan2(t3, t4);
-}
+	sample.timestamp = this->fifo_read_ticks;
+	sample.quaternion.q0 = q[0];
+	sample.quaternion.q1 = q[1];
+	sample.quaternion.q2 = q[2];
+	sample.quaternion.q3 = q[3];
 
-void MPU6050::Get_Euler(float& roll, float& pitch, float& yaw) {
-	roll = this->roll;
-	pitch = this->pitch;
-	yaw = this->yaw;
+	this->dmp_samples.Push(sample);
 }
 
-inline float MPU6050::inv_sqrt(float x) {
-	float y = x;
-	long i = *(long*)&y;
+// Sensor clock runs on its own, so timestamps continue from the previous burst
+// one sample period apart. They are only pulled back into the window where the
+// newest sample in FIFO must have been taken - one period before the count read.
+bool MPU6050::fifo_data_read() {
+	int32_t period = 1000000 / this->sample_rate;
+	uint32_t newest = this->fifo_timestamp + this->fifo_samples * period;
 
-	i = 0x5f3759df - (i >> 1);
-	y = *(float*)&i;
-	y = y * (1.5f - (0.5f * x * y * y));
+	if (!this->fifo_synced || int32_t(newest - this->fifo_read_ticks) > 0)
+		newest = this->fifo_read_ticks;
+	else if (int32_t(this->fifo_read_ticks - newest) >= period)
+		newest = this->fifo_read_ticks - period + 1;
 
-	return y;
-}
+	bool pushed = false;
 
-// use Betaflight atan2 approx: https://github.com/betaflight/betaflight/blob/master/src/main/common/maths.c
-float MPU6050::atan2(float y, float x) {
-	const float atanPolyCoef1 = 3.14551665884836e-07f;
-	const float atanPolyCoef2 = 0.99997356613987f;
-	const float atanPolyCoef3 = 0.14744007058297684f;
-	const float atanPolyCoef4 = 0.3099814292351353f;
-	const float atanPolyCoef5 = 0.05030176425872175f;
-	const float atanPolyCoef6 = 0.1471039133652469f;
-	const float atanPolyCoef7 = 0.6444640676891548f;
+	for (uint8_t i = 0; i < this->fifo_burst; i++) {
+		Sample sample;
 
-	float abs_x, abs_y;
-	float result;
+		this->parse_sample(this->data_buffer + i * this->SAMPLE_SIZE, sample);
+		sample.timestamp = newest - (this->fifo_samples - 1 - i) * period;
 
-	abs_x = std::abs(x);
-	abs_y = std::abs(y);
+		pushed = this->push_sample(sample) || pushed;
+	}
 
-	result = (abs_x > abs_y ? abs_x : abs_y);
+	this->fifo_timestamp = newest - (this->fifo_samples - this->fifo_burst) * period;
+	this->fifo_synced = true;
 
-	if (result != 0)
-		result = (abs_x < abs_y ? abs_x : abs_y) / result;
+	return pushed;
+}
 
-	result = -((((atanPolyCoef5 * result - atanPolyCoef4) * result - atanPolyCoef3) * result - atanPolyCoef2) * result - atanPolyCoef1) / ((atanPolyCoef7 * result + atanPolyCoef6) * result + 1.0);
-	result *= this->RAD_TO_DEG;
+bool MPU6050::Store_Sample() {
+	Sample sample;
+	bool pushed;
 
-	if (abs_y > abs_x)
-		result = 90 - result;
-	if (x < 0)
-		result = 180 - result;
-	if (y < 0)
-		result = -result;
+	switch (this->state) {
+	case READ_SAMPLE:
+		this->parse_sample(this->data_buffer, sample);
+		sample.timestamp = this->data_ready_ticks;
 
-	return result;
-}
+		pushed = this->push_sample(sample);
+		this->state = READ_IDLE;
 
-void MPU6050::Reset_Integrators() {
-	this->roll = 0;
-	this->pitch = 0;
-	this->yaw = 0;
+		// DMP quaternion is due, chain FIFO read behind the sample
+		if (this->dmp_mode) {
+			this->dmp_reads++;
+
+			if (this->dmp_reads >= this->sample_rate / this->dmp_firmware->rate) {
+				this->dmp_reads = 0;
+				this->fifo_start_count_read();
+			}
+		}
 
-	this->mahony_integral.x = 0;
-	this->mahony_integral.y = 0;
-	this->mahony_integral.z = 0;
+		return pushed;
+	case READ_FIFO_COUNT:
+		if (!this->fifo_count_read())
+			this->state = READ_IDLE;
 
-	this->quaternion.q0 = 1;
-	this->quaternion.q1 = 0;
-	this->quaternion.q2 = 0;
-	this->quaternion.q3 = 0;
+		return false;
+	case READ_FIFO_DATA:
+		this->state = READ_IDLE;
+
+		if (this->dmp_mode) {
+			this->dmp_data_read();
+			return false;
+		}
+
+		return this->fifo_data_read();
+	default:
+		return false;
+	}
 }
 
-// approx. using http://nghiaho.com/?p=997
-inline double MPU6050::atan(double z) {
-	if (z < 0)
-		return -this->atan(-z);
+// attitude computed by DMP
+void MPU6050::Compute_DMP() {
+	DMP_Sample sample;
 
-	if (z > 1)
-		return 90 - this->atan(1 / z);
+	if (!this->dmp_samples.Read_Latest(sample))
+		return;
 
-	return z * (45 - (z - 1) * (14 + 3.83 * z));
+	this->quaternion = sample.quaternion;
+	this->euler_valid = false;
 }
 
 } /* namespace The_Eye */
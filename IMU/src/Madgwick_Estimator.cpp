@@ -0,0 +1,83 @@
+/*
+ * Madgwick_Estimator.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Madgwick_Estimator.h"
+#include "Fast_Math.h"
+
+namespace flyhero {
+
+Madgwick_Estimator::Madgwick_Estimator() {
+	this->beta = 0.1f;
+}
+
+void Madgwick_Estimator::Set_Beta(float beta) {
+	this->beta = beta;
+}
+
+void Madgwick_Estimator::Update(const float gyro[3], const float accel[3], float dt) {
+	Quaternion& q = this->quaternion;
+	float gx = gyro[0] * DEG_TO_RAD;
+	float gy = gyro[1] * DEG_TO_RAD;
+	float gz = gyro[2] * DEG_TO_RAD;
+
+	// rate of change of quaternion from gyroscope
+	float q_dot0 = 0.5f * (-q.q1 * gx - q.q2 * gy - q.q3 * gz);
+	float q_dot1 = 0.5f * (q.q0 * gx + q.q2 * gz - q.q3 * gy);
+	float q_dot2 = 0.5f * (q.q0 * gy - q.q1 * gz + q.q3 * gx);
+	float q_dot3 = 0.5f * (q.q0 * gz + q.q1 * gy - q.q2 * gx);
+
+	float norm = accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2];
+
+	// free fall gives no direction
+	if (norm > 0) {
+		float recip_norm = Fast_Math::Inv_Sqrt(norm);
+		float ax = accel[0] * recip_norm;
+		float ay = accel[1] * recip_norm;
+		float az = accel[2] * recip_norm;
+
+		float q0q0 = q.q0 * q.q0;
+		float q1q1 = q.q1 * q.q1;
+		float q2q2 = q.q2 * q.q2;
+		float q3q3 = q.q3 * q.q3;
+
+		// gradient of the objective function
+		float s0 = 4 * q.q0 * q2q2 + 2 * q.q2 * ax + 4 * q.q0 * q1q1 - 2 * q.q1 * ay;
+		float s1 = 4 * q.q1 * q3q3 - 2 * q.q3 * ax + 4 * q0q0 * q.q1 - 2 * q.q0 * ay - 4 * q.q1
+				+ 8 * q.q1 * q1q1 + 8 * q.q1 * q2q2 + 4 * q.q1 * az;
+		float s2 = 4 * q0q0 * q.q2 + 2 * q.q0 * ax + 4 * q.q2 * q3q3 - 2 * q.q3 * ay - 4 * q.q2
+				+ 8 * q.q2 * q1q1 + 8 * q.q2 * q2q2 + 4 * q.q2 * az;
+		float s3 = 4 * q1q1 * q.q3 - 2 * q.q1 * ax + 4 * q2q2 * q.q3 - 2 * q.q2 * ay;
+
+		norm = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+
+		// already at the minimum, step covers predictions since the last update
+		if (norm > 0) {
+			recip_norm = this->beta * Fast_Math::Inv_Sqrt(norm) * this->correction_dt(dt) / dt;
+
+			q_dot0 -= recip_norm * s0;
+			q_dot1 -= recip_norm * s1;
+			q_dot2 -= recip_norm * s2;
+			q_dot3 -= recip_norm * s3;
+		}
+	}
+
+	q.q0 += q_dot0 * dt;
+	q.q1 += q_dot1 * dt;
+	q.q2 += q_dot2 * dt;
+	q.q3 += q_dot3 * dt;
+
+	this->normalise();
+}
+
+const char* Madgwick_Estimator::Get_Name() {
+	return "madgwick";
+}
+
+void Madgwick_Estimator::reset() {
+}
+
+} /* namespace flyhero */
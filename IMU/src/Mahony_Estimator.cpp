@@ -0,0 +1,87 @@
+/*
+ * Mahony_Estimator.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Mahony_Estimator.h"
+#include "Fast_Math.h"
+
+namespace flyhero {
+
+Mahony_Estimator::Mahony_Estimator() {
+	this->Kp = 2;
+	this->Ki = 0.1f;
+	this->reset();
+}
+
+void Mahony_Estimator::Set_Gains(float Kp, float Ki) {
+	this->Kp = Kp;
+	this->Ki = Ki;
+}
+
+void Mahony_Estimator::Update(const float gyro[3], const float accel[3], float dt) {
+	Quaternion& q = this->quaternion;
+	float recip_norm;
+	float gyro_rad[3];
+	float a[3];
+	float half_v[3], half_e[3];
+
+	for (uint8_t i = 0; i < 3; i++)
+		gyro_rad[i] = gyro[i] * DEG_TO_RAD;
+
+	// normalise accelerometer measurement, free fall gives no direction and no error
+	float norm = accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2];
+
+	recip_norm = norm > 0 ? Fast_Math::Inv_Sqrt(norm) : 0;
+
+	for (uint8_t i = 0; i < 3; i++)
+		a[i] = accel[i] * recip_norm;
+
+	// estimated direction of gravity
+	half_v[0] = q.q1 * q.q3 - q.q0 * q.q2;
+	half_v[1] = q.q0 * q.q1 + q.q2 * q.q3;
+	half_v[2] = q.q0 * q.q0 - 0.5f + q.q3 * q.q3;
+
+	// error is cross product between estimated and measured direction of gravity
+	half_e[0] = a[1] * half_v[2] - a[2] * half_v[1];
+	half_e[1] = a[2] * half_v[0] - a[0] * half_v[2];
+	half_e[2] = a[0] * half_v[1] - a[1] * half_v[0];
+
+	float correction_dt = this->correction_dt(dt);
+
+	if (this->Ki > 0) {
+		for (uint8_t i = 0; i < 3; i++) {
+			this->integral[i] += 2 * this->Ki * half_e[i] * correction_dt;
+			gyro_rad[i] += this->integral[i];
+		}
+	}
+
+	// proportional part integrated over correction_dt as well
+	for (uint8_t i = 0; i < 3; i++)
+		gyro_rad[i] += 2 * this->Kp * half_e[i] * correction_dt / dt;
+
+	this->integrate(gyro_rad[0], gyro_rad[1], gyro_rad[2], dt);
+	this->normalise();
+}
+
+// integral holds gyro bias, it applies between corrections as well
+void Mahony_Estimator::Predict(const float gyro[3], float dt) {
+	this->integrate(gyro[0] * DEG_TO_RAD + this->integral[0], gyro[1] * DEG_TO_RAD + this->integral[1],
+			gyro[2] * DEG_TO_RAD + this->integral[2], dt);
+	this->normalise();
+
+	this->predicted_time += dt;
+}
+
+const char* Mahony_Estimator::Get_Name() {
+	return "mahony";
+}
+
+void Mahony_Estimator::reset() {
+	for (uint8_t i = 0; i < 3; i++)
+		this->integral[i] = 0;
+}
+
+} /* namespace flyhero */
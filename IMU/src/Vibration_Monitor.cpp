@@ -0,0 +1,73 @@
+/*
+ * Vibration_Monitor.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Vibration_Monitor.h"
+
+namespace flyhero {
+
+Vibration_Monitor::Vibration_Monitor() {
+	this->window_length = DEFAULT_WINDOW;
+
+	this->Reset();
+}
+
+// takes effect with the next window
+void Vibration_Monitor::Set_Window(uint32_t length_us) {
+	this->window_length = length_us;
+}
+
+// not to be called while samples are added
+void Vibration_Monitor::Reset() {
+	this->window_start = 0;
+	this->count = 0;
+
+	for (uint8_t i = 0; i < AXES; i++) {
+		this->sum[i] = 0;
+		this->sum_squares[i] = 0;
+		this->min[i] = INT16_MAX;
+		this->max[i] = INT16_MIN;
+		this->clips[i] = 0;
+		this->total_clips[i] = 0;
+	}
+}
+
+// once per window, variance from sums is fine in double for a window of 16 bit samples
+void Vibration_Monitor::publish(uint32_t timestamp) {
+	Window window;
+
+	window.timestamp = timestamp;
+	window.samples = this->count;
+
+	for (uint8_t i = 0; i < AXES; i++) {
+		double mean = double(this->sum[i]) / this->count;
+		double variance = double(this->sum_squares[i]) / this->count - mean * mean;
+		double peak = this->max[i] - mean > mean - this->min[i] ? this->max[i] - mean : mean - this->min[i];
+
+		window.rms[i] = variance > 0 ? float(std::sqrt(variance)) : 0;
+		window.peak[i] = uint16_t(peak + 0.5);
+		window.clips[i] = this->clips[i];
+
+		this->sum[i] = 0;
+		this->sum_squares[i] = 0;
+		this->min[i] = INT16_MAX;
+		this->max[i] = INT16_MIN;
+		this->clips[i] = 0;
+	}
+
+	this->count = 0;
+	this->windows.Push(window);
+}
+
+bool Vibration_Monitor::Get_Window(Window& window) {
+	return this->windows.Read_Latest(window);
+}
+
+uint32_t Vibration_Monitor::Get_Total_Clips(uint8_t axis) {
+	return axis < AXES ? this->total_clips[axis] : 0;
+}
+
+} /* namespace flyhero */
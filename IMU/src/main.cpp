@@ -8,22 +8,23 @@
   ******************************************************************************
 */
 
-
-#include "stm32f4xx_hal.h"
+
+#include "stm32f4xx_hal.h"
 #include "stm32f4xx_nucleo.h"
-#include "MPU6050.h"
+#include "IMU.h"
 #include "LEDs.h"
 #include "Timer.h"
 #include "Logger.h"
+#include "Telemetry_Capture.h"
 
-using namespace flyhero;
+using namespace flyhero;
 
 extern "C" void initialise_monitor_handles(void);
 
 void IMU_Data_Ready_Callback();
 void IMU_Data_Read_Callback();
 
-MPU6050& mpu = MPU6050::Instance();
+IMU& mpu = IMU::Create_Instance(IMU_MPU6050);
 Logger& logger = Logger::Instance();
 
 volatile bool log_flag = false;
@@ -73,8 +74,8 @@ void IMU_Data_Read_Callback() {
 	mpu.Complete_Read();
 
 	// 200 us
-	mpu.Compute_Mahony();
-	//mpu.Compute_Euler();
+	mpu.Compute_Attitude();
 
+	Telemetry_Capture::Instance().Push();
 	log_flag = true;
 }
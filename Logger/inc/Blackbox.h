@@ -0,0 +1,96 @@
+/*
+ * Blackbox.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef BLACKBOX_H_
+#define BLACKBOX_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "Blackbox_Storage.h"
+#include "Telemetry.h"
+
+namespace flyhero {
+
+// Records every telemetry snapshot as frames into page sized buffers, full
+// pages are programmed in the background from Process(). Record() only
+// encodes and copies, when both pages are still waiting for the storage the
+// frame is dropped and counted, the gap shows in frame sequence numbers.
+// Frames are stored back to back from address 0, each recording starts on
+// a new page, the rest of the last page stays erased and decoders skip it.
+class Blackbox {
+public:
+	static const uint16_t PAGE_SIZE = Blackbox_Storage::PAGE_SIZE;
+
+	enum State {
+		BLACKBOX_IDLE,
+		BLACKBOX_ERASING,
+		BLACKBOX_RECORDING,
+		// last page is being written
+		BLACKBOX_STOPPING,
+		BLACKBOX_FULL
+	};
+
+private:
+	Blackbox();
+	Blackbox(Blackbox const&);
+	Blackbox& operator=(Blackbox const&);
+
+	Blackbox_Storage *storage;
+	State state;
+	uint32_t data_type;
+	Telemetry::Layout layout;
+	uint8_t frame[Telemetry::MAX_FRAME_SIZE];
+	uint8_t pages[2][PAGE_SIZE];
+	// page frames go to and bytes in it
+	uint8_t filling;
+	uint16_t filled;
+	// the other page waits for the storage or is being programmed
+	bool queued;
+	bool programming;
+	uint16_t queued_size;
+	// where the queued page goes, everything below is recorded
+	uint32_t address;
+	uint16_t sequence;
+	uint32_t frames;
+	uint32_t dropped;
+
+	bool page_erased(uint32_t page);
+	uint32_t find_end();
+	void queue_page();
+
+public:
+	static Blackbox& Instance();
+
+	// continues after what is already recorded
+	HAL_StatusTypeDef Init(Blackbox_Storage *storage);
+	// fields is a mask of telemetry field ID bits
+	void Set_Data_Type(uint32_t fields);
+	uint32_t Get_Data_Type();
+	State Get_State();
+	bool Is_Recording();
+
+	HAL_StatusTypeDef Start();
+	void Stop();
+	HAL_StatusTypeDef Erase();
+	void Record(const Telemetry::Snapshot& snapshot);
+	// snapshots lost before they got here, leaves a gap in sequence
+	void Skip(uint32_t count);
+	void Process();
+
+	// recorded bytes from address 0, erased padding included
+	uint32_t Get_Size();
+	uint32_t Get_Capacity();
+	// only while idle or full
+	HAL_StatusTypeDef Read(uint32_t offset, uint8_t *data, uint16_t size);
+	// this recording
+	uint32_t Get_Frames();
+	uint32_t Get_Dropped();
+};
+
+} /* namespace flyhero */
+
+#endif /* BLACKBOX_H_ */
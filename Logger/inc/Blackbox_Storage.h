@@ -0,0 +1,37 @@
+/*
+ * Blackbox_Storage.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef BLACKBOX_STORAGE_H_
+#define BLACKBOX_STORAGE_H_
+
+#include <stdint.h>
+#include <stm32f4xx_hal.h>
+
+namespace flyhero {
+
+// Page programmed NOR flash as the blackbox sees it. Erased bytes read as
+// 0xFF, programming only clears bits, pages are written whole and in order.
+// Program and erase return right away and run until Is_Busy() says otherwise,
+// page data has to stay untouched until then.
+class Blackbox_Storage {
+public:
+	static const uint16_t PAGE_SIZE = 256;
+
+	virtual HAL_StatusTypeDef Init() = 0;
+	virtual uint32_t Get_Size() = 0;		// [B]
+	virtual bool Is_Busy() = 0;
+	// address is page aligned, size at most PAGE_SIZE
+	virtual HAL_StatusTypeDef Start_Program(uint32_t address, const uint8_t *data, uint16_t size) = 0;
+	// whole storage
+	virtual HAL_StatusTypeDef Start_Erase() = 0;
+	// blocking, not while busy
+	virtual HAL_StatusTypeDef Read(uint32_t address, uint8_t *data, uint16_t size) = 0;
+};
+
+} /* namespace flyhero */
+
+#endif /* BLACKBOX_STORAGE_H_ */
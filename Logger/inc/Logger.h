@@ -9,22 +9,37 @@
 #define LOGGER_H_
 
 #include "stm32f4xx_hal.h"
-#include "MPU6050.h"
+#include "IMU.h"
 #include "ESP.h"
 #include "Motors_Controller.h"
+#include "Timing_Probe.h"
+#include "Telemetry.h"
+#include "Telemetry_Capture.h"
+#include "Blackbox.h"
 
 namespace flyhero {
 
 class Logger {
 public:
+	// bit positions are telemetry field IDs
 	enum Data_Type {
-		Accel_X = 1 << 15, Accel_Y = 1 << 14, Accel_Z = 1 << 13, Gyro_X = 1 << 12, Gyro_Y = 1 << 11, Gyro_Z = 1 << 10,
-		Temperature = 1 << 9, Roll = 1 << 8, Pitch = 1 << 7, Yaw = 1 << 6, Throttle = 1 << 5,
-		Motor_FL = 1 << 4, Motor_FR = 1 << 3, Motor_BL = 1 << 2, Motor_BR = 1 << 1,
+		Accel_X = 1 << Telemetry::FIELD_ACCEL_X, Accel_Y = 1 << Telemetry::FIELD_ACCEL_Y, Accel_Z = 1 << Telemetry::FIELD_ACCEL_Z,
+		Gyro_X = 1 << Telemetry::FIELD_GYRO_X, Gyro_Y = 1 << Telemetry::FIELD_GYRO_Y, Gyro_Z = 1 << Telemetry::FIELD_GYRO_Z,
+		Temperature = 1 << Telemetry::FIELD_TEMPERATURE, Roll = 1 << Telemetry::FIELD_ROLL, Pitch = 1 << Telemetry::FIELD_PITCH,
+		Yaw = 1 << Telemetry::FIELD_YAW, Throttle = 1 << Telemetry::FIELD_THROTTLE,
+		Motor_FL = 1 << Telemetry::FIELD_MOTOR_FL, Motor_FR = 1 << Telemetry::FIELD_MOTOR_FR,
+		Motor_BL = 1 << Telemetry::FIELD_MOTOR_BL, Motor_BR = 1 << Telemetry::FIELD_MOTOR_BR,
+		Timing = 1 << Telemetry::FIELD_TIMING,
+		// once per window of the vibration monitor, at full sample rate
+		Vibration_Accel = 1 << Telemetry::FIELD_VIBRATION_ACCEL, Vibration_Gyro = 1 << Telemetry::FIELD_VIBRATION_GYRO,
+		Clipping = 1 << Telemetry::FIELD_CLIPPING,
+		// gyro sample capture to PWM write [us]
+		Sample_Age = 1 << Telemetry::FIELD_SAMPLE_AGE,
 		Accel_All = Accel_X | Accel_Y | Accel_Z,
 		Gyro_All = Gyro_X | Gyro_Y | Gyro_Z,
 		Euler_All = Roll | Pitch | Yaw,
-		Motors_All = Motor_FL | Motor_FR | Motor_BL | Motor_BR
+		Motors_All = Motor_FL | Motor_FR | Motor_BL | Motor_BR,
+		Vibration_All = Vibration_Accel | Vibration_Gyro | Clipping
 	};
 
 	enum Log_Type { WiFi, UART };
@@ -38,9 +53,13 @@ private:
 	DMA_HandleTypeDef hdma_usart2_tx;
 	Data_Type data_type;
 	Log_Type log_type;
-	uint8_t data_buffer[40];
+	Telemetry::Layout layout;
+	uint8_t data_buffer[Telemetry::MAX_FRAME_SIZE];
 	bool log;
-	uint32_t last_ticks;
+	uint16_t sequence;
+	Telemetry_Capture::Ring::Reader reader;
+
+	HAL_StatusTypeDef send_data();
 
 public:
 	static Logger& Instance();
@@ -0,0 +1,70 @@
+/*
+ * SPI_Flash.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef SPI_FLASH_H_
+#define SPI_FLASH_H_
+
+#include <stm32f4xx_hal.h>
+#include "Blackbox_Storage.h"
+
+namespace flyhero {
+
+// Blackbox storage on SPI NOR flash with the common JEDEC command set (W25Q,
+// GD25Q, MX25L up to 16 MB). Page data go out by DMA, the busy bit is polled
+// from Is_Busy(), commands and reads are short blocking transfers.
+class SPI_Flash : public Blackbox_Storage {
+private:
+	SPI_Flash();
+	SPI_Flash(SPI_Flash const&);
+	SPI_Flash& operator=(SPI_Flash const&);
+
+	const uint8_t CMD_WRITE_ENABLE = 0x06;
+	const uint8_t CMD_READ_STATUS = 0x05;
+	const uint8_t CMD_READ_DATA = 0x03;
+	const uint8_t CMD_PAGE_PROGRAM = 0x02;
+	const uint8_t CMD_CHIP_ERASE = 0xC7;
+	const uint8_t CMD_JEDEC_ID = 0x9F;
+	const uint8_t STATUS_BUSY = 0x01;
+	// 3 byte addressing reaches 16 MB
+	const uint8_t MIN_CAPACITY = 0x10;
+	const uint8_t MAX_CAPACITY = 0x18;
+	// APB1 runs at 45 MHz, 22.5 MHz is in spec of plain reads
+	const uint32_t SPI_PRESCALER = SPI_BAUDRATEPRESCALER_2;
+	const uint16_t SPI_TIMEOUT = 10;
+
+	SPI_HandleTypeDef hspi;
+	DMA_HandleTypeDef hdma_spi_tx;
+	uint32_t size;
+	// page data still going out
+	volatile bool transferring;
+	// program or erase started, busy bit not seen cleared since
+	bool working;
+
+	HAL_StatusTypeDef spi_init();
+	void spi_select(bool select);
+	HAL_StatusTypeDef command(uint8_t command, uint32_t address, bool with_address);
+	HAL_StatusTypeDef write_enable();
+	HAL_StatusTypeDef read_status(uint8_t& status);
+
+public:
+	static SPI_Flash& Instance();
+
+	DMA_HandleTypeDef* Get_DMA_Tx_Handle();
+	SPI_HandleTypeDef* Get_SPI_Handle();
+	void Transfer_Complete();
+
+	HAL_StatusTypeDef Init();
+	uint32_t Get_Size();
+	bool Is_Busy();
+	HAL_StatusTypeDef Start_Program(uint32_t address, const uint8_t *data, uint16_t size);
+	HAL_StatusTypeDef Start_Erase();
+	HAL_StatusTypeDef Read(uint32_t address, uint8_t *data, uint16_t size);
+};
+
+} /* namespace flyhero */
+
+#endif /* SPI_FLASH_H_ */
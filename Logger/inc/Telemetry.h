@@ -0,0 +1,128 @@
+/*
+ * Telemetry.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace flyhero {
+
+// Self describing telemetry frame, little endian (as both target and host are):
+//
+//   'F' 'H' | version | payload length | sequence (uint16) | timestamp [us] (uint64) | fields | CRC32
+//
+// Each field is its ID, a type byte (base type in the low nibble, count - 1 in
+// the high one) and count values, so a decoder needs nothing sent ahead and
+// skips fields it does not know. CRC32 is what the STM32 CRC unit gives for
+// the frame from sync on as little endian words, the last one zero padded.
+// Sequence runs over all frames of a sender, gaps are lost frames.
+class Telemetry {
+public:
+	static const uint8_t SYNC_1 = 'F';
+	static const uint8_t SYNC_2 = 'H';
+	static const uint8_t VERSION = 2;
+	static const uint8_t HEADER_SIZE = 14;
+	static const uint8_t TRAILER_SIZE = 4;
+	static const uint16_t MAX_FRAME_SIZE = HEADER_SIZE + 255 + TRAILER_SIZE;
+	static const uint8_t MAX_COUNT = 16;
+
+	enum Field_Type {
+		TYPE_UINT8, TYPE_INT8, TYPE_UINT16, TYPE_INT16, TYPE_UINT32, TYPE_INT32, TYPE_FLOAT,
+		TYPE_COUNT
+	};
+
+	// IDs below 32 are bit positions of the Logger data type mask
+	enum Field_ID {
+		FIELD_TIMING = 0, FIELD_MOTOR_BR = 1, FIELD_MOTOR_BL = 2, FIELD_MOTOR_FR = 3, FIELD_MOTOR_FL = 4,
+		FIELD_THROTTLE = 5, FIELD_YAW = 6, FIELD_PITCH = 7, FIELD_ROLL = 8, FIELD_TEMPERATURE = 9,
+		FIELD_GYRO_Z = 10, FIELD_GYRO_Y = 11, FIELD_GYRO_X = 12, FIELD_ACCEL_Z = 13, FIELD_ACCEL_Y = 14,
+		FIELD_ACCEL_X = 15, FIELD_VIBRATION_ACCEL = 16, FIELD_VIBRATION_GYRO = 17, FIELD_CLIPPING = 18,
+		FIELD_SAMPLE_AGE = 19,
+		// sent along with the one above them
+		FIELD_TIMING_HISTOGRAM = 32
+	};
+
+	// masks of fields that come from one source
+	static const uint32_t FIELDS_RAW = (1 << FIELD_ACCEL_X) | (1 << FIELD_ACCEL_Y) | (1 << FIELD_ACCEL_Z)
+			| (1 << FIELD_GYRO_X) | (1 << FIELD_GYRO_Y) | (1 << FIELD_GYRO_Z) | (1 << FIELD_TEMPERATURE);
+	static const uint32_t FIELDS_EULER = (1 << FIELD_ROLL) | (1 << FIELD_PITCH) | (1 << FIELD_YAW);
+	static const uint32_t FIELDS_MOTORS = (1 << FIELD_THROTTLE) | (1 << FIELD_MOTOR_FL) | (1 << FIELD_MOTOR_FR)
+			| (1 << FIELD_MOTOR_BL) | (1 << FIELD_MOTOR_BR);
+	static const uint32_t FIELDS_VIBRATION = (1 << FIELD_VIBRATION_ACCEL) | (1 << FIELD_VIBRATION_GYRO)
+			| (1 << FIELD_CLIPPING);
+
+	static const uint8_t TIMING_BINS = 8;
+	static const uint8_t FIELD_COUNT = 21;
+
+	// everything a frame may carry, fields pick from it
+	struct Snapshot {
+		uint64_t timestamp;		// [us]
+		// raw values of one sample
+		int16_t accel[3];
+		int16_t gyro[3];
+		int16_t temperature;
+		float euler[3];		// roll, pitch, yaw [deg]
+		uint16_t throttle;
+		uint16_t motors[4];		// FL, FR, BL, BR
+		uint16_t sample_age;		// [us]
+		// one probe per frame: index, min, avg, max [ns]
+		uint32_t timing[4];
+		uint16_t timing_histogram[TIMING_BINS];
+		// RMS x, y, z, peak x, y, z [LSB]
+		uint16_t vibration_accel[6];
+		uint16_t vibration_gyro[6];
+		uint16_t clips[6];
+	};
+
+	// where a field comes from in Snapshot, FIELDS lists them in frame order
+	struct Field_Descriptor {
+		uint8_t id;
+		Field_Type type;
+		uint8_t count;
+		uint8_t offset;
+		// mask bit the field is sent with
+		uint8_t enable;
+	};
+
+	static const Field_Descriptor FIELDS[FIELD_COUNT];
+
+	// Fields of one mask resolved ahead, so encoding is a copy per field
+	struct Layout {
+		struct Entry {
+			uint8_t id;
+			uint8_t type_byte;
+			uint8_t offset;
+			uint8_t size;
+		};
+
+		uint8_t count;
+		uint8_t payload;
+		Entry entries[FIELD_COUNT];
+	};
+
+private:
+	Telemetry();
+
+	static void copy_values(uint8_t *destination, const uint8_t *source, uint8_t size);
+
+public:
+	static uint8_t Get_Type_Size(Field_Type type);
+	static inline uint8_t Get_Type_Byte(Field_Type type, uint8_t count) {
+		return uint8_t(((count - 1) << 4) | type);
+	}
+
+	// fields is a mask of field ID bits
+	static void Build_Layout(uint32_t fields, Layout& layout);
+	// buffer has to hold MAX_FRAME_SIZE, returns frame size
+	static uint16_t Encode(const Snapshot& snapshot, const Layout& layout, uint16_t sequence, uint8_t *buffer);
+};
+
+} /* namespace flyhero */
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,65 @@
+/*
+ * Telemetry_Capture.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef TELEMETRY_CAPTURE_H_
+#define TELEMETRY_CAPTURE_H_
+
+#include <stdint.h>
+#include "IMU.h"
+#include "Motors_Controller.h"
+#include "Timing_Probe.h"
+#include "Timer.h"
+#include "Telemetry.h"
+#include "Sample_Ring.h"
+
+namespace flyhero {
+
+// Snapshots of one control cycle for all log sinks. Push() runs at the end
+// of the cycle, so the values in a snapshot belong together, and costs a
+// fill of the ring slot. Sinks drain the ring in the background, each with
+// its own reader; statistics over many cycles (timing probes round robin,
+// vibration windows) are added as a snapshot is read, the ring never holds
+// them.
+class Telemetry_Capture {
+public:
+	// 16 ms for sinks to fall behind, flash writes stall longer and lose some
+	static const uint16_t RING_SIZE = 16;
+	static const uint32_t FIELDS_CYCLE = Telemetry::FIELDS_RAW | Telemetry::FIELDS_EULER | Telemetry::FIELDS_MOTORS
+			| (1 << Telemetry::FIELD_SAMPLE_AGE);
+	static const uint32_t FIELDS_STATISTICS = (1 << Telemetry::FIELD_TIMING) | Telemetry::FIELDS_VIBRATION;
+
+	typedef Sample_Ring<Telemetry::Snapshot, RING_SIZE> Ring;
+
+private:
+	Telemetry_Capture();
+	Telemetry_Capture(Telemetry_Capture const&);
+	Telemetry_Capture& operator=(Telemetry_Capture const&);
+
+	Ring snapshots;
+	// Timer ticks wrap after 71 minutes, timestamps in snapshots do not
+	uint32_t last_ticks;
+	uint64_t timestamp;
+	uint8_t timing_probe_index;
+
+	void read_timing(Telemetry::Snapshot& snapshot);
+	void read_vibration(Telemetry::Snapshot& snapshot);
+
+public:
+	static Telemetry_Capture& Instance();
+
+	// end of control cycle, the only producer
+	void Push();
+	// reader starts with the next snapshot
+	void Attach(Ring::Reader& reader);
+	// fields selects statistics to add, cycle fields are always there;
+	// readers run in the main loop, they share the probe round robin
+	bool Read(Ring::Reader& reader, Telemetry::Snapshot& snapshot, uint32_t fields);
+};
+
+} /* namespace flyhero */
+
+#endif /* TELEMETRY_CAPTURE_H_ */
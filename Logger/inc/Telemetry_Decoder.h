@@ -0,0 +1,82 @@
+/*
+ * Telemetry_Decoder.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef TELEMETRY_DECODER_H_
+#define TELEMETRY_DECODER_H_
+
+#include <stdint.h>
+#include "Telemetry.h"
+
+namespace flyhero {
+
+// Ground side of Telemetry, takes the byte stream as it comes. Frames are
+// found by sync, length and CRC32, a bad one costs the bytes up to the
+// next sync. Fields of unknown IDs are kept, unknown types end the frame.
+// CRC is computed in software, bit for bit what the STM32 CRC unit gives.
+class Telemetry_Decoder {
+public:
+	static const uint8_t MAX_FIELDS = 32;
+
+	struct Field {
+		uint8_t id;
+		Telemetry::Field_Type type;
+		uint8_t count;
+		double values[Telemetry::MAX_COUNT];
+	};
+
+	struct Frame {
+		uint8_t version;
+		uint16_t sequence;
+		uint64_t timestamp;		// [us]
+		uint8_t field_count;
+		Field fields[MAX_FIELDS];
+	};
+
+private:
+	Telemetry_Decoder(Telemetry_Decoder const&);
+	Telemetry_Decoder& operator=(Telemetry_Decoder const&);
+
+	uint8_t buffer[Telemetry::MAX_FRAME_SIZE];
+	uint16_t size;
+	Frame frame;
+	uint32_t frames;
+	uint32_t errors;
+	uint32_t skipped;
+	uint32_t lost;
+	uint16_t next_sequence;
+
+	static uint32_t crc_table[256];
+
+	void drop(uint16_t count);
+	bool parse();
+	static void init_crc_table();
+
+public:
+	Telemetry_Decoder();
+
+	void Reset();
+	// returns true when the byte completed a valid frame
+	bool Push(uint8_t byte);
+	const Frame& Get_Frame();
+	// NULL when the last frame does not have it
+	const Field* Find_Field(uint8_t id);
+	uint32_t Get_Frames();
+	// frames that had sync but failed length, CRC or field checks
+	uint32_t Get_Errors();
+	// bytes thrown away outside of valid frames
+	uint32_t Get_Skipped();
+	// gaps in sequence, a sender that starts over at 0 is not counted
+	uint32_t Get_Lost();
+
+	// CRC_Calculator::Calculate() of the same bytes
+	static uint32_t Calculate_CRC(const uint8_t *data, uint32_t size);
+	static const char* Get_Field_Name(uint8_t id);
+};
+
+} /* namespace flyhero */
+
+#endif /* TELEMETRY_DECODER_H_ */
@@ -0,0 +1,263 @@
+/*
+ * Blackbox.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Blackbox.h"
+#include "CRC_Calculator.h"
+
+namespace flyhero {
+
+Blackbox& Blackbox::Instance() {
+	static Blackbox instance;
+
+	return instance;
+}
+
+Blackbox::Blackbox() {
+	this->storage = NULL;
+	this->state = BLACKBOX_IDLE;
+	this->data_type = 0;
+	this->filling = 0;
+	this->filled = 0;
+	this->queued = false;
+	this->programming = false;
+	this->queued_size = 0;
+	this->address = 0;
+	this->sequence = 0;
+	this->frames = 0;
+	this->dropped = 0;
+
+	Telemetry::Build_Layout(0, this->layout);
+}
+
+HAL_StatusTypeDef Blackbox::Init(Blackbox_Storage *storage) {
+	this->storage = storage;
+
+	// frames carry CRC of the CRC unit
+	if (storage == NULL || storage->Init() != HAL_OK || CRC_Calculator::Instance().Init() != HAL_OK) {
+		this->storage = NULL;
+		return HAL_ERROR;
+	}
+
+	this->address = this->find_end();
+	this->state = this->address + PAGE_SIZE <= storage->Get_Size() ? BLACKBOX_IDLE : BLACKBOX_FULL;
+
+	return HAL_OK;
+}
+
+bool Blackbox::page_erased(uint32_t page) {
+	uint8_t *data = this->pages[0];
+
+	if (this->storage->Read(page * PAGE_SIZE, data, PAGE_SIZE) != HAL_OK)
+		return false;
+
+	for (uint16_t i = 0; i < PAGE_SIZE; i++) {
+		if (data[i] != 0xFF)
+			return false;
+	}
+
+	return true;
+}
+
+// pages are written in order, so the first erased one is found by bisection
+uint32_t Blackbox::find_end() {
+	uint32_t low = 0;
+	uint32_t high = this->storage->Get_Size() / PAGE_SIZE;
+
+	while (low < high) {
+		uint32_t middle = low + (high - low) / 2;
+
+		if (this->page_erased(middle))
+			high = middle;
+		else
+			low = middle + 1;
+	}
+
+	return low * PAGE_SIZE;
+}
+
+void Blackbox::Set_Data_Type(uint32_t fields) {
+	this->data_type = fields;
+
+	Telemetry::Build_Layout(fields, this->layout);
+}
+
+uint32_t Blackbox::Get_Data_Type() {
+	return this->data_type;
+}
+
+Blackbox::State Blackbox::Get_State() {
+	return this->state;
+}
+
+bool Blackbox::Is_Recording() {
+	return this->state == BLACKBOX_RECORDING;
+}
+
+HAL_StatusTypeDef Blackbox::Start() {
+	if (this->storage == NULL || this->data_type == 0)
+		return HAL_ERROR;
+
+	if (this->state != BLACKBOX_IDLE)
+		return HAL_BUSY;
+
+	this->filling = 0;
+	this->filled = 0;
+	this->sequence = 0;
+	this->frames = 0;
+	this->dropped = 0;
+	this->state = BLACKBOX_RECORDING;
+
+	return HAL_OK;
+}
+
+// Process() writes what is buffered, then the state goes back to idle
+void Blackbox::Stop() {
+	if (this->state == BLACKBOX_RECORDING)
+		this->state = BLACKBOX_STOPPING;
+}
+
+// takes tens of seconds on big chips, Process() tells when it is done
+HAL_StatusTypeDef Blackbox::Erase() {
+	if (this->storage == NULL)
+		return HAL_ERROR;
+
+	if (this->state != BLACKBOX_IDLE && this->state != BLACKBOX_FULL)
+		return HAL_BUSY;
+
+	if (this->storage->Start_Erase() != HAL_OK)
+		return HAL_ERROR;
+
+	this->address = 0;
+	this->state = BLACKBOX_ERASING;
+
+	return HAL_OK;
+}
+
+void Blackbox::queue_page() {
+	this->queued = true;
+	this->queued_size = this->filled;
+	this->filling ^= 1;
+	this->filled = 0;
+}
+
+void Blackbox::Record(const Telemetry::Snapshot& snapshot) {
+	if (this->state != BLACKBOX_RECORDING)
+		return;
+
+	uint16_t size = Telemetry::Encode(snapshot, this->layout, this->sequence, this->frame);
+	this->sequence++;
+
+	uint16_t first = PAGE_SIZE - this->filled;
+
+	if (size < first)
+		first = size;
+
+	if (this->filled + size >= PAGE_SIZE) {
+		// filling page gets queued, the page after it has to exist and be free
+		uint32_t next_address = this->address + (this->queued ? 2 : 1) * PAGE_SIZE;
+
+		if (next_address + PAGE_SIZE > this->storage->Get_Size()) {
+			this->dropped++;
+			this->state = BLACKBOX_STOPPING;
+			return;
+		}
+
+		if (this->queued) {
+			this->dropped++;
+			return;
+		}
+	}
+
+	memcpy(this->pages[this->filling] + this->filled, this->frame, first);
+	this->filled += first;
+
+	if (this->filled == PAGE_SIZE) {
+		this->queue_page();
+
+		memcpy(this->pages[this->filling], this->frame + first, size - first);
+		this->filled = size - first;
+	}
+
+	this->frames++;
+}
+
+void Blackbox::Skip(uint32_t count) {
+	if (this->state != BLACKBOX_RECORDING)
+		return;
+
+	this->sequence += count;
+	this->dropped += count;
+}
+
+void Blackbox::Process() {
+	if (this->storage == NULL)
+		return;
+
+	if (this->programming) {
+		if (this->storage->Is_Busy())
+			return;
+
+		this->programming = false;
+		this->queued = false;
+		this->address += PAGE_SIZE;
+	}
+
+	if (this->queued) {
+		if (this->storage->Is_Busy())
+			return;
+
+		if (this->storage->Start_Program(this->address, this->pages[this->filling ^ 1], this->queued_size) == HAL_OK)
+			this->programming = true;
+
+		return;
+	}
+
+	switch (this->state) {
+	case BLACKBOX_STOPPING:
+		if (this->filled > 0) {
+			this->queue_page();
+			break;
+		}
+
+		this->state = this->address + PAGE_SIZE <= this->storage->Get_Size() ? BLACKBOX_IDLE : BLACKBOX_FULL;
+		break;
+	case BLACKBOX_ERASING:
+		if (!this->storage->Is_Busy())
+			this->state = BLACKBOX_IDLE;
+		break;
+	default:
+		break;
+	}
+}
+
+uint32_t Blackbox::Get_Size() {
+	return this->address;
+}
+
+uint32_t Blackbox::Get_Capacity() {
+	return this->storage != NULL ? this->storage->Get_Size() : 0;
+}
+
+HAL_StatusTypeDef Blackbox::Read(uint32_t offset, uint8_t *data, uint16_t size) {
+	if (this->storage == NULL || offset + size > this->address)
+		return HAL_ERROR;
+
+	if (this->state != BLACKBOX_IDLE && this->state != BLACKBOX_FULL)
+		return HAL_BUSY;
+
+	return this->storage->Read(offset, data, size);
+}
+
+uint32_t Blackbox::Get_Frames() {
+	return this->frames;
+}
+
+uint32_t Blackbox::Get_Dropped() {
+	return this->dropped;
+}
+
+} /* namespace flyhero */
@@ -6,6 +6,7 @@
  */
 
 #include "Logger.h"
+#include "CRC_Calculator.h"
 
 namespace flyhero {
 
@@ -21,6 +22,8 @@ extern "C" {
 	}
 }
 
+static Timing_Probe send_probe("logger", 50);
+
 Logger& Logger::Instance() {
 	static Logger instance;
 
@@ -28,7 +31,10 @@ Logger& Logger::Instance() {
 }
 
 Logger::Logger() {
-	this->last_ticks = 0;
+	this->sequence = 0;
+
+	Telemetry::Build_Layout(0, this->layout);
+	Telemetry_Capture::Instance().Attach(this->reader);
 }
 
 HAL_StatusTypeDef Logger::Init() {
@@ -84,7 +90,8 @@ HAL_StatusTypeDef Logger::Init() {
 	HAL_NVIC_SetPriority(USART2_IRQn, 1, 0);
 	HAL_NVIC_EnableIRQ(USART2_IRQn);
 
-	return HAL_OK;
+	// frames carry CRC of the CRC unit
+	return CRC_Calculator::Instance().Init();
 }
 
 HAL_StatusTypeDef Logger::Print(uint8_t *data, uint16_t len) {
@@ -99,197 +106,82 @@ UART_HandleTypeDef* Logger::Get_UART_Handle() {
 	return &this->huart;
 }
 
+// frames describe themselves, nothing has to be announced
 HAL_StatusTypeDef Logger::Set_Data_Type(Log_Type log_type, Data_Type data_type) {
 	this->log_type = log_type;
 	this->data_type = data_type;
 	this->log = (data_type != 0);
 
-	if (!this->log)
-		return HAL_OK;
+	Telemetry::Build_Layout(data_type, this->layout);
 
-	if (this->log_type == UART) {
-		uint16_t header = data_type;
-
-		uint8_t tmp[3];
-		tmp[0] = 0x33;
-		tmp[1] = header >> 8;
-		tmp[2] = header & 0xFF;
-
-		return this->Print(tmp, 3);
-	}
-	else if (this->log_type == WiFi)
-		return HAL_OK;
-
-	return HAL_ERROR;
+	return HAL_OK;
 }
 
 HAL_StatusTypeDef Logger::Send_Data() {
-	if (this->log) {
-		uint8_t buffer_pos = 0;
-		MPU6050::Raw_Data raw_accel, raw_gyro;
-		float roll, pitch, yaw;
-		int16_t raw_temp;
-
-		if (this->log_type == WiFi) {
-			static uint8_t counter = 0;
-			counter++;
-
-			if (counter != 5)
-				return HAL_OK;
-
-			counter = 0;
-		}
-
-		if (this->data_type & Accel_All)
-			MPU6050::Instance().Get_Raw_Accel(raw_accel);
-		if (this->data_type & Gyro_All)
-			MPU6050::Instance().Get_Raw_Gyro(raw_gyro);
-		if (this->data_type & Temperature)
-			MPU6050::Instance().Get_Raw_Temp(raw_temp);
-		if (this->data_type & Euler_All)
-			MPU6050::Instance().Get_Euler(roll, pitch, yaw);
-
-		this->data_buffer[0] = 0x33;
-		buffer_pos++;
-
-		if (this->data_type & Accel_X) {
-			this->data_buffer[buffer_pos] = raw_accel.x >> 8;
-			this->data_buffer[buffer_pos + 1] = raw_accel.x & 0xFF;
-
-			buffer_pos += 2;
-		}
-		if (this->data_type & Accel_Y) {
-			this->data_buffer[buffer_pos] = raw_accel.y >> 8;
-			this->data_buffer[buffer_pos + 1] = raw_accel.y & 0xFF;
-
-			buffer_pos += 2;
-		}
-		if (this->data_type & Accel_Z) {
-			this->data_buffer[buffer_pos] = raw_accel.z >> 8;
-			this->data_buffer[buffer_pos + 1] = raw_accel.z & 0xFF;
-
-			buffer_pos += 2;
-		}
-		if (this->data_type & Gyro_X) {
-			this->data_buffer[buffer_pos] = raw_gyro.x >> 8;
-			this->data_buffer[buffer_pos + 1] = raw_gyro.x & 0xFF;
+	send_probe.Start();
 
-			buffer_pos += 2;
-		}
-		if (this->data_type & Gyro_Y) {
-			this->data_buffer[buffer_pos] = raw_gyro.y >> 8;
-			this->data_buffer[buffer_pos + 1] = raw_gyro.y & 0xFF;
+	HAL_StatusTypeDef status = this->send_data();
 
-			buffer_pos += 2;
-		}
-		if (this->data_type & Gyro_Z) {
-			this->data_buffer[buffer_pos] = raw_gyro.z >> 8;
-			this->data_buffer[buffer_pos + 1] = raw_gyro.z & 0xFF;
+	send_probe.Stop();
 
-			buffer_pos += 2;
-		}
-		if (this->data_type & Temperature) {
-			this->data_buffer[buffer_pos] = raw_temp >> 8;
-			this->data_buffer[buffer_pos + 1] = raw_temp & 0xFF;
+	return status;
+}
 
-			buffer_pos += 2;
-		}
-		if (this->data_type & Roll) {
-			uint8_t *tmp = (uint8_t*)&roll;
-			this->data_buffer[buffer_pos] = tmp[3];
-			this->data_buffer[buffer_pos + 1] = tmp[2];
-			this->data_buffer[buffer_pos + 2] = tmp[1];
-			this->data_buffer[buffer_pos + 3] = tmp[0];
-
-			buffer_pos += 4;
-		}
-		if (this->data_type & Pitch) {
-			uint8_t *tmp = (uint8_t*)&pitch;
-			this->data_buffer[buffer_pos] = tmp[3];
-			this->data_buffer[buffer_pos + 1] = tmp[2];
-			this->data_buffer[buffer_pos + 2] = tmp[1];
-			this->data_buffer[buffer_pos + 3] = tmp[0];
-
-			buffer_pos += 4;
-		}
-		if (this->data_type & Yaw) {
-			uint8_t *tmp = (uint8_t*)&yaw;
-			this->data_buffer[buffer_pos] = tmp[3];
-			this->data_buffer[buffer_pos + 1] = tmp[2];
-			this->data_buffer[buffer_pos + 2] = tmp[1];
-			this->data_buffer[buffer_pos + 3] = tmp[0];
-
-			buffer_pos += 4;
-		}
-		if (this->data_type & Throttle) {
-			uint16_t throttle = Motors_Controller::Instance().Get_Throttle();
-			this->data_buffer[buffer_pos] = throttle >> 8;
-			this->data_buffer[buffer_pos + 1] = throttle & 0xFF;
+// Snapshots pushed since the last run, the blackbox takes all of them,
+// the link only the newest one as often as it can carry it.
+HAL_StatusTypeDef Logger::send_data() {
+	Telemetry_Capture& capture = Telemetry_Capture::Instance();
+	Blackbox& blackbox = Blackbox::Instance();
+	bool record = blackbox.Is_Recording();
 
-			buffer_pos += 2;
-		}
-		if (this->data_type & Motor_FL) {
-			uint16_t FL = Motors_Controller::Instance().Get_Motor_FL();
-			this->data_buffer[buffer_pos] = FL >> 8;
-			this->data_buffer[buffer_pos + 1] = FL & 0xFF;
+	// nobody waits for old snapshots
+	if (!this->log && !record) {
+		capture.Attach(this->reader);
+		return HAL_OK;
+	}
 
-			buffer_pos += 2;
-		}
-		if (this->data_type & Motor_FR) {
-			uint16_t FR = Motors_Controller::Instance().Get_Motor_FR();
-			this->data_buffer[buffer_pos] = FR >> 8;
-			this->data_buffer[buffer_pos + 1] = FR & 0xFF;
+	Telemetry::Snapshot snapshot;
+	uint32_t fields = this->data_type | (record ? blackbox.Get_Data_Type() : 0);
+	uint32_t lost = this->reader.lost;
+	bool read = false;
 
-			buffer_pos += 2;
-		}
-		if (this->data_type & Motor_BL) {
-			uint16_t BL = Motors_Controller::Instance().Get_Motor_BL();
-			this->data_buffer[buffer_pos] = BL >> 8;
-			this->data_buffer[buffer_pos + 1] = BL & 0xFF;
+	while (capture.Read(this->reader, snapshot, fields)) {
+		read = true;
 
-			buffer_pos += 2;
-		}
-		if (this->data_type & Motor_BR) {
-			uint16_t BR = Motors_Controller::Instance().Get_Motor_BR();
-			this->data_buffer[buffer_pos] = BR >> 8;
-			this->data_buffer[buffer_pos + 1] = BR & 0xFF;
+		if (!record)
+			continue;
 
-			buffer_pos += 2;
+		if (this->reader.lost != lost) {
+			blackbox.Skip(this->reader.lost - lost);
+			lost = this->reader.lost;
 		}
 
-		if (this->last_ticks == 0) {
-			this->last_ticks = Timer::Get_Tick_Count();
-
-			this->data_buffer[buffer_pos] = 0;
-			this->data_buffer[buffer_pos + 1] = 0;
+		blackbox.Record(snapshot);
+	}
 
-			buffer_pos += 2;
-		}
-		else {
-			uint16_t dt = Timer::Get_Tick_Count() - this->last_ticks;
-			this->last_ticks = Timer::Get_Tick_Count();
+	if (!this->log || !read)
+		return HAL_OK;
 
-			this->data_buffer[buffer_pos] = dt >> 8;
-			this->data_buffer[buffer_pos + 1] = dt & 0xFF;
+	if (this->log_type == WiFi) {
+		static uint8_t counter = 0;
+		counter++;
 
-			buffer_pos += 2;
-		}
+		if (counter != 5)
+			return HAL_OK;
 
+		counter = 0;
+	}
 
-		this->data_buffer[buffer_pos] = 0;
+	uint16_t size = Telemetry::Encode(snapshot, this->layout, this->sequence, this->data_buffer);
 
-		for (uint8_t i = 1; i < buffer_pos; i++)
-			this->data_buffer[buffer_pos] ^= this->data_buffer[i];
+	this->sequence++;
 
-		if (this->log_type == UART)
-			return this->Print(this->data_buffer, buffer_pos + 1);
-		else if (this->log_type == WiFi)
-			return ESP::Instance().Get_Connection('4')->Connection_Send_Begin(this->data_buffer, buffer_pos + 1);
+	if (this->log_type == UART)
+		return this->Print(this->data_buffer, size);
+	else if (this->log_type == WiFi)
+		return ESP::Instance().Get_Connection('4')->Connection_Send_Begin(this->data_buffer, size);
 
-		return HAL_ERROR;
-	}
-	else
-		return HAL_OK;
+	return HAL_ERROR;
 }
 
 }
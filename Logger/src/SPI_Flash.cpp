@@ -0,0 +1,263 @@
+/*
+ * SPI_Flash.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "SPI_Flash.h"
+#include "Config.h"
+
+namespace flyhero {
+
+// vector follows FLASH_SPI_DMA_TX in Config.h
+extern "C" {
+	void DMA1_Stream4_IRQHandler(void)
+	{
+		HAL_DMA_IRQHandler(SPI_Flash::Instance().Get_DMA_Tx_Handle());
+	}
+
+	// only page data are sent without receiving
+	void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi) {
+		if (hspi == SPI_Flash::Instance().Get_SPI_Handle())
+			SPI_Flash::Instance().Transfer_Complete();
+	}
+}
+
+SPI_Flash& SPI_Flash::Instance() {
+	static SPI_Flash instance;
+
+	return instance;
+}
+
+SPI_Flash::SPI_Flash() {
+	this->size = 0;
+	this->transferring = false;
+	this->working = false;
+}
+
+DMA_HandleTypeDef* SPI_Flash::Get_DMA_Tx_Handle() {
+	return &this->hdma_spi_tx;
+}
+
+SPI_HandleTypeDef* SPI_Flash::Get_SPI_Handle() {
+	return &this->hspi;
+}
+
+HAL_StatusTypeDef SPI_Flash::spi_init() {
+	GPIO_InitTypeDef GPIO_InitStructure;
+
+	if (__GPIOB_IS_CLK_DISABLED())
+		__GPIOB_CLK_ENABLE();
+	if (__SPI2_IS_CLK_DISABLED())
+		__SPI2_CLK_ENABLE();
+	if (__DMA1_IS_CLK_DISABLED())
+		__DMA1_CLK_ENABLE();
+
+	// deselect before the pin becomes an output
+	HAL_GPIO_WritePin(FLASH_CS_BASE, FLASH_CS_PIN, GPIO_PIN_SET);
+
+	GPIO_InitStructure.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStructure.Pull = GPIO_NOPULL;
+	GPIO_InitStructure.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	GPIO_InitStructure.Alternate = GPIO_AF5_SPI2;
+
+	GPIO_InitStructure.Pin = FLASH_SCK_PIN;
+	HAL_GPIO_Init(FLASH_SCK_BASE, &GPIO_InitStructure);
+
+	GPIO_InitStructure.Pin = FLASH_MISO_PIN;
+	HAL_GPIO_Init(FLASH_MISO_BASE, &GPIO_InitStructure);
+
+	GPIO_InitStructure.Pin = FLASH_MOSI_PIN;
+	HAL_GPIO_Init(FLASH_MOSI_BASE, &GPIO_InitStructure);
+
+	GPIO_InitStructure.Pin = FLASH_CS_PIN;
+	GPIO_InitStructure.Mode = GPIO_MODE_OUTPUT_PP;
+	GPIO_InitStructure.Pull = GPIO_PULLUP;
+	HAL_GPIO_Init(FLASH_CS_BASE, &GPIO_InitStructure);
+
+	// mode 0
+	this->hspi.Instance = FLASH_SPI;
+	this->hspi.Init.Mode = SPI_MODE_MASTER;
+	this->hspi.Init.Direction = SPI_DIRECTION_2LINES;
+	this->hspi.Init.DataSize = SPI_DATASIZE_8BIT;
+	this->hspi.Init.CLKPolarity = SPI_POLARITY_LOW;
+	this->hspi.Init.CLKPhase = SPI_PHASE_1EDGE;
+	this->hspi.Init.NSS = SPI_NSS_SOFT;
+	this->hspi.Init.BaudRatePrescaler = this->SPI_PRESCALER;
+	this->hspi.Init.FirstBit = SPI_FIRSTBIT_MSB;
+	this->hspi.Init.TIMode = SPI_TIMODE_DISABLE;
+	this->hspi.Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
+	this->hspi.Init.CRCPolynomial = 7;
+	if (HAL_SPI_Init(&this->hspi))
+		return HAL_ERROR;
+
+	this->hdma_spi_tx.Instance = FLASH_SPI_DMA_TX;
+	this->hdma_spi_tx.Init.Channel = FLASH_SPI_DMA_CHANNEL;
+	this->hdma_spi_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+	this->hdma_spi_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+	this->hdma_spi_tx.Init.MemInc = DMA_MINC_ENABLE;
+	this->hdma_spi_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	this->hdma_spi_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	this->hdma_spi_tx.Init.Mode = DMA_NORMAL;
+	this->hdma_spi_tx.Init.Priority = DMA_PRIORITY_LOW;
+	this->hdma_spi_tx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+	if (HAL_DMA_Init(&this->hdma_spi_tx))
+		return HAL_ERROR;
+
+	__HAL_LINKDMA(&this->hspi, hdmatx, this->hdma_spi_tx);
+
+	// below the IMU, a page may wait a while
+	HAL_NVIC_SetPriority(DMA1_Stream4_IRQn, 3, 0);
+	HAL_NVIC_EnableIRQ(DMA1_Stream4_IRQn);
+
+	return HAL_OK;
+}
+
+void SPI_Flash::spi_select(bool select) {
+	HAL_GPIO_WritePin(FLASH_CS_BASE, FLASH_CS_PIN, select ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+// leaves the chip selected so data can follow
+HAL_StatusTypeDef SPI_Flash::command(uint8_t command, uint32_t address, bool with_address) {
+	uint8_t tx[4] = { command, uint8_t(address >> 16), uint8_t(address >> 8), uint8_t(address) };
+
+	this->spi_select(true);
+
+	return HAL_SPI_Transmit(&this->hspi, tx, with_address ? 4 : 1, this->SPI_TIMEOUT);
+}
+
+HAL_StatusTypeDef SPI_Flash::write_enable() {
+	HAL_StatusTypeDef status = this->command(this->CMD_WRITE_ENABLE, 0, false);
+
+	this->spi_select(false);
+
+	return status;
+}
+
+HAL_StatusTypeDef SPI_Flash::read_status(uint8_t& status) {
+	uint8_t tx[2] = { this->CMD_READ_STATUS, 0 };
+	uint8_t rx[2];
+
+	this->spi_select(true);
+	HAL_StatusTypeDef ret = HAL_SPI_TransmitReceive(&this->hspi, tx, rx, 2, this->SPI_TIMEOUT);
+	this->spi_select(false);
+
+	status = rx[1];
+
+	return ret;
+}
+
+// chip is recognized by its JEDEC ID, the last byte is log2 of its size
+HAL_StatusTypeDef SPI_Flash::Init() {
+	uint8_t tx[4] = { this->CMD_JEDEC_ID, 0, 0, 0 };
+	uint8_t rx[4];
+
+	if (this->spi_init())
+		return HAL_ERROR;
+
+	this->spi_select(true);
+	HAL_StatusTypeDef status = HAL_SPI_TransmitReceive(&this->hspi, tx, rx, 4, this->SPI_TIMEOUT);
+	this->spi_select(false);
+
+	if (status != HAL_OK)
+		return status;
+
+	// no chip reads all zeros or ones
+	if (rx[1] == 0x00 || rx[1] == 0xFF || rx[3] < this->MIN_CAPACITY || rx[3] > this->MAX_CAPACITY)
+		return HAL_ERROR;
+
+	this->size = uint32_t(1) << rx[3];
+
+	return HAL_OK;
+}
+
+uint32_t SPI_Flash::Get_Size() {
+	return this->size;
+}
+
+void SPI_Flash::Transfer_Complete() {
+	this->spi_select(false);
+	this->transferring = false;
+}
+
+bool SPI_Flash::Is_Busy() {
+	uint8_t status;
+
+	if (this->transferring)
+		return true;
+
+	if (!this->working)
+		return false;
+
+	if (this->read_status(status) != HAL_OK)
+		return true;
+
+	this->working = (status & this->STATUS_BUSY) != 0;
+
+	return this->working;
+}
+
+// 0.7 ms typical, 3 ms at most for a whole page
+HAL_StatusTypeDef SPI_Flash::Start_Program(uint32_t address, const uint8_t *data, uint16_t size) {
+	if (this->Is_Busy())
+		return HAL_BUSY;
+
+	if (size == 0 || size > PAGE_SIZE || (address & (PAGE_SIZE - 1)) != 0 || address + size > this->size)
+		return HAL_ERROR;
+
+	if (this->write_enable())
+		return HAL_ERROR;
+
+	if (this->command(this->CMD_PAGE_PROGRAM, address, true)) {
+		this->spi_select(false);
+		return HAL_ERROR;
+	}
+
+	this->transferring = true;
+	this->working = true;
+
+	if (HAL_SPI_Transmit_DMA(&this->hspi, const_cast<uint8_t*>(data), size)) {
+		this->spi_select(false);
+		this->transferring = false;
+		return HAL_ERROR;
+	}
+
+	return HAL_OK;
+}
+
+// 40 s typical for 16 MB
+HAL_StatusTypeDef SPI_Flash::Start_Erase() {
+	if (this->Is_Busy())
+		return HAL_BUSY;
+
+	if (this->write_enable())
+		return HAL_ERROR;
+
+	HAL_StatusTypeDef status = this->command(this->CMD_CHIP_ERASE, 0, false);
+	this->spi_select(false);
+
+	if (status == HAL_OK)
+		this->working = true;
+
+	return status;
+}
+
+HAL_StatusTypeDef SPI_Flash::Read(uint32_t address, uint8_t *data, uint16_t size) {
+	if (this->Is_Busy())
+		return HAL_BUSY;
+
+	if (address + size > this->size)
+		return HAL_ERROR;
+
+	HAL_StatusTypeDef status = this->command(this->CMD_READ_DATA, address, true);
+
+	if (status == HAL_OK)
+		status = HAL_SPI_Receive(&this->hspi, data, size, this->SPI_TIMEOUT);
+
+	this->spi_select(false);
+
+	return status;
+}
+
+} /* namespace flyhero */
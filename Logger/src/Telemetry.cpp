@@ -0,0 +1,132 @@
+/*
+ * Telemetry.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <string.h>
+#include "Telemetry.h"
+#include "CRC_Calculator.h"
+
+namespace flyhero {
+
+uint8_t Telemetry::Get_Type_Size(Field_Type type) {
+	switch (type) {
+	case TYPE_UINT8:
+	case TYPE_INT8:
+		return 1;
+	case TYPE_UINT16:
+	case TYPE_INT16:
+		return 2;
+	case TYPE_UINT32:
+	case TYPE_INT32:
+	case TYPE_FLOAT:
+		return 4;
+	default:
+		return 0;
+	}
+}
+
+static_assert(sizeof(Telemetry::Snapshot) <= 0xFF, "snapshot offsets do not fit descriptors");
+
+// frame order, adding a field is a line here and a member of Snapshot
+const Telemetry::Field_Descriptor Telemetry::FIELDS[Telemetry::FIELD_COUNT] = {
+	{ FIELD_ACCEL_X, TYPE_INT16, 1, offsetof(Snapshot, accel[0]), FIELD_ACCEL_X },
+	{ FIELD_ACCEL_Y, TYPE_INT16, 1, offsetof(Snapshot, accel[1]), FIELD_ACCEL_Y },
+	{ FIELD_ACCEL_Z, TYPE_INT16, 1, offsetof(Snapshot, accel[2]), FIELD_ACCEL_Z },
+	{ FIELD_GYRO_X, TYPE_INT16, 1, offsetof(Snapshot, gyro[0]), FIELD_GYRO_X },
+	{ FIELD_GYRO_Y, TYPE_INT16, 1, offsetof(Snapshot, gyro[1]), FIELD_GYRO_Y },
+	{ FIELD_GYRO_Z, TYPE_INT16, 1, offsetof(Snapshot, gyro[2]), FIELD_GYRO_Z },
+	{ FIELD_TEMPERATURE, TYPE_INT16, 1, offsetof(Snapshot, temperature), FIELD_TEMPERATURE },
+	{ FIELD_ROLL, TYPE_FLOAT, 1, offsetof(Snapshot, euler[0]), FIELD_ROLL },
+	{ FIELD_PITCH, TYPE_FLOAT, 1, offsetof(Snapshot, euler[1]), FIELD_PITCH },
+	{ FIELD_YAW, TYPE_FLOAT, 1, offsetof(Snapshot, euler[2]), FIELD_YAW },
+	{ FIELD_THROTTLE, TYPE_UINT16, 1, offsetof(Snapshot, throttle), FIELD_THROTTLE },
+	{ FIELD_MOTOR_FL, TYPE_UINT16, 1, offsetof(Snapshot, motors[0]), FIELD_MOTOR_FL },
+	{ FIELD_MOTOR_FR, TYPE_UINT16, 1, offsetof(Snapshot, motors[1]), FIELD_MOTOR_FR },
+	{ FIELD_MOTOR_BL, TYPE_UINT16, 1, offsetof(Snapshot, motors[2]), FIELD_MOTOR_BL },
+	{ FIELD_MOTOR_BR, TYPE_UINT16, 1, offsetof(Snapshot, motors[3]), FIELD_MOTOR_BR },
+	{ FIELD_TIMING, TYPE_UINT32, 4, offsetof(Snapshot, timing), FIELD_TIMING },
+	{ FIELD_TIMING_HISTOGRAM, TYPE_UINT16, TIMING_BINS, offsetof(Snapshot, timing_histogram), FIELD_TIMING },
+	{ FIELD_VIBRATION_ACCEL, TYPE_UINT16, 6, offsetof(Snapshot, vibration_accel), FIELD_VIBRATION_ACCEL },
+	{ FIELD_VIBRATION_GYRO, TYPE_UINT16, 6, offsetof(Snapshot, vibration_gyro), FIELD_VIBRATION_GYRO },
+	{ FIELD_CLIPPING, TYPE_UINT16, 6, offsetof(Snapshot, clips), FIELD_CLIPPING },
+	{ FIELD_SAMPLE_AGE, TYPE_UINT16, 1, offsetof(Snapshot, sample_age), FIELD_SAMPLE_AGE }
+};
+
+// runs when the mask changes, not per frame
+void Telemetry::Build_Layout(uint32_t fields, Layout& layout) {
+	layout.count = 0;
+	layout.payload = 0;
+
+	for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+		const Field_Descriptor& field = Telemetry::FIELDS[i];
+
+		if (!(fields & (1 << field.enable)))
+			continue;
+
+		Layout::Entry& entry = layout.entries[layout.count];
+
+		entry.id = field.id;
+		entry.type_byte = Telemetry::Get_Type_Byte(field.type, field.count);
+		entry.offset = field.offset;
+		entry.size = Telemetry::Get_Type_Size(field.type) * field.count;
+
+		layout.payload += 2 + entry.size;
+		layout.count++;
+	}
+}
+
+// Sizes known at compile time become plain loads and stores,
+// a library call per field would cost more than the copy itself.
+void Telemetry::copy_values(uint8_t *destination, const uint8_t *source, uint8_t size) {
+	switch (size) {
+	case 2:
+		memcpy(destination, source, 2);
+		break;
+	case 4:
+		memcpy(destination, source, 4);
+		break;
+	case 12:
+		memcpy(destination, source, 12);
+		break;
+	case 16:
+		memcpy(destination, source, 16);
+		break;
+	default:
+		memcpy(destination, source, size);
+		break;
+	}
+}
+
+// Values are copied as they are in memory, little endian. CRC unit is
+// shared with Flash_Storage, both only run from the main loop.
+uint16_t Telemetry::Encode(const Snapshot& snapshot, const Layout& layout, uint16_t sequence, uint8_t *buffer) {
+	const uint8_t *source = reinterpret_cast<const uint8_t*>(&snapshot);
+	uint8_t *pos = buffer + HEADER_SIZE;
+
+	for (uint8_t i = 0; i < layout.count; i++) {
+		const Layout::Entry& entry = layout.entries[i];
+
+		pos[0] = entry.id;
+		pos[1] = entry.type_byte;
+		Telemetry::copy_values(pos + 2, source + entry.offset, entry.size);
+
+		pos += 2 + entry.size;
+	}
+
+	buffer[0] = SYNC_1;
+	buffer[1] = SYNC_2;
+	buffer[2] = VERSION;
+	buffer[3] = layout.payload;
+	memcpy(buffer + 4, &sequence, 2);
+	memcpy(buffer + 6, &snapshot.timestamp, 8);
+
+	uint32_t crc = CRC_Calculator::Instance().Calculate(buffer, uint32_t(pos - buffer));
+	memcpy(pos, &crc, 4);
+
+	return uint16_t(pos + TRAILER_SIZE - buffer);
+}
+
+} /* namespace flyhero */
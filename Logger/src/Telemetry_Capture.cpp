@@ -0,0 +1,130 @@
+/*
+ * Telemetry_Capture.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Telemetry_Capture.h"
+
+namespace flyhero {
+
+Telemetry_Capture& Telemetry_Capture::Instance() {
+	static Telemetry_Capture instance;
+
+	return instance;
+}
+
+Telemetry_Capture::Telemetry_Capture() {
+	this->last_ticks = 0;
+	this->timestamp = 0;
+	this->timing_probe_index = 0;
+}
+
+// one probe per snapshot: index, min, avg, max [ns], histogram counts
+void Telemetry_Capture::read_timing(Telemetry::Snapshot& snapshot) {
+	static_assert(Timing_Probe::HISTOGRAM_BINS == Telemetry::TIMING_BINS, "timing histogram does not fit telemetry");
+
+	uint8_t count = Timing_Probe::Get_Probe_Count();
+
+	if (count == 0)
+		return;
+
+	if (this->timing_probe_index >= count)
+		this->timing_probe_index = 0;
+
+	Timing_Probe *probe = Timing_Probe::Get_Probe(this->timing_probe_index);
+	const Timing_Probe::Statistics& statistics = probe->Get_Statistics();
+	uint32_t ticks_per_us = Timing_Probe::Get_Ticks_Per_us();
+
+	snapshot.timing[0] = this->timing_probe_index;
+	snapshot.timing[1] = uint32_t(uint64_t(statistics.min) * 1000 / ticks_per_us);
+	snapshot.timing[2] = statistics.count != 0 ? uint32_t(statistics.sum * 1000 / statistics.count / ticks_per_us) : 0;
+	snapshot.timing[3] = uint32_t(uint64_t(statistics.max) * 1000 / ticks_per_us);
+
+	for (uint8_t i = 0; i < Timing_Probe::HISTOGRAM_BINS; i++)
+		snapshot.timing_histogram[i] = statistics.histogram[i] > 0xFFFF ? 0xFFFF : statistics.histogram[i];
+
+	this->timing_probe_index++;
+}
+
+// RMS and peak [LSB] of the last window, all zero until the first one is done
+void Telemetry_Capture::read_vibration(Telemetry::Snapshot& snapshot) {
+	Vibration_Monitor::Window window;
+
+	if (!IMU::Instance().Get_Vibration_Monitor().Get_Window(window))
+		return;
+
+	for (uint8_t i = 0; i < 3; i++) {
+		snapshot.vibration_accel[i] = window.rms[i] < 65535 ? uint16_t(window.rms[i] + 0.5f) : 0xFFFF;
+		snapshot.vibration_accel[i + 3] = window.peak[i];
+		snapshot.vibration_gyro[i] = window.rms[i + 3] < 65535 ? uint16_t(window.rms[i + 3] + 0.5f) : 0xFFFF;
+		snapshot.vibration_gyro[i + 3] = window.peak[i + 3];
+	}
+
+	for (uint8_t i = 0; i < Vibration_Monitor::AXES; i++)
+		snapshot.clips[i] = window.clips[i];
+}
+
+// written in place, the slot is published only once complete
+void Telemetry_Capture::Push() {
+	Telemetry::Snapshot& snapshot = this->snapshots.Next();
+	Motors_Controller& motors_controller = Motors_Controller::Instance();
+	IMU& imu = IMU::Instance();
+	IMU::Raw_Data accel, gyro;
+	int16_t temp;
+	uint32_t ticks = Timer::Get_Tick_Count();
+
+	if (this->last_ticks == 0)
+		this->timestamp = ticks;
+	else
+		this->timestamp += uint32_t(ticks - this->last_ticks);
+
+	this->last_ticks = ticks;
+	snapshot.timestamp = this->timestamp;
+
+	// raw values of the sample the control loop consumed, newer ones may be in the ring already
+	imu.Get_Raw_Accel(accel);
+	imu.Get_Raw_Gyro(gyro);
+	imu.Get_Raw_Temp(temp);
+
+	snapshot.accel[0] = accel.x;
+	snapshot.accel[1] = accel.y;
+	snapshot.accel[2] = accel.z;
+	snapshot.gyro[0] = gyro.x;
+	snapshot.gyro[1] = gyro.y;
+	snapshot.gyro[2] = gyro.z;
+	snapshot.temperature = temp;
+
+	imu.Get_Euler(snapshot.euler[0], snapshot.euler[1], snapshot.euler[2]);
+
+	snapshot.throttle = motors_controller.Get_Throttle();
+	snapshot.motors[0] = motors_controller.Get_Motor_FL();
+	snapshot.motors[1] = motors_controller.Get_Motor_FR();
+	snapshot.motors[2] = motors_controller.Get_Motor_BL();
+	snapshot.motors[3] = motors_controller.Get_Motor_BR();
+
+	uint32_t age = motors_controller.Get_Sample_Age();
+	snapshot.sample_age = age > 0xFFFF ? 0xFFFF : age;
+
+	this->snapshots.Commit();
+}
+
+void Telemetry_Capture::Attach(Ring::Reader& reader) {
+	this->snapshots.Attach(reader);
+}
+
+// statistics of ring slots stay zero, Push() does not touch them
+bool Telemetry_Capture::Read(Ring::Reader& reader, Telemetry::Snapshot& snapshot, uint32_t fields) {
+	if (!this->snapshots.Read(reader, snapshot))
+		return false;
+
+	if (fields & (1 << Telemetry::FIELD_TIMING))
+		this->read_timing(snapshot);
+	if (fields & Telemetry::FIELDS_VIBRATION)
+		this->read_vibration(snapshot);
+
+	return true;
+}
+
+} /* namespace flyhero */
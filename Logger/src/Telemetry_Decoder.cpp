@@ -0,0 +1,286 @@
+/*
+ * Telemetry_Decoder.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <string.h>
+#include "Telemetry_Decoder.h"
+
+namespace flyhero {
+
+uint32_t Telemetry_Decoder::crc_table[256];
+
+Telemetry_Decoder::Telemetry_Decoder() {
+	this->Reset();
+}
+
+void Telemetry_Decoder::Reset() {
+	this->size = 0;
+	this->frames = 0;
+	this->errors = 0;
+	this->skipped = 0;
+	this->lost = 0;
+	this->next_sequence = 0;
+	this->frame.field_count = 0;
+}
+
+// polynomial 0x04C11DB7, MSB first, no reflection
+void Telemetry_Decoder::init_crc_table() {
+	for (uint16_t i = 0; i < 256; i++) {
+		uint32_t crc = uint32_t(i) << 24;
+
+		for (uint8_t j = 0; j < 8; j++)
+			crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+
+		Telemetry_Decoder::crc_table[i] = crc;
+	}
+}
+
+// CRC unit shifts words in from the top, so bytes of each little endian
+// word go in from the last one
+uint32_t Telemetry_Decoder::Calculate_CRC(const uint8_t *data, uint32_t size) {
+	if (Telemetry_Decoder::crc_table[1] == 0)
+		Telemetry_Decoder::init_crc_table();
+
+	uint32_t crc = 0xFFFFFFFF;
+
+	for (uint32_t i = 0; i < size; i += 4) {
+		for (uint8_t j = 4; j > 0; j--) {
+			uint8_t byte = i + j - 1 < size ? data[i + j - 1] : 0;
+
+			crc = (crc << 8) ^ Telemetry_Decoder::crc_table[(crc >> 24) ^ byte];
+		}
+	}
+
+	return crc;
+}
+
+void Telemetry_Decoder::drop(uint16_t count) {
+	this->size -= count;
+	memmove(this->buffer, this->buffer + count, this->size);
+}
+
+// Bytes after a bad frame may hold the start of a good one, so only
+// the first byte is dropped and the rest is searched for sync again.
+bool Telemetry_Decoder::Push(uint8_t byte) {
+	this->buffer[this->size] = byte;
+	this->size++;
+
+	while (this->size > 0) {
+		if (this->buffer[0] != Telemetry::SYNC_1) {
+			this->skipped++;
+			this->drop(1);
+			continue;
+		}
+
+		if (this->size < 2)
+			return false;
+
+		if (this->buffer[1] != Telemetry::SYNC_2) {
+			this->skipped++;
+			this->drop(1);
+			continue;
+		}
+
+		if (this->size < 4)
+			return false;
+
+		uint16_t length = Telemetry::HEADER_SIZE + this->buffer[3] + Telemetry::TRAILER_SIZE;
+
+		if (this->size < length)
+			return false;
+
+		if (this->parse()) {
+			uint16_t sequence = this->frame.sequence;
+
+			if (this->frames > 0 && sequence != 0)
+				this->lost += uint16_t(sequence - this->next_sequence);
+
+			this->next_sequence = sequence + 1;
+			this->frames++;
+			this->drop(length);
+
+			return true;
+		}
+
+		this->errors++;
+		this->skipped++;
+		this->drop(1);
+	}
+
+	return false;
+}
+
+// whole frame is in buffer
+bool Telemetry_Decoder::parse() {
+	uint16_t end = Telemetry::HEADER_SIZE + this->buffer[3];
+	uint32_t crc;
+
+	if (this->buffer[2] != Telemetry::VERSION)
+		return false;
+
+	memcpy(&crc, this->buffer + end, 4);
+
+	if (crc != Telemetry_Decoder::Calculate_CRC(this->buffer, end))
+		return false;
+
+	Frame& frame = this->frame;
+
+	frame.version = this->buffer[2];
+	memcpy(&frame.sequence, this->buffer + 4, 2);
+	memcpy(&frame.timestamp, this->buffer + 6, 8);
+	frame.field_count = 0;
+
+	uint16_t pos = Telemetry::HEADER_SIZE;
+
+	while (pos < end) {
+		if (end - pos < 2 || frame.field_count >= MAX_FIELDS)
+			return false;
+
+		Field& field = frame.fields[frame.field_count];
+		uint8_t type = this->buffer[pos + 1] & 0x0F;
+
+		if (type >= Telemetry::TYPE_COUNT)
+			return false;
+
+		field.id = this->buffer[pos];
+		field.type = Telemetry::Field_Type(type);
+		field.count = (this->buffer[pos + 1] >> 4) + 1;
+
+		uint8_t type_size = Telemetry::Get_Type_Size(field.type);
+		const uint8_t *data = this->buffer + pos + 2;
+
+		if (pos + 2 + type_size * field.count > end)
+			return false;
+
+		for (uint8_t i = 0; i < field.count; i++, data += type_size) {
+			switch (field.type) {
+			case Telemetry::TYPE_UINT8:
+				field.values[i] = data[0];
+				break;
+			case Telemetry::TYPE_INT8:
+				field.values[i] = int8_t(data[0]);
+				break;
+			case Telemetry::TYPE_UINT16: {
+				uint16_t value;
+				memcpy(&value, data, 2);
+				field.values[i] = value;
+				break;
+			}
+			case Telemetry::TYPE_INT16: {
+				int16_t value;
+				memcpy(&value, data, 2);
+				field.values[i] = value;
+				break;
+			}
+			case Telemetry::TYPE_UINT32: {
+				uint32_t value;
+				memcpy(&value, data, 4);
+				field.values[i] = value;
+				break;
+			}
+			case Telemetry::TYPE_INT32: {
+				int32_t value;
+				memcpy(&value, data, 4);
+				field.values[i] = value;
+				break;
+			}
+			case Telemetry::TYPE_FLOAT: {
+				float value;
+				memcpy(&value, data, 4);
+				field.values[i] = value;
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+
+		pos += 2 + type_size * field.count;
+		frame.field_count++;
+	}
+
+	return true;
+}
+
+const Telemetry_Decoder::Frame& Telemetry_Decoder::Get_Frame() {
+	return this->frame;
+}
+
+const Telemetry_Decoder::Field* Telemetry_Decoder::Find_Field(uint8_t id) {
+	for (uint8_t i = 0; i < this->frame.field_count; i++) {
+		if (this->frame.fields[i].id == id)
+			return &this->frame.fields[i];
+	}
+
+	return NULL;
+}
+
+uint32_t Telemetry_Decoder::Get_Frames() {
+	return this->frames;
+}
+
+uint32_t Telemetry_Decoder::Get_Errors() {
+	return this->errors;
+}
+
+uint32_t Telemetry_Decoder::Get_Skipped() {
+	return this->skipped;
+}
+
+uint32_t Telemetry_Decoder::Get_Lost() {
+	return this->lost;
+}
+
+const char* Telemetry_Decoder::Get_Field_Name(uint8_t id) {
+	switch (id) {
+	case Telemetry::FIELD_TIMING:
+		return "timing";
+	case Telemetry::FIELD_MOTOR_BR:
+		return "motor_br";
+	case Telemetry::FIELD_MOTOR_BL:
+		return "motor_bl";
+	case Telemetry::FIELD_MOTOR_FR:
+		return "motor_fr";
+	case Telemetry::FIELD_MOTOR_FL:
+		return "motor_fl";
+	case Telemetry::FIELD_THROTTLE:
+		return "throttle";
+	case Telemetry::FIELD_YAW:
+		return "yaw";
+	case Telemetry::FIELD_PITCH:
+		return "pitch";
+	case Telemetry::FIELD_ROLL:
+		return "roll";
+	case Telemetry::FIELD_TEMPERATURE:
+		return "temperature";
+	case Telemetry::FIELD_GYRO_Z:
+		return "gyro_z";
+	case Telemetry::FIELD_GYRO_Y:
+		return "gyro_y";
+	case Telemetry::FIELD_GYRO_X:
+		return "gyro_x";
+	case Telemetry::FIELD_ACCEL_Z:
+		return "accel_z";
+	case Telemetry::FIELD_ACCEL_Y:
+		return "accel_y";
+	case Telemetry::FIELD_ACCEL_X:
+		return "accel_x";
+	case Telemetry::FIELD_VIBRATION_ACCEL:
+		return "vibration_accel";
+	case Telemetry::FIELD_VIBRATION_GYRO:
+		return "vibration_gyro";
+	case Telemetry::FIELD_CLIPPING:
+		return "clipping";
+	case Telemetry::FIELD_SAMPLE_AGE:
+		return "sample_age";
+	case Telemetry::FIELD_TIMING_HISTOGRAM:
+		return "timing_histogram";
+	default:
+		return "unknown";
+	}
+}
+
+} /* namespace flyhero */
@@ -0,0 +1,52 @@
+/*
+ * Attitude_Replay.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef ATTITUDE_REPLAY_H_
+#define ATTITUDE_REPLAY_H_
+
+#include <stdint.h>
+#include "Attitude_Estimator.h"
+
+namespace flyhero {
+
+// Runs recorded IMU data through the attitude estimators and compares them to
+// the recorded truth. "sil attitude <file> <rate>" reads one
+// "gx;gy;gz;ax;ay;az;roll;pitch;yaw[;dt]" line per sample, [deg/s], [g], [deg]
+// and [us], sample period is taken from rate when dt is not recorded.
+class Attitude_Replay {
+public:
+	struct Record {
+		float dt;		// since previous sample [s]
+		float gyro[3];
+		float accel[3];
+		float roll, pitch, yaw;		// truth [deg]
+	};
+
+	struct Result {
+		double tilt_rms;		// [deg]
+		double tilt_max;		// [deg]
+		double yaw_rms;			// [deg]
+		double update_ns;		// host time per update
+	};
+
+private:
+	Attitude_Replay();
+
+	// estimators start level, time for them to find the real attitude
+	static const uint16_t SETTLE_MS = 1000;
+
+	static void step(Attitude_Estimator& estimator, const Record& record, uint32_t index, uint8_t predict_samples);
+
+public:
+	// predict_samples gyro only steps go between full updates
+	static void Run(Attitude_Estimator& estimator, const Record *records, uint32_t count, Result& result, uint8_t predict_samples = 0);
+	static int Compare(const char *file, uint16_t rate);
+};
+
+} /* namespace flyhero */
+
+#endif /* ATTITUDE_REPLAY_H_ */
@@ -0,0 +1,54 @@
+/*
+ * Benchmark.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace flyhero {
+
+// Host micro benchmark. Benchmarks are globals registering themselves the same
+// way as Timing_Probe does, "sil bench [name]" runs all or the matching ones.
+// Optional check runs first and fails the run when it returns false, bytes
+// handled per call add throughput to the result.
+class Benchmark {
+public:
+	static const uint8_t MAX_BENCHMARKS = 64;
+
+private:
+	Benchmark(Benchmark const&);
+	Benchmark& operator=(Benchmark const&);
+
+	static const uint8_t REPEATS = 5;
+
+	static Benchmark *benchmarks[MAX_BENCHMARKS];
+	static uint8_t benchmark_count;
+
+	const char *name;
+	void (*function)(uint32_t iterations);
+	bool (*check)();
+	uint32_t iterations;
+	uint32_t bytes;
+
+public:
+	Benchmark(const char *name, void (*function)(uint32_t iterations), uint32_t iterations, bool (*check)() = NULL,
+			uint32_t bytes = 0);
+
+	// prevents compiler from optimizing the measured code away
+	static volatile float Sink;
+
+	static int Run_All(const char *filter);
+
+	bool Run();
+	const char* Get_Name();
+};
+
+} /* namespace flyhero */
+
+#endif /* BENCHMARK_H_ */
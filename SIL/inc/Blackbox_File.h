@@ -0,0 +1,47 @@
+/*
+ * Blackbox_File.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef BLACKBOX_FILE_H_
+#define BLACKBOX_FILE_H_
+
+#include <stdio.h>
+#include "Blackbox_Storage.h"
+
+namespace flyhero {
+
+// Blackbox flash as a host file, bytes past its end are erased. Programming
+// ANDs into what is there and keeps the storage busy for as long as a page
+// takes on W25Q parts, in virtual time, so the blackbox meets the same
+// back pressure as on target.
+class Blackbox_File : public Blackbox_Storage {
+private:
+	Blackbox_File(Blackbox_File const&);
+	Blackbox_File& operator=(Blackbox_File const&);
+
+	static const uint32_t PAGE_PROGRAM_US = 700;
+	static const uint32_t ERASE_US = 100000;
+
+	FILE *file;
+	uint32_t size;
+	uint64_t busy_until_us;
+
+public:
+	// file is created when NULL, kept afterwards otherwise
+	Blackbox_File(const char *path, uint32_t size);
+	~Blackbox_File();
+
+	HAL_StatusTypeDef Init();
+	uint32_t Get_Size();
+	bool Is_Busy();
+	HAL_StatusTypeDef Start_Program(uint32_t address, const uint8_t *data, uint16_t size);
+	HAL_StatusTypeDef Start_Erase();
+	HAL_StatusTypeDef Read(uint32_t address, uint8_t *data, uint16_t size);
+};
+
+} /* namespace flyhero */
+
+#endif /* BLACKBOX_FILE_H_ */
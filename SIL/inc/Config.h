@@ -0,0 +1,58 @@
+/*
+ * Config.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include <stm32f4xx_hal.h>
+
+namespace flyhero {
+
+/* ##########################         IMU         ########################## */
+
+static I2C_TypeDef *const IMU_I2C 			= I2C1;
+// SCL
+static const uint32_t IMU_SCL_PIN 			= GPIO_PIN_8;
+static GPIO_TypeDef *const IMU_SCL_BASE 	= GPIOB;
+// SDA
+static const uint32_t IMU_SDA_PIN 			= GPIO_PIN_9;
+static GPIO_TypeDef *const IMU_SDA_BASE 	= GPIOB;
+
+// DMA
+static DMA_Stream_TypeDef *const IMU_DMA 	= DMA1_Stream5;
+static const uint32_t IMU_DMA_CHANNEL		= DMA_CHANNEL_1;
+
+// INT
+static GPIO_TypeDef *const IMU_INT_BASE		= GPIOB;
+static const uint32_t IMU_INT_PIN			= GPIO_PIN_1;
+
+/* SPI sensors (MPU6000, ICM-20602), INT above is shared */
+
+static SPI_TypeDef *const IMU_SPI			= SPI1;
+// SCK, AF5 remap, PA5 - PA7 drive the LEDs
+static const uint32_t IMU_SCK_PIN			= GPIO_PIN_3;
+static GPIO_TypeDef *const IMU_SCK_BASE		= GPIOB;
+// MISO
+static const uint32_t IMU_MISO_PIN			= GPIO_PIN_4;
+static GPIO_TypeDef *const IMU_MISO_BASE	= GPIOB;
+// MOSI
+static const uint32_t IMU_MOSI_PIN			= GPIO_PIN_5;
+static GPIO_TypeDef *const IMU_MOSI_BASE	= GPIOB;
+// CS, driven by software
+static const uint32_t IMU_CS_PIN			= GPIO_PIN_4;
+static GPIO_TypeDef *const IMU_CS_BASE		= GPIOA;
+
+// DMA
+static DMA_Stream_TypeDef *const IMU_SPI_DMA_RX	= DMA2_Stream0;
+static DMA_Stream_TypeDef *const IMU_SPI_DMA_TX	= DMA2_Stream3;
+static const uint32_t IMU_SPI_DMA_CHANNEL	= DMA_CHANNEL_3;
+
+// IRQ handlers are in IMU.cpp and in the backend sources
+
+}
+
+#endif /* CONFIG_H_ */
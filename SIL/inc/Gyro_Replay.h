@@ -0,0 +1,32 @@
+/*
+ * Gyro_Replay.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef GYRO_REPLAY_H_
+#define GYRO_REPLAY_H_
+
+#include <stdint.h>
+
+namespace flyhero {
+
+// Feeds recorded gyro data through Dynamic_Notch the same way MPU6050 does,
+// "sil analyze <file> <rate>" reads one "gx;gy;gz" line [deg/s] per sample
+// and reports tracked peaks and how much of the signal the notches removed.
+class Gyro_Replay {
+private:
+	Gyro_Replay();
+
+	// analyzer task runs at 1 kHz on target
+	static const uint16_t STEP_RATE = 1000;
+	static const uint16_t REPORT_MS = 500;
+
+public:
+	static int Analyze(const char *file, uint16_t rate);
+};
+
+} /* namespace flyhero */
+
+#endif /* GYRO_REPLAY_H_ */
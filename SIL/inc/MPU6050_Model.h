@@ -0,0 +1,101 @@
+/*
+ * MPU6050_Model.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef MPU6050_MODEL_H_
+#define MPU6050_MODEL_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <random>
+#include "Quadcopter_Model.h"
+
+namespace flyhero {
+
+// Register level model of MPU6050 as seen over I2C or SPI. DMP is mocked: memory
+// banks and program start behave like the sensor, but instead of running the
+// image the model pushes the true attitude as DMP quaternion packets. With the
+// ICM-20602 WHO_AM_I it also uses that sensor's temperature encoding.
+class MPU6050_Model {
+public:
+	static const uint8_t I2C_ADDRESS = 0xD0;
+	// mock only - DMP memory byte holding the quaternion output divider
+	static const uint16_t DMP_RATE_DIVIDER_ADDRESS = 0x0004;
+	static const uint8_t WHO_AM_I_MPU6050 = 0x68;
+	static const uint8_t WHO_AM_I_ICM20602 = 0x12;
+
+private:
+	const struct {
+		uint8_t ACCEL_X_OFFSET = 0x06;
+		uint8_t GYRO_X_OFFSET = 0x13;
+		uint8_t SMPRT_DIV = 0x19;
+		uint8_t CONFIG = 0x1A;
+		uint8_t GYRO_CONFIG = 0x1B;
+		uint8_t ACCEL_CONFIG = 0x1C;
+		uint8_t FIFO_EN = 0x23;
+		uint8_t INT_ENABLE = 0x38;
+		uint8_t INT_STATUS = 0x3A;
+		uint8_t ACCEL_XOUT_H = 0x3B;
+		uint8_t USER_CTRL = 0x6A;
+		uint8_t PWR_MGMT_1 = 0x6B;
+		uint8_t BANK_SEL = 0x6D;
+		uint8_t MEM_START_ADDR = 0x6E;
+		uint8_t MEM_R_W = 0x6F;
+		uint8_t PRGM_START_H = 0x70;
+		uint8_t FIFO_COUNT_H = 0x72;
+		uint8_t FIFO_R_W = 0x74;
+		uint8_t WHO_AM_I = 0x75;
+	} REGISTERS;
+
+	static const uint16_t FIFO_SIZE = 1024;
+	static const uint16_t DMP_MEMORY_SIZE = 4096;
+
+	uint8_t registers[128];
+	uint8_t fifo[FIFO_SIZE];
+	uint16_t fifo_head;
+	uint16_t fifo_count;
+	uint8_t dmp_memory[DMP_MEMORY_SIZE];
+	uint8_t dmp_samples;
+	// survives reset, it is the part soldered on the board
+	uint8_t who_am_i;
+	double temperature;
+	Quadcopter_Model::Vector gyro_bias, accel_bias;
+	double gyro_noise, accel_noise;
+	std::mt19937 generator;
+	std::normal_distribution<double> normal;
+
+	int16_t read_word(uint8_t reg);
+	void write_word(uint8_t reg, int16_t value);
+	int16_t saturate(double value);
+	void fifo_push(const uint8_t *data, uint8_t size);
+	uint8_t fifo_pop();
+	void fifo_update_count();
+	uint16_t dmp_address();
+	void dmp_advance();
+	void dmp_sample(Quadcopter_Model& model);
+
+public:
+	MPU6050_Model();
+
+	void Reset();
+	void Write(uint8_t reg, const uint8_t *data, uint16_t size);
+	void Read(uint8_t reg, uint8_t *data, uint16_t size);
+	void Sample(Quadcopter_Model& model);
+
+	void Set_Gyro_Bias(double x, double y, double z);
+	void Set_Accel_Bias(double x, double y, double z);
+	void Set_Noise(double gyro_dps, double accel_g);
+	void Set_Temperature(double temperature);
+	void Set_WHO_AM_I(uint8_t who_am_i);
+
+	uint32_t Get_Sample_Period_us();
+	bool Data_Ready_Interrupt_Enabled();
+	uint8_t Get_DMP_Memory(uint16_t address);
+};
+
+} /* namespace flyhero */
+
+#endif /* MPU6050_MODEL_H_ */
@@ -0,0 +1,84 @@
+/*
+ * Quadcopter_Model.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef QUADCOPTER_MODEL_H_
+#define QUADCOPTER_MODEL_H_
+
+#include <stdint.h>
+#include <cmath>
+
+namespace flyhero {
+
+// Rigid body model of the frame. Everything is expressed in IMU frame
+// (x forward, z up), world frame is z up with origin on the ground.
+class Quadcopter_Model {
+public:
+	static const uint8_t MOTOR_COUNT = 4;
+
+	struct Vector {
+		double x, y, z;
+	};
+
+	struct Motor {
+		uint8_t channel;	// TIM2 channel driving the ESC
+		double x, y;		// position in IMU frame [m]
+		int8_t yaw;			// sign of reaction torque about z
+	};
+
+private:
+	const double PI = 3.14159265358979323846;
+	const double GRAVITY = 9.81;
+	const double MASS = 1.2;
+	const double INERTIA_XX = 0.012;
+	const double INERTIA_YY = 0.012;
+	const double INERTIA_ZZ = 0.022;
+	const double MAX_THRUST = 8;			// per motor [N]
+	const double YAW_COEFFICIENT = 0.016;	// reaction torque / thrust [m]
+	const double MOTOR_TIME_CONSTANT = 0.03;
+	const double RATE_DAMPING = 0.002;
+	const double LINEAR_DRAG = 0.3;
+	const double VIBRATION_BASE_FREQUENCY = 60;
+	const double VIBRATION_FREQUENCY_SPAN = 240;
+
+	Motor motors[MOTOR_COUNT];
+	double motor_output[MOTOR_COUNT];
+	double motor_phase[MOTOR_COUNT];
+	double q0, q1, q2, q3;
+	Vector position, velocity;
+	Vector rates;
+	Vector specific_force;
+	Vector disturbance;
+	double vibration_accel, vibration_gyro;
+	Vector vibration_a, vibration_g;
+	bool on_ground;
+
+	double pulse_to_output(uint16_t pulse);
+
+public:
+	Quadcopter_Model();
+
+	void Reset();
+	void Step(double dt, const uint16_t pulses[MOTOR_COUNT]);
+
+	void Set_Attitude(double roll, double pitch, double yaw);
+	void Set_Disturbance(Vector torque);
+	void Set_Vibration(double accel_g, double gyro_dps);
+
+	void Get_Euler(double& roll, double& pitch, double& yaw);
+	void Get_Quaternion(double q[4]);
+	Vector Get_Rates_Dps();
+	Vector Get_Specific_Force_G();
+	Vector Get_Position();
+	double Get_Motor_Output(uint8_t index);
+	double Get_Vibration_Frequency(uint8_t index);
+	uint16_t Get_Hover_Pulse();
+	bool Is_On_Ground();
+};
+
+} /* namespace flyhero */
+
+#endif /* QUADCOPTER_MODEL_H_ */
@@ -0,0 +1,93 @@
+/*
+ * Simulator.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef SIMULATOR_H_
+#define SIMULATOR_H_
+
+#include <stm32f4xx_hal.h>
+#include "Quadcopter_Model.h"
+#include "MPU6050_Model.h"
+
+namespace flyhero {
+
+// Virtual time base of the SIL build. Time only moves when flight code waits
+// (HAL_Delay, blocking transfers, polling HAL_GetTick) or when main calls
+// Advance(); interrupts are delivered synchronously from Advance().
+class Simulator {
+public:
+	static const uint32_t PHYSICS_PERIOD_US = 100;
+	static const uint32_t PWM_PERIOD_US = 500;
+
+private:
+	Simulator();
+	Simulator(Simulator const&);
+	Simulator& operator=(Simulator const&);
+
+	// fits MPU6050 FIFO burst of 8 samples
+	static const uint16_t MAX_TRANSFER = 128;
+
+	// wiring, matches Config.h
+	static const uint16_t IMU_INT_PIN = GPIO_PIN_1;
+	static const uint16_t IMU_CS_PIN = GPIO_PIN_4;
+	// APB2 clock, SPI1 runs from it
+	static const uint32_t SPI_CLOCK = 90000000;
+	// sensor takes register writes up to this SPI clock only
+	static const uint32_t SPI_WRITE_CLOCK = 1000000;
+
+	struct DMA_Transfer {
+		bool busy;
+		uint64_t done_us;
+		uint64_t sample_us;
+		I2C_HandleTypeDef *hi2c;
+		SPI_HandleTypeDef *hspi;
+		uint8_t *data;
+		uint16_t size;
+		uint8_t buffer[MAX_TRANSFER];
+	};
+
+	Quadcopter_Model model;
+	MPU6050_Model imu;
+	DMA_Transfer i2c_dma;
+	DMA_Transfer spi_dma;
+	uint64_t time_us;
+	uint64_t next_physics_us;
+	uint64_t next_sample_us;
+	uint64_t next_pwm_us;
+	uint64_t last_sample_us;
+	uint64_t transfer_sample_us;
+	uint16_t pulses[Quadcopter_Model::MOTOR_COUNT];
+	uint16_t exti_pins;
+	bool in_interrupt;
+
+	uint32_t transfer_time_us(I2C_HandleTypeDef *hi2c, uint16_t size);
+	uint32_t spi_clock(SPI_HandleTypeDef *hspi);
+	uint32_t transfer_time_us(SPI_HandleTypeDef *hspi, uint16_t size);
+	void spi_exchange(SPI_HandleTypeDef *hspi, const uint8_t *tx, uint8_t *rx, uint16_t size);
+	void complete(DMA_Transfer& transfer);
+	void set_time(uint64_t time_us);
+
+public:
+	static Simulator& Instance();
+
+	void Advance(uint32_t us);
+	uint64_t Get_Time_us();
+	uint64_t Get_Next_PWM_Update_us();
+	uint64_t Get_Transfer_Sample_us();
+	Quadcopter_Model& Get_Model();
+	MPU6050_Model& Get_IMU();
+
+	void Enable_EXTI(uint16_t pin);
+	HAL_StatusTypeDef I2C_Write(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t reg, uint8_t *data, uint16_t size);
+	HAL_StatusTypeDef I2C_Read(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t reg, uint8_t *data, uint16_t size);
+	HAL_StatusTypeDef I2C_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t reg, uint8_t *data, uint16_t size);
+	HAL_StatusTypeDef SPI_Transfer(SPI_HandleTypeDef *hspi, uint8_t *tx, uint8_t *rx, uint16_t size);
+	HAL_StatusTypeDef SPI_Transfer_DMA(SPI_HandleTypeDef *hspi, uint8_t *tx, uint8_t *rx, uint16_t size);
+};
+
+} /* namespace flyhero */
+
+#endif /* SIMULATOR_H_ */
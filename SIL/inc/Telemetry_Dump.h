@@ -0,0 +1,28 @@
+/*
+ * Telemetry_Dump.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef TELEMETRY_DUMP_H_
+#define TELEMETRY_DUMP_H_
+
+#include <stdint.h>
+
+namespace flyhero {
+
+// Ground side decoder for captured telemetry, "sil telemetry <file>" takes
+// raw bytes as they came from UART or WiFi and prints one line per frame,
+// "t_us;sequence;name=value,value;..." with the fields the frame carried.
+class Telemetry_Dump {
+private:
+	Telemetry_Dump();
+
+public:
+	static int Decode(const char *file);
+};
+
+} /* namespace flyhero */
+
+#endif /* TELEMETRY_DUMP_H_ */
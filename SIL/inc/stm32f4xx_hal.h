@@ -0,0 +1,576 @@
+/*
+ * stm32f4xx_hal.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+// Simulated subset of STM32F4 HAL used by the flight code.
+// Peripherals are plain structs owned by the Simulator, HAL calls are
+// implemented in Sim_HAL.cpp.
+
+#ifndef __STM32F4xx_HAL_H
+#define __STM32F4xx_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __IO volatile
+
+typedef enum {
+	HAL_OK = 0x00,
+	HAL_ERROR = 0x01,
+	HAL_BUSY = 0x02,
+	HAL_TIMEOUT = 0x03
+} HAL_StatusTypeDef;
+
+typedef enum { RESET = 0, SET = !RESET } FlagStatus, ITStatus;
+
+typedef enum {
+	GPIO_PIN_RESET = 0,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef enum {
+	EXTI0_IRQn = 6,
+	EXTI1_IRQn = 7,
+	EXTI2_IRQn = 8,
+	EXTI3_IRQn = 9,
+	EXTI4_IRQn = 10,
+	DMA1_Stream0_IRQn = 11,
+	DMA1_Stream1_IRQn = 12,
+	DMA1_Stream2_IRQn = 13,
+	DMA1_Stream3_IRQn = 14,
+	DMA1_Stream4_IRQn = 15,
+	DMA1_Stream5_IRQn = 16,
+	DMA1_Stream6_IRQn = 17,
+	EXTI9_5_IRQn = 23,
+	I2C1_EV_IRQn = 31,
+	I2C2_EV_IRQn = 33,
+	USART2_IRQn = 38,
+	USART3_IRQn = 39,
+	EXTI15_10_IRQn = 40,
+	DMA1_Stream7_IRQn = 47,
+	TIM5_IRQn = 50,
+	DMA2_Stream0_IRQn = 56,
+	DMA2_Stream1_IRQn = 57,
+	DMA2_Stream2_IRQn = 58,
+	DMA2_Stream3_IRQn = 59,
+	DMA2_Stream4_IRQn = 60,
+	DMA2_Stream5_IRQn = 68,
+	DMA2_Stream6_IRQn = 69,
+	DMA2_Stream7_IRQn = 70,
+	I2C3_EV_IRQn = 72
+} IRQn_Type;
+
+/* ##########################      registers      ########################## */
+
+typedef struct {
+	__IO uint32_t MODER;
+	__IO uint32_t IDR;
+	__IO uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef struct {
+	__IO uint32_t CR1;
+} I2C_TypeDef;
+
+typedef struct {
+	__IO uint32_t CR1;
+} SPI_TypeDef;
+
+typedef struct {
+	__IO uint32_t CR;
+} DMA_Stream_TypeDef;
+
+typedef struct {
+	__IO uint32_t CR1;
+	__IO uint32_t DIER;
+	__IO uint32_t SR;
+	__IO uint32_t CNT;
+	__IO uint32_t PSC;
+	__IO uint32_t ARR;
+	__IO uint32_t CCR1;
+	__IO uint32_t CCR2;
+	__IO uint32_t CCR3;
+	__IO uint32_t CCR4;
+} TIM_TypeDef;
+
+typedef struct {
+	__IO uint32_t DR;
+	__IO uint32_t IDR;
+	__IO uint32_t CR;
+} CRC_TypeDef;
+
+// base addresses are kept so that switch statements over them still compile,
+// peripheral pointers point to simulated registers instead
+#define PERIPH_BASE				0x40000000UL
+#define APB1PERIPH_BASE			PERIPH_BASE
+#define APB2PERIPH_BASE			(PERIPH_BASE + 0x00010000UL)
+#define AHB1PERIPH_BASE			(PERIPH_BASE + 0x00020000UL)
+
+#define TIM2_BASE				(APB1PERIPH_BASE + 0x0000UL)
+#define TIM5_BASE				(APB1PERIPH_BASE + 0x0C00UL)
+#define I2C1_BASE				(APB1PERIPH_BASE + 0x5400UL)
+#define I2C2_BASE				(APB1PERIPH_BASE + 0x5800UL)
+#define I2C3_BASE				(APB1PERIPH_BASE + 0x5C00UL)
+#define SPI2_BASE				(APB1PERIPH_BASE + 0x3800UL)
+#define SPI3_BASE				(APB1PERIPH_BASE + 0x3C00UL)
+#define SPI1_BASE				(APB2PERIPH_BASE + 0x3000UL)
+
+#define GPIOA_BASE				(AHB1PERIPH_BASE + 0x0000UL)
+#define GPIOB_BASE				(AHB1PERIPH_BASE + 0x0400UL)
+#define GPIOC_BASE				(AHB1PERIPH_BASE + 0x0800UL)
+#define GPIOD_BASE				(AHB1PERIPH_BASE + 0x0C00UL)
+#define GPIOE_BASE				(AHB1PERIPH_BASE + 0x1000UL)
+#define GPIOF_BASE				(AHB1PERIPH_BASE + 0x1400UL)
+#define GPIOG_BASE				(AHB1PERIPH_BASE + 0x1800UL)
+#define GPIOH_BASE				(AHB1PERIPH_BASE + 0x1C00UL)
+
+#define DMA1_BASE				(AHB1PERIPH_BASE + 0x6000UL)
+#define DMA1_Stream0_BASE		(DMA1_BASE + 0x010UL)
+#define DMA1_Stream1_BASE		(DMA1_BASE + 0x028UL)
+#define DMA1_Stream2_BASE		(DMA1_BASE + 0x040UL)
+#define DMA1_Stream3_BASE		(DMA1_BASE + 0x058UL)
+#define DMA1_Stream4_BASE		(DMA1_BASE + 0x070UL)
+#define DMA1_Stream5_BASE		(DMA1_BASE + 0x088UL)
+#define DMA1_Stream6_BASE		(DMA1_BASE + 0x0A0UL)
+#define DMA1_Stream7_BASE		(DMA1_BASE + 0x0B8UL)
+#define DMA2_BASE				(AHB1PERIPH_BASE + 0x6400UL)
+#define DMA2_Stream0_BASE		(DMA2_BASE + 0x010UL)
+#define DMA2_Stream1_BASE		(DMA2_BASE + 0x028UL)
+#define DMA2_Stream2_BASE		(DMA2_BASE + 0x040UL)
+#define DMA2_Stream3_BASE		(DMA2_BASE + 0x058UL)
+#define DMA2_Stream4_BASE		(DMA2_BASE + 0x070UL)
+#define DMA2_Stream5_BASE		(DMA2_BASE + 0x088UL)
+#define DMA2_Stream6_BASE		(DMA2_BASE + 0x0A0UL)
+#define DMA2_Stream7_BASE		(DMA2_BASE + 0x0B8UL)
+
+extern GPIO_TypeDef SIM_GPIO[8];
+extern I2C_TypeDef SIM_I2C[3];
+extern SPI_TypeDef SIM_SPI[3];
+extern DMA_Stream_TypeDef SIM_DMA1_Stream[8];
+extern DMA_Stream_TypeDef SIM_DMA2_Stream[8];
+extern TIM_TypeDef SIM_TIM2;
+extern TIM_TypeDef SIM_TIM5;
+extern CRC_TypeDef SIM_CRC;
+
+#define GPIOA					(&SIM_GPIO[0])
+#define GPIOB					(&SIM_GPIO[1])
+#define GPIOC					(&SIM_GPIO[2])
+#define GPIOD					(&SIM_GPIO[3])
+#define GPIOE					(&SIM_GPIO[4])
+#define GPIOF					(&SIM_GPIO[5])
+#define GPIOG					(&SIM_GPIO[6])
+#define GPIOH					(&SIM_GPIO[7])
+#define I2C1					(&SIM_I2C[0])
+#define I2C2					(&SIM_I2C[1])
+#define I2C3					(&SIM_I2C[2])
+#define SPI1					(&SIM_SPI[0])
+#define SPI2					(&SIM_SPI[1])
+#define SPI3					(&SIM_SPI[2])
+#define DMA1_Stream0			(&SIM_DMA1_Stream[0])
+#define DMA1_Stream1			(&SIM_DMA1_Stream[1])
+#define DMA1_Stream2			(&SIM_DMA1_Stream[2])
+#define DMA1_Stream3			(&SIM_DMA1_Stream[3])
+#define DMA1_Stream4			(&SIM_DMA1_Stream[4])
+#define DMA1_Stream5			(&SIM_DMA1_Stream[5])
+#define DMA1_Stream6			(&SIM_DMA1_Stream[6])
+#define DMA1_Stream7			(&SIM_DMA1_Stream[7])
+#define DMA2_Stream0			(&SIM_DMA2_Stream[0])
+#define DMA2_Stream1			(&SIM_DMA2_Stream[1])
+#define DMA2_Stream2			(&SIM_DMA2_Stream[2])
+#define DMA2_Stream3			(&SIM_DMA2_Stream[3])
+#define DMA2_Stream4			(&SIM_DMA2_Stream[4])
+#define DMA2_Stream5			(&SIM_DMA2_Stream[5])
+#define DMA2_Stream6			(&SIM_DMA2_Stream[6])
+#define DMA2_Stream7			(&SIM_DMA2_Stream[7])
+#define TIM2					(&SIM_TIM2)
+#define TIM5					(&SIM_TIM5)
+#define CRC						(&SIM_CRC)
+
+/* ##########################        RCC          ########################## */
+
+#define SIM_CLK_ENABLE()		do { } while (0)
+#define SIM_CLK_IS_DISABLED()	(0)
+
+#define __GPIOA_CLK_ENABLE		SIM_CLK_ENABLE
+#define __GPIOB_CLK_ENABLE		SIM_CLK_ENABLE
+#define __GPIOC_CLK_ENABLE		SIM_CLK_ENABLE
+#define __GPIOD_CLK_ENABLE		SIM_CLK_ENABLE
+#define __GPIOE_CLK_ENABLE		SIM_CLK_ENABLE
+#define __GPIOF_CLK_ENABLE		SIM_CLK_ENABLE
+#define __GPIOG_CLK_ENABLE		SIM_CLK_ENABLE
+#define __GPIOH_CLK_ENABLE		SIM_CLK_ENABLE
+#define __I2C1_CLK_ENABLE		SIM_CLK_ENABLE
+#define __I2C2_CLK_ENABLE		SIM_CLK_ENABLE
+#define __I2C3_CLK_ENABLE		SIM_CLK_ENABLE
+#define __SPI1_CLK_ENABLE		SIM_CLK_ENABLE
+#define __SPI2_CLK_ENABLE		SIM_CLK_ENABLE
+#define __SPI3_CLK_ENABLE		SIM_CLK_ENABLE
+#define __DMA1_CLK_ENABLE		SIM_CLK_ENABLE
+#define __DMA2_CLK_ENABLE		SIM_CLK_ENABLE
+#define __TIM2_CLK_ENABLE		SIM_CLK_ENABLE
+#define __TIM5_CLK_ENABLE		SIM_CLK_ENABLE
+#define __TIM5_FORCE_RESET		SIM_CLK_ENABLE
+#define __TIM5_RELEASE_RESET	SIM_CLK_ENABLE
+#define __HAL_RCC_CRC_CLK_ENABLE	SIM_CLK_ENABLE
+
+#define __GPIOA_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __GPIOB_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __GPIOC_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __GPIOD_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __GPIOE_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __GPIOF_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __GPIOG_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __GPIOH_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __I2C1_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __I2C2_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __I2C3_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __SPI1_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __SPI2_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __SPI3_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __DMA1_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __DMA2_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+#define __TIM2_IS_CLK_DISABLED	SIM_CLK_IS_DISABLED
+
+#define RCC_HCLK_DIV1			0x00000000U
+
+typedef struct {
+	uint32_t ClockType;
+	uint32_t SYSCLKSource;
+	uint32_t AHBCLKDivider;
+	uint32_t APB1CLKDivider;
+	uint32_t APB2CLKDivider;
+} RCC_ClkInitTypeDef;
+
+/* ##########################        GPIO         ########################## */
+
+#define GPIO_PIN_0				((uint16_t)0x0001)
+#define GPIO_PIN_1				((uint16_t)0x0002)
+#define GPIO_PIN_2				((uint16_t)0x0004)
+#define GPIO_PIN_3				((uint16_t)0x0008)
+#define GPIO_PIN_4				((uint16_t)0x0010)
+#define GPIO_PIN_5				((uint16_t)0x0020)
+#define GPIO_PIN_6				((uint16_t)0x0040)
+#define GPIO_PIN_7				((uint16_t)0x0080)
+#define GPIO_PIN_8				((uint16_t)0x0100)
+#define GPIO_PIN_9				((uint16_t)0x0200)
+#define GPIO_PIN_10				((uint16_t)0x0400)
+#define GPIO_PIN_11				((uint16_t)0x0800)
+#define GPIO_PIN_12				((uint16_t)0x1000)
+#define GPIO_PIN_13				((uint16_t)0x2000)
+#define GPIO_PIN_14				((uint16_t)0x4000)
+#define GPIO_PIN_15				((uint16_t)0x8000)
+
+#define GPIO_MODE_INPUT			0x00000000U
+#define GPIO_MODE_OUTPUT_PP		0x00000001U
+#define GPIO_MODE_OUTPUT_OD		0x00000011U
+#define GPIO_MODE_AF_PP			0x00000002U
+#define GPIO_MODE_AF_OD			0x00000012U
+#define GPIO_MODE_IT_RISING		0x10110000U
+#define GPIO_MODE_IT_FALLING	0x10210000U
+
+#define GPIO_NOPULL				0x00000000U
+#define GPIO_PULLUP				0x00000001U
+#define GPIO_PULLDOWN			0x00000002U
+
+#define GPIO_SPEED_FREQ_LOW		0x00000000U
+#define GPIO_SPEED_FREQ_MEDIUM	0x00000001U
+#define GPIO_SPEED_FREQ_HIGH	0x00000002U
+#define GPIO_SPEED_FREQ_VERY_HIGH	0x00000003U
+#define GPIO_SPEED_HIGH			GPIO_SPEED_FREQ_VERY_HIGH
+
+#define GPIO_AF1_TIM2			((uint8_t)0x01)
+#define GPIO_AF4_I2C1			((uint8_t)0x04)
+#define GPIO_AF4_I2C2			((uint8_t)0x04)
+#define GPIO_AF4_I2C3			((uint8_t)0x04)
+#define GPIO_AF5_SPI1			((uint8_t)0x05)
+#define GPIO_AF5_SPI2			((uint8_t)0x05)
+#define GPIO_AF6_SPI3			((uint8_t)0x06)
+
+typedef struct {
+	uint32_t Pin;
+	uint32_t Mode;
+	uint32_t Pull;
+	uint32_t Speed;
+	uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+/* ##########################         DMA         ########################## */
+
+#define DMA_CHANNEL_1			0x02000000U
+#define DMA_CHANNEL_3			0x06000000U
+#define DMA_CHANNEL_4			0x08000000U
+#define DMA_PERIPH_TO_MEMORY	0x00000000U
+#define DMA_MEMORY_TO_PERIPH	0x00000040U
+#define DMA_PINC_DISABLE		0x00000000U
+#define DMA_MINC_ENABLE			0x00000400U
+#define DMA_PDATAALIGN_BYTE		0x00000000U
+#define DMA_MDATAALIGN_BYTE		0x00000000U
+#define DMA_NORMAL				0x00000000U
+#define DMA_PRIORITY_LOW		0x00000000U
+#define DMA_PRIORITY_HIGH		0x00020000U
+#define DMA_FIFOMODE_DISABLE	0x00000000U
+
+typedef struct {
+	uint32_t Channel;
+	uint32_t Direction;
+	uint32_t PeriphInc;
+	uint32_t MemInc;
+	uint32_t PeriphDataAlignment;
+	uint32_t MemDataAlignment;
+	uint32_t Mode;
+	uint32_t Priority;
+	uint32_t FIFOMode;
+} DMA_InitTypeDef;
+
+typedef struct {
+	DMA_Stream_TypeDef *Instance;
+	DMA_InitTypeDef Init;
+	void *Parent;
+} DMA_HandleTypeDef;
+
+#define __HAL_LINKDMA(__HANDLE__, __PPP_DMA_FIELD__, __DMA_HANDLE__)	\
+	do {																\
+		(__HANDLE__)->__PPP_DMA_FIELD__ = &(__DMA_HANDLE__);			\
+		(__DMA_HANDLE__).Parent = (__HANDLE__);							\
+	} while (0)
+
+/* ##########################         I2C         ########################## */
+
+#define I2C_DUTYCYCLE_2				0x00000000U
+#define I2C_ADDRESSINGMODE_7BIT		0x00004000U
+#define I2C_DUALADDRESS_DISABLE		0x00000000U
+#define I2C_GENERALCALL_DISABLE		0x00000000U
+#define I2C_NOSTRETCH_DISABLE		0x00000000U
+#define I2C_MEMADD_SIZE_8BIT		0x00000001U
+
+typedef struct {
+	uint32_t ClockSpeed;
+	uint32_t DutyCycle;
+	uint32_t OwnAddress1;
+	uint32_t AddressingMode;
+	uint32_t DualAddressMode;
+	uint32_t OwnAddress2;
+	uint32_t GeneralCallMode;
+	uint32_t NoStretchMode;
+} I2C_InitTypeDef;
+
+typedef struct {
+	I2C_TypeDef *Instance;
+	I2C_InitTypeDef Init;
+	DMA_HandleTypeDef *hdmatx;
+	DMA_HandleTypeDef *hdmarx;
+	__IO uint32_t State;
+} I2C_HandleTypeDef;
+
+/* ##########################         SPI         ########################## */
+
+#define SPI_MODE_MASTER				0x00000104U
+#define SPI_DIRECTION_2LINES		0x00000000U
+#define SPI_DATASIZE_8BIT			0x00000000U
+#define SPI_POLARITY_HIGH			0x00000002U
+#define SPI_PHASE_2EDGE				0x00000001U
+#define SPI_NSS_SOFT				0x00000200U
+#define SPI_BAUDRATEPRESCALER_2		0x00000000U
+#define SPI_BAUDRATEPRESCALER_4		0x00000008U
+#define SPI_BAUDRATEPRESCALER_8		0x00000010U
+#define SPI_BAUDRATEPRESCALER_16	0x00000018U
+#define SPI_BAUDRATEPRESCALER_32	0x00000020U
+#define SPI_BAUDRATEPRESCALER_64	0x00000028U
+#define SPI_BAUDRATEPRESCALER_128	0x00000030U
+#define SPI_BAUDRATEPRESCALER_256	0x00000038U
+#define SPI_FIRSTBIT_MSB			0x00000000U
+#define SPI_TIMODE_DISABLE			0x00000000U
+#define SPI_CRCCALCULATION_DISABLE	0x00000000U
+
+#define SPI_CR1_BR					0x00000038U
+#define SPI_CR1_SPE					0x00000040U
+
+typedef struct {
+	uint32_t Mode;
+	uint32_t Direction;
+	uint32_t DataSize;
+	uint32_t CLKPolarity;
+	uint32_t CLKPhase;
+	uint32_t NSS;
+	uint32_t BaudRatePrescaler;
+	uint32_t FirstBit;
+	uint32_t TIMode;
+	uint32_t CRCCalculation;
+	uint32_t CRCPolynomial;
+} SPI_InitTypeDef;
+
+typedef enum {
+	HAL_SPI_STATE_RESET = 0x00,
+	HAL_SPI_STATE_READY = 0x01,
+	HAL_SPI_STATE_BUSY = 0x02,
+	HAL_SPI_STATE_BUSY_TX_RX = 0x05
+} HAL_SPI_StateTypeDef;
+
+typedef struct {
+	SPI_TypeDef *Instance;
+	SPI_InitTypeDef Init;
+	DMA_HandleTypeDef *hdmatx;
+	DMA_HandleTypeDef *hdmarx;
+	__IO HAL_SPI_StateTypeDef State;
+} SPI_HandleTypeDef;
+
+#define __HAL_SPI_DISABLE(__HANDLE__)	((__HANDLE__)->Instance->CR1 &= ~SPI_CR1_SPE)
+
+/* ##########################         TIM         ########################## */
+
+#define TIM_CHANNEL_1			0x00000000U
+#define TIM_CHANNEL_2			0x00000004U
+#define TIM_CHANNEL_3			0x00000008U
+#define TIM_CHANNEL_4			0x0000000CU
+
+#define TIM_IT_UPDATE			0x00000001U
+#define TIM_IT_CC1				0x00000002U
+#define TIM_IT_CC2				0x00000004U
+
+#define TIM_COUNTERMODE_UP		0x00000000U
+#define TIM_CLOCKDIVISION_DIV1	0x00000000U
+#define TIM_OCMODE_PWM1			0x00000060U
+#define TIM_OCPOLARITY_HIGH		0x00000000U
+#define TIM_OCNPOLARITY_HIGH	0x00000000U
+#define TIM_OCFAST_DISABLE		0x00000000U
+#define TIM_OCIDLESTATE_RESET	0x00000000U
+#define TIM_OCNIDLESTATE_RESET	0x00000000U
+
+typedef struct {
+	uint32_t Prescaler;
+	uint32_t CounterMode;
+	uint32_t Period;
+	uint32_t ClockDivision;
+	uint32_t RepetitionCounter;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+	uint32_t OCMode;
+	uint32_t Pulse;
+	uint32_t OCPolarity;
+	uint32_t OCNPolarity;
+	uint32_t OCFastMode;
+	uint32_t OCIdleState;
+	uint32_t OCNIdleState;
+} TIM_OC_InitTypeDef;
+
+typedef struct {
+	TIM_TypeDef *Instance;
+	TIM_Base_InitTypeDef Init;
+} TIM_HandleTypeDef;
+
+#define __HAL_TIM_SET_COMPARE(__HANDLE__, __CHANNEL__, __COMPARE__) \
+	(*(__IO uint32_t *)(&((__HANDLE__)->Instance->CCR1) + ((__CHANNEL__) >> 2U)) = (__COMPARE__))
+#define __HAL_TIM_GET_COUNTER(__HANDLE__)			((__HANDLE__)->Instance->CNT)
+#define __HAL_TIM_ENABLE_IT(__HANDLE__, __IT__)		((__HANDLE__)->Instance->DIER |= (__IT__))
+#define __HAL_TIM_DISABLE_IT(__HANDLE__, __IT__)	((__HANDLE__)->Instance->DIER &= ~(__IT__))
+#define __HAL_TIM_CLEAR_IT(__HANDLE__, __IT__)		((__HANDLE__)->Instance->SR = ~(__IT__))
+#define __HAL_TIM_GET_ITSTATUS(__HANDLE__, __IT__)	\
+	((((__HANDLE__)->Instance->SR & (__IT__)) != 0 && ((__HANDLE__)->Instance->DIER & (__IT__)) != 0) ? SET : RESET)
+#define __HAL_TIM_SetCompare						__HAL_TIM_SET_COMPARE
+#define __HAL_TIM_GetCounter						__HAL_TIM_GET_COUNTER
+
+/* ##########################         CRC         ########################## */
+
+typedef struct {
+	CRC_TypeDef *Instance;
+} CRC_HandleTypeDef;
+
+/* ##########################        FLASH        ########################## */
+
+// only the sector reserved for Flash_Storage is simulated, it is erased on start
+#define SIM_FLASH_SECTOR			7U
+#define SIM_FLASH_SIZE				(128U * 1024U)
+
+extern uint32_t SIM_FLASH[SIM_FLASH_SIZE / 4];
+
+#define FLASH_TYPEERASE_SECTORS		0x00000000U
+#define FLASH_TYPEPROGRAM_WORD		0x00000002U
+#define FLASH_VOLTAGE_RANGE_3		0x00000002U
+#define FLASH_BANK_1				1U
+#define FLASH_SECTOR_7				7U
+
+#define __HAL_FLASH_DATA_CACHE_DISABLE()	do { } while (0)
+#define __HAL_FLASH_DATA_CACHE_RESET()		do { } while (0)
+#define __HAL_FLASH_DATA_CACHE_ENABLE()		do { } while (0)
+
+typedef struct {
+	uint32_t TypeErase;
+	uint32_t Banks;
+	uint32_t Sector;
+	uint32_t NbSectors;
+	uint32_t VoltageRange;
+} FLASH_EraseInitTypeDef;
+
+/* ##########################        HAL API      ########################## */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+HAL_StatusTypeDef HAL_Init(void);
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority);
+void HAL_IncTick(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+void HAL_SuspendTick(void);
+void HAL_ResumeTick(void);
+
+void HAL_RCC_GetClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t *pFLatency);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_EXTI_IRQHandler(uint16_t GPIO_Pin);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma);
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+void HAL_I2C_EV_IRQHandler(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData, uint16_t Size);
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef *hspi);
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi);
+
+HAL_StatusTypeDef HAL_TIM_OC_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_OC_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_OC_Stop(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *sConfig, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim);
+
+HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef *hcrc);
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+
+// address is a host pointer into SIM_FLASH
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uintptr_t Address, uint64_t Data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32F4xx_HAL_H */
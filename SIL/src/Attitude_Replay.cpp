@@ -0,0 +1,143 @@
+/*
+ * Attitude_Replay.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <stdio.h>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include "Attitude_Replay.h"
+#include "Mahony_Estimator.h"
+#include "Madgwick_Estimator.h"
+#include "EKF_Estimator.h"
+
+namespace flyhero {
+
+static const double DEG_TO_RAD = 3.14159265358979323846 / 180;
+
+// Tilt error is the angle between estimated and true gravity direction in body frame,
+// it does not depend on heading which accel cannot observe.
+void Attitude_Replay::Run(Attitude_Estimator& estimator, const Record *records, uint32_t count, Result& result, uint8_t predict_samples) {
+	double tilt_sum = 0, yaw_sum = 0;
+	double time = 0;
+	uint32_t evaluated = 0;
+
+	result.tilt_max = 0;
+	estimator.Reset();
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (uint32_t i = 0; i < count; i++)
+		step(estimator, records[i], i, predict_samples);
+
+	result.update_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+
+	// second pass for the errors, so that they do not disturb the timing
+	estimator.Reset();
+
+	for (uint32_t i = 0; i < count; i++) {
+		const Record& record = records[i];
+
+		step(estimator, record, i, predict_samples);
+		time += record.dt;
+
+		if (time < SETTLE_MS * 0.001)
+			continue;
+
+		float matrix[3][3];
+		float roll, pitch, yaw;
+
+		Attitude_Estimator::Get_Rotation_Matrix(estimator.Get_Quaternion(), matrix);
+		Attitude_Estimator::Get_Euler(estimator.Get_Quaternion(), roll, pitch, yaw);
+
+		double true_roll = record.roll * DEG_TO_RAD;
+		double true_pitch = record.pitch * DEG_TO_RAD;
+		double cosine = -std::sin(true_pitch) * matrix[2][0] + std::sin(true_roll) * std::cos(true_pitch) * matrix[2][1]
+				+ std::cos(true_roll) * std::cos(true_pitch) * matrix[2][2];
+
+		cosine = cosine > 1 ? 1 : cosine;
+		cosine = cosine < -1 ? -1 : cosine;
+
+		double tilt = std::acos(cosine) / DEG_TO_RAD;
+		double yaw_error = std::remainder(double(yaw) - record.yaw, 360.0);
+
+		if (tilt > result.tilt_max)
+			result.tilt_max = tilt;
+
+		tilt_sum += tilt * tilt;
+		yaw_sum += yaw_error * yaw_error;
+		evaluated++;
+	}
+
+	result.tilt_rms = evaluated != 0 ? std::sqrt(tilt_sum / evaluated) : 0;
+	result.yaw_rms = evaluated != 0 ? std::sqrt(yaw_sum / evaluated) : 0;
+}
+
+void Attitude_Replay::step(Attitude_Estimator& estimator, const Record& record, uint32_t index, uint8_t predict_samples) {
+	if (index % (predict_samples + 1) == 0)
+		estimator.Update(record.gyro, record.accel, record.dt);
+	else
+		estimator.Predict(record.gyro, record.dt);
+}
+
+int Attitude_Replay::Compare(const char *file, uint16_t rate) {
+	if (rate == 0) {
+		printf("invalid sample rate\n");
+		return 1;
+	}
+
+	FILE *input = fopen(file, "r");
+
+	if (input == NULL) {
+		printf("cannot open %s\n", file);
+		return 1;
+	}
+
+	std::vector<Record> records;
+	char line[256];
+
+	while (fgets(line, sizeof(line), input) != NULL) {
+		Record record;
+		float dt_us;
+
+		// header or garbage lines are skipped
+		int fields = sscanf(line, "%f;%f;%f;%f;%f;%f;%f;%f;%f;%f", &record.gyro[0], &record.gyro[1], &record.gyro[2],
+				&record.accel[0], &record.accel[1], &record.accel[2], &record.roll, &record.pitch, &record.yaw, &dt_us);
+
+		if (fields < 9)
+			continue;
+
+		record.dt = fields == 10 ? dt_us * 0.000001f : 1.0f / rate;
+		records.push_back(record);
+	}
+
+	fclose(input);
+
+	if (records.size() <= uint32_t(rate) * SETTLE_MS / 1000) {
+		printf("not enough samples in %s\n", file);
+		return 1;
+	}
+
+	static Mahony_Estimator mahony;
+	static Madgwick_Estimator madgwick;
+	static EKF_Estimator ekf;
+	Attitude_Estimator *estimators[] = { &mahony, &madgwick, &ekf };
+
+	printf("%u samples at %u Hz, first %u ms not evaluated\n", uint32_t(records.size()), rate, SETTLE_MS);
+
+	for (Attitude_Estimator *estimator : estimators) {
+		Result result;
+
+		Run(*estimator, records.data(), records.size(), result);
+
+		printf("%s: tilt rms %.2f max %.2f deg, yaw rms %.2f deg, %.1f ns per update\n", estimator->Get_Name(),
+				result.tilt_rms, result.tilt_max, result.yaw_rms, result.update_ns);
+	}
+
+	return 0;
+}
+
+} /* namespace flyhero */
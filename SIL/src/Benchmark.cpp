@@ -0,0 +1,84 @@
+/*
+ * Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "Benchmark.h"
+
+namespace flyhero {
+
+Benchmark *Benchmark::benchmarks[Benchmark::MAX_BENCHMARKS];
+uint8_t Benchmark::benchmark_count = 0;
+volatile float Benchmark::Sink = 0;
+
+Benchmark::Benchmark(const char *name, void (*function)(uint32_t iterations), uint32_t iterations, bool (*check)(),
+		uint32_t bytes) {
+	this->name = name;
+	this->function = function;
+	this->check = check;
+	this->iterations = iterations != 0 ? iterations : 1;
+	this->bytes = bytes;
+
+	if (Benchmark::benchmark_count < Benchmark::MAX_BENCHMARKS) {
+		Benchmark::benchmarks[Benchmark::benchmark_count] = this;
+		Benchmark::benchmark_count++;
+	}
+}
+
+int Benchmark::Run_All(const char *filter) {
+	int ret = 0;
+
+	for (uint8_t i = 0; i < Benchmark::benchmark_count; i++) {
+		Benchmark *benchmark = Benchmark::benchmarks[i];
+
+		if (filter != NULL && strstr(benchmark->name, filter) == NULL)
+			continue;
+
+		if (!benchmark->Run())
+			ret = 1;
+	}
+
+	return ret;
+}
+
+// best of REPEATS, the others are disturbed by the host
+bool Benchmark::Run() {
+	if (this->check != NULL && !this->check()) {
+		printf("bench %s: check FAILED\n", this->name);
+		return false;
+	}
+
+	// warm up caches and branch predictors
+	this->function(this->iterations / 10 + 1);
+
+	double best_ns = 0;
+
+	for (uint8_t i = 0; i < Benchmark::REPEATS; i++) {
+		auto start = std::chrono::steady_clock::now();
+		this->function(this->iterations);
+		double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+		if (i == 0 || ns < best_ns)
+			best_ns = ns;
+	}
+
+	printf("bench %s: %.2f ns per call (%u calls)", this->name, best_ns / this->iterations, this->iterations);
+
+	if (this->bytes != 0)
+		printf(", %.1f bytes per us", 1000.0 * this->bytes * this->iterations / best_ns);
+
+	printf("%s\n", this->check != NULL ? ", check ok" : "");
+
+	return true;
+}
+
+const char* Benchmark::Get_Name() {
+	return this->name;
+}
+
+} /* namespace flyhero */
@@ -0,0 +1,108 @@
+/*
+ * Biquad_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <cmath>
+#include "Biquad_Filter.h"
+#include "Biquad_Bank.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+// same layout as MPU6050 uses, accel x, y, z and gyro x, y, z
+static const uint8_t CHANNELS = 6;
+
+static float input(uint32_t i, uint8_t channel) {
+	return std::sin(i * 0.05f + channel) * 100 + ((i * 7 + channel) & 0x0F);
+}
+
+static void biquad_filters(uint32_t iterations) {
+	static Biquad_Filter filters[CHANNELS] = {
+		{ Biquad_Filter::FILTER_LOW_PASS, 1000, 10 },
+		{ Biquad_Filter::FILTER_LOW_PASS, 1000, 10 },
+		{ Biquad_Filter::FILTER_LOW_PASS, 1000, 10 },
+		{ Biquad_Filter::FILTER_LOW_PASS, 1000, 60 },
+		{ Biquad_Filter::FILTER_LOW_PASS, 1000, 60 },
+		{ Biquad_Filter::FILTER_LOW_PASS, 1000, 60 },
+	};
+	float sum = 0;
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		float value = float(i & 0xFF);
+
+		for (uint8_t j = 0; j < CHANNELS; j++)
+			sum += filters[j].Apply_Filter(value + j);
+	}
+
+	Benchmark::Sink = sum;
+}
+
+static void biquad_bank(uint32_t iterations) {
+	static Biquad_Bank<CHANNELS> bank(Biquad_Filter::FILTER_LOW_PASS, 1000, 10);
+	static bool init = false;
+	float sum = 0;
+
+	if (!init) {
+		for (uint8_t j = 3; j < CHANNELS; j++)
+			bank.Set_Coefficients(j, Biquad_Filter::FILTER_LOW_PASS, 1000, 60);
+		init = true;
+	}
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		float value = float(i & 0xFF);
+		float data[CHANNELS];
+
+		for (uint8_t j = 0; j < CHANNELS; j++)
+			data[j] = value + j;
+
+		bank.Apply_Filter(data, data);
+
+		for (uint8_t j = 0; j < CHANNELS; j++)
+			sum += data[j];
+	}
+
+	Benchmark::Sink = sum;
+}
+
+// bank has to give the very same numbers as separate filters
+static bool check() {
+	Biquad_Filter filters[CHANNELS] = {
+		{ Biquad_Filter::FILTER_LOW_PASS, 2000, 10 },
+		{ Biquad_Filter::FILTER_LOW_PASS, 2000, 20 },
+		{ Biquad_Filter::FILTER_LOW_PASS, 2000, 40 },
+		{ Biquad_Filter::FILTER_LOW_PASS, 2000, 60 },
+		{ Biquad_Filter::FILTER_NOTCH, 2000, 150 },
+		{ Biquad_Filter::FILTER_NOTCH, 2000, 300 },
+	};
+	Biquad_Bank<CHANNELS> bank(Biquad_Filter::FILTER_LOW_PASS, 2000, 10);
+
+	bank.Set_Coefficients(1, Biquad_Filter::FILTER_LOW_PASS, 2000, 20);
+	bank.Set_Coefficients(2, Biquad_Filter::FILTER_LOW_PASS, 2000, 40);
+	bank.Set_Coefficients(3, Biquad_Filter::FILTER_LOW_PASS, 2000, 60);
+	bank.Set_Coefficients(4, Biquad_Filter::FILTER_NOTCH, 2000, 150);
+	bank.Set_Coefficients(5, Biquad_Filter::FILTER_NOTCH, 2000, 300);
+
+	for (uint32_t i = 0; i < 5000; i++) {
+		float data[CHANNELS];
+
+		for (uint8_t j = 0; j < CHANNELS; j++)
+			data[j] = input(i, j);
+
+		bank.Apply_Filter(data, data);
+
+		for (uint8_t j = 0; j < CHANNELS; j++) {
+			if (std::fabs(filters[j].Apply_Filter(input(i, j)) - data[j]) > 0.0001f)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+static Benchmark filters_benchmark("biquad_6x_filter", &biquad_filters, 1000000);
+static Benchmark bank_benchmark("biquad_bank_6", &biquad_bank, 1000000, &check);
+
+} /* namespace flyhero */
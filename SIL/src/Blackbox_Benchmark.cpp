@@ -0,0 +1,183 @@
+/*
+ * Blackbox_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Blackbox.h"
+#include "Blackbox_File.h"
+#include "Telemetry_Decoder.h"
+#include "Simulator.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+static const uint32_t FIELDS = (Telemetry::FIELDS_RAW & ~(1 << Telemetry::FIELD_TEMPERATURE))
+		| Telemetry::FIELDS_EULER | Telemetry::FIELDS_MOTORS | (1 << Telemetry::FIELD_SAMPLE_AGE);
+static const uint32_t FRAME_SIZE = 84;
+static const uint32_t STORAGE_SIZE = 64 * 1024;
+
+// flash that is never busy, only what Record() and Process() cost is measured
+class Null_Storage : public Blackbox_Storage {
+public:
+	HAL_StatusTypeDef Init() { return HAL_OK; }
+	uint32_t Get_Size() { return 0x80000000; }
+	bool Is_Busy() { return false; }
+	HAL_StatusTypeDef Start_Program(uint32_t address, const uint8_t *data, uint16_t size) { return HAL_OK; }
+	HAL_StatusTypeDef Start_Erase() { return HAL_OK; }
+	HAL_StatusTypeDef Read(uint32_t address, uint8_t *data, uint16_t size) {
+		memset(data, 0xFF, size);
+		return HAL_OK;
+	}
+};
+
+static Telemetry::Snapshot snapshot(uint32_t i) {
+	Telemetry::Snapshot snapshot = Telemetry::Snapshot();
+
+	snapshot.timestamp = i * 1000;
+	snapshot.accel[0] = int16_t(i);
+	snapshot.gyro[2] = int16_t(-i);
+	snapshot.euler[0] = i * 0.01f;
+	snapshot.throttle = 1000 + i % 1000;
+	snapshot.sample_age = i % 2000;
+
+	return snapshot;
+}
+
+// encode and copy of one frame per control loop
+static void record(uint32_t iterations) {
+	static Null_Storage storage;
+	Blackbox& blackbox = Blackbox::Instance();
+	Telemetry::Snapshot data = snapshot(1);
+
+	blackbox.Set_Data_Type(FIELDS);
+	blackbox.Init(&storage);
+	blackbox.Start();
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		data.timestamp += 1000;
+		blackbox.Record(data);
+		blackbox.Process();
+	}
+
+	blackbox.Stop();
+	blackbox.Process();
+	blackbox.Process();
+
+	Benchmark::Sink = blackbox.Get_Frames();
+}
+
+// Reads frames of one recording back, missing are gaps in sequence and
+// frames after the last one read up to sent.
+static bool read_back(uint32_t start, uint32_t end, uint16_t sent, uint32_t& decoded, uint32_t& missing) {
+	Blackbox& blackbox = Blackbox::Instance();
+	Telemetry_Decoder decoder;
+	uint8_t data[Blackbox::PAGE_SIZE];
+	uint16_t next_sequence = 0;
+
+	decoded = 0;
+	missing = 0;
+
+	for (uint32_t offset = start; offset < end; offset += Blackbox::PAGE_SIZE) {
+		if (blackbox.Read(offset, data, Blackbox::PAGE_SIZE) != HAL_OK)
+			return false;
+
+		for (uint16_t i = 0; i < Blackbox::PAGE_SIZE; i++) {
+			if (!decoder.Push(data[i]))
+				continue;
+
+			const Telemetry_Decoder::Frame& frame = decoder.Get_Frame();
+			const Telemetry_Decoder::Field *throttle = decoder.Find_Field(Telemetry::FIELD_THROTTLE);
+
+			if (throttle == NULL || throttle->values[0] != 1000 + frame.sequence % 1000)
+				return false;
+
+			missing += uint16_t(frame.sequence - next_sequence);
+			next_sequence = frame.sequence + 1;
+			decoded++;
+		}
+	}
+
+	missing += uint16_t(sent - next_sequence);
+
+	return decoder.Get_Errors() == 0;
+}
+
+static void wait(Blackbox::State state) {
+	Blackbox& blackbox = Blackbox::Instance();
+
+	for (uint16_t i = 0; i < 1000 && blackbox.Get_State() != state; i++) {
+		Simulator::Instance().Advance(100);
+		blackbox.Process();
+	}
+}
+
+// Frames come faster than pages are programmed, drops are counted and the
+// rest reads back; a later boot appends after it, a full storage stops
+// recording and erase starts over.
+static bool check() {
+	static Blackbox_File storage(NULL, STORAGE_SIZE);
+	Blackbox& blackbox = Blackbox::Instance();
+	Simulator& sim = Simulator::Instance();
+	uint32_t decoded, missing;
+	uint16_t sent;
+
+	blackbox.Set_Data_Type(FIELDS);
+
+	if (blackbox.Init(&storage) != HAL_OK || blackbox.Get_Size() != 0 || blackbox.Start() != HAL_OK)
+		return false;
+
+	// a frame every 100 us, a page takes 700 us
+	for (uint32_t i = 0; i < 200; i++) {
+		blackbox.Record(snapshot(i));
+		blackbox.Process();
+		sim.Advance(100);
+	}
+
+	uint32_t frames = blackbox.Get_Frames();
+	uint32_t dropped = blackbox.Get_Dropped();
+
+	blackbox.Stop();
+	wait(Blackbox::BLACKBOX_IDLE);
+
+	if (blackbox.Get_Dropped() == 0 || frames + blackbox.Get_Dropped() != 200)
+		return false;
+
+	uint32_t first_size = blackbox.Get_Size();
+
+	if (!read_back(0, first_size, 200, decoded, missing) || decoded != frames || missing != dropped)
+		return false;
+
+	// next boot continues on the next page, recording runs until storage is full
+	if (blackbox.Init(&storage) != HAL_OK || blackbox.Get_Size() != first_size || blackbox.Start() != HAL_OK)
+		return false;
+
+	for (sent = 0; blackbox.Is_Recording(); sent++) {
+		blackbox.Record(snapshot(sent));
+		blackbox.Process();
+		sim.Advance(1000);
+	}
+
+	wait(Blackbox::BLACKBOX_FULL);
+
+	if (blackbox.Get_State() != Blackbox::BLACKBOX_FULL || blackbox.Start() == HAL_OK
+			|| blackbox.Get_Size() + Blackbox::PAGE_SIZE <= STORAGE_SIZE - Blackbox::PAGE_SIZE)
+		return false;
+
+	if (!read_back(first_size, blackbox.Get_Size(), sent, decoded, missing) || decoded != blackbox.Get_Frames()
+			|| missing != blackbox.Get_Dropped())
+		return false;
+
+	if (blackbox.Erase() != HAL_OK)
+		return false;
+
+	wait(Blackbox::BLACKBOX_IDLE);
+
+	return blackbox.Get_State() == Blackbox::BLACKBOX_IDLE && blackbox.Get_Size() == 0
+			&& blackbox.Init(&storage) == HAL_OK && blackbox.Get_Size() == 0;
+}
+
+static Benchmark record_benchmark("blackbox_record", &record, 100000, &check, FRAME_SIZE);
+
+} /* namespace flyhero */
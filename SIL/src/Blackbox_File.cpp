@@ -0,0 +1,100 @@
+/*
+ * Blackbox_File.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include "Blackbox_File.h"
+#include "Simulator.h"
+
+namespace flyhero {
+
+Blackbox_File::Blackbox_File(const char *path, uint32_t size) {
+	this->file = path != NULL ? fopen(path, "r+b") : tmpfile();
+
+	if (this->file == NULL && path != NULL)
+		this->file = fopen(path, "w+b");
+
+	this->size = size;
+	this->busy_until_us = 0;
+}
+
+Blackbox_File::~Blackbox_File() {
+	if (this->file != NULL)
+		fclose(this->file);
+}
+
+HAL_StatusTypeDef Blackbox_File::Init() {
+	return this->file != NULL ? HAL_OK : HAL_ERROR;
+}
+
+uint32_t Blackbox_File::Get_Size() {
+	return this->size;
+}
+
+bool Blackbox_File::Is_Busy() {
+	return Simulator::Instance().Get_Time_us() < this->busy_until_us;
+}
+
+HAL_StatusTypeDef Blackbox_File::Start_Program(uint32_t address, const uint8_t *data, uint16_t size) {
+	uint8_t page[PAGE_SIZE];
+
+	if (this->Is_Busy())
+		return HAL_BUSY;
+
+	if (size == 0 || size > PAGE_SIZE || (address & (PAGE_SIZE - 1)) != 0 || address + size > this->size)
+		return HAL_ERROR;
+
+	if (this->Read(address, page, size) != HAL_OK)
+		return HAL_ERROR;
+
+	// NOR only clears bits
+	for (uint16_t i = 0; i < size; i++)
+		page[i] &= data[i];
+
+	// a gap up to address reads back erased
+	fseek(this->file, 0, SEEK_END);
+
+	for (long end = ftell(this->file); end < long(address); end++)
+		fputc(0xFF, this->file);
+
+	if (fseek(this->file, address, SEEK_SET) != 0 || fwrite(page, 1, size, this->file) != size)
+		return HAL_ERROR;
+
+	fflush(this->file);
+	this->busy_until_us = Simulator::Instance().Get_Time_us() + PAGE_PROGRAM_US;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef Blackbox_File::Start_Erase() {
+	if (this->Is_Busy())
+		return HAL_BUSY;
+
+	// nothing in the file reads as erased
+	if (ftruncate(fileno(this->file), 0) != 0)
+		return HAL_ERROR;
+
+	this->busy_until_us = Simulator::Instance().Get_Time_us() + ERASE_US;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef Blackbox_File::Read(uint32_t address, uint8_t *data, uint16_t size) {
+	if (this->Is_Busy())
+		return HAL_BUSY;
+
+	if (address + size > this->size || fseek(this->file, address, SEEK_SET) != 0)
+		return HAL_ERROR;
+
+	size_t read = fread(data, 1, size, this->file);
+
+	memset(data + read, 0xFF, size - read);
+
+	return HAL_OK;
+}
+
+} /* namespace flyhero */
@@ -0,0 +1,105 @@
+/*
+ * DMP_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <cmath>
+#include "MPU6050.h"
+#include "Simulator.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+// same size and start as the vendor 6 axis image, content does not matter to the mock
+static const uint16_t IMAGE_SIZE = 3062;
+static const uint16_t SAMPLE_RATE = 1000;
+static const uint8_t DIVIDER[] = { 4 };
+
+static uint8_t image[IMAGE_SIZE];
+
+static const MPU6050::DMP_Patch patches[] = {
+	{ MPU6050_Model::DMP_RATE_DIVIDER_ADDRESS, DIVIDER, sizeof(DIVIDER) },
+};
+
+static const MPU6050::DMP_Firmware firmware = {
+	image, IMAGE_SIZE, 0x0400, patches, sizeof(patches) / sizeof(patches[0]), uint16_t(SAMPLE_RATE / (DIVIDER[0] + 1))
+};
+
+static void data_ready() {
+	MPU6050::Instance().Start_Read();
+}
+
+// default estimator on the MCU
+static void compute_attitude(uint32_t iterations) {
+	MPU6050& mpu = MPU6050::Instance();
+	float roll, pitch, yaw;
+
+	for (uint32_t i = 0; i < iterations; i++)
+		mpu.Compute_Attitude();
+
+	mpu.Get_Euler(roll, pitch, yaw);
+	Benchmark::Sink = roll;
+}
+
+// what is left on the MCU with DMP
+static void compute_dmp(uint32_t iterations) {
+	MPU6050& mpu = MPU6050::Instance();
+	float roll, pitch, yaw;
+
+	for (uint32_t i = 0; i < iterations; i++)
+		mpu.Compute_DMP();
+
+	mpu.Get_Euler(roll, pitch, yaw);
+	Benchmark::Sink = roll;
+}
+
+// image lands in DMP memory verified, quaternions stream through FIFO
+// and give the attitude of the model
+static bool check() {
+	Simulator& sim = Simulator::Instance();
+	MPU6050& mpu = MPU6050::Instance();
+	double roll, pitch, yaw;
+	float est_roll, est_pitch, est_yaw;
+
+	for (uint16_t i = 0; i < IMAGE_SIZE; i++)
+		image[i] = uint8_t(i * 7 + (i >> 8));
+
+	sim.Get_Model().Set_Attitude(20, -10, 30);
+
+	if (mpu.Init(&firmware) != HAL_OK)
+		return false;
+
+	// patches go over the image
+	for (uint16_t i = 0; i < IMAGE_SIZE; i++) {
+		uint8_t expected = i == MPU6050_Model::DMP_RATE_DIVIDER_ADDRESS ? DIVIDER[0] : image[i];
+
+		if (sim.Get_IMU().Get_DMP_Memory(i) != expected)
+			return false;
+	}
+
+	if (mpu.Set_Sample_Rate(SAMPLE_RATE) != HAL_OK || mpu.Set_DMP_Mode(true) != HAL_OK)
+		return false;
+
+	mpu.Data_Ready_Callback = &data_ready;
+	sim.Advance(100000);
+
+	mpu.Complete_Read();
+	mpu.Compute_DMP();
+
+	mpu.Data_Ready_Callback = NULL;
+	// let the last transfer finish
+	sim.Advance(2000);
+
+	mpu.Get_Euler(est_roll, est_pitch, est_yaw);
+	sim.Get_Model().Get_Euler(roll, pitch, yaw);
+
+	return std::fabs(est_roll - roll) < 0.1 && std::fabs(est_pitch - pitch) < 0.1 && std::fabs(est_yaw - yaw) < 0.1
+			&& mpu.Get_FIFO_Overflows() == 0;
+}
+
+static Benchmark dmp_benchmark("mpu6050_compute_dmp", &compute_dmp, 1000000, &check);
+static Benchmark attitude_benchmark("mpu6050_compute_attitude", &compute_attitude, 1000000);
+
+} /* namespace flyhero */
@@ -0,0 +1,196 @@
+/*
+ * Decimator_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <stdio.h>
+#include <cmath>
+#include <complex>
+#include "Decimator.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+typedef Decimator<6> Sample_Decimator;
+
+static const double PI = 3.14159265358979;
+static const float SAMPLE_RATE = 8000;
+static const uint16_t OUTPUTS = 4000;
+// tones from DC to the input Nyquist, most of them alias into the output band,
+// none onto output Nyquist where the gain would depend on phase
+static const float TONES[] = { 0, 50, 125, 250, 400, 600, 900, 1100, 1450, 2100, 2900, 3700 };
+// measured gain has to match the response down to this level [dB]
+static const double RESOLUTION = -60;
+static const double TOLERANCE = 0.2;		// [dB]
+
+struct Setup {
+	uint8_t ratio;
+	Sample_Decimator::Order order;
+	float anti_alias;
+};
+
+static const Setup setups[] = {
+	{ 8, Sample_Decimator::ORDER_BOXCAR, 0 },
+	{ 8, Sample_Decimator::ORDER_CIC2, 0 },
+	{ 4, Sample_Decimator::ORDER_CIC2, 0 },
+	{ 8, Sample_Decimator::ORDER_CIC2, 300 },
+};
+
+// sinc^order of the averaging times the biquad ahead of it
+static double response(const Setup& setup, double frequency) {
+	double w = 2 * PI * frequency / SAMPLE_RATE;
+	double gain = 1;
+
+	if (frequency > 0) {
+		gain = std::fabs(std::sin(w * setup.ratio / 2) / (setup.ratio * std::sin(w / 2)));
+		gain = std::pow(gain, int(setup.order));
+	}
+
+	if (setup.anti_alias > 0) {
+		Biquad_Filter::Coefficients c = Biquad_Filter::Get_Coefficients(Biquad_Filter::FILTER_LOW_PASS, SAMPLE_RATE, setup.anti_alias);
+		std::complex<double> z1 = std::polar(1.0, -w);
+		std::complex<double> z2 = z1 * z1;
+
+		gain *= std::abs((double(c.a0) + double(c.a1) * z1 + double(c.a2) * z2) / (1.0 + double(c.b1) * z1 + double(c.b2) * z2));
+	}
+
+	return gain;
+}
+
+static double to_db(double gain) {
+	return 20 * std::log10(gain > 1e-9 ? gain : 1e-9);
+}
+
+// RMS gain of one tone through all channels, settling outputs are skipped
+static double measure(const Setup& setup, float frequency) {
+	Sample_Decimator decimator;
+	double sum = 0, reference = 0;
+	uint16_t outputs = 0;
+
+	decimator.Configure(setup.ratio, setup.order);
+	decimator.Set_Anti_Alias(SAMPLE_RATE, setup.anti_alias);
+
+	for (uint32_t i = 0; outputs < OUTPUTS; i++) {
+		// phase differs per channel
+		float input[6], output[6];
+
+		for (uint8_t j = 0; j < 6; j++)
+			input[j] = float(std::cos(2 * PI * frequency * i / SAMPLE_RATE + j * 0.7) * 1000);
+
+		for (uint8_t j = 0; j < 6; j++)
+			reference += double(input[j]) * input[j];
+
+		if (!decimator.Push(input, output))
+			continue;
+
+		outputs++;
+
+		if (outputs < 100) {
+			reference = 0;
+			continue;
+		}
+
+		for (uint8_t j = 0; j < 6; j++)
+			sum += double(output[j]) * output[j];
+	}
+
+	// outputs are ratio times fewer than inputs
+	return std::sqrt(sum * setup.ratio / reference);
+}
+
+static void push(uint32_t iterations) {
+	static Sample_Decimator decimator;
+	float sum = 0;
+
+	decimator.Configure(8, Sample_Decimator::ORDER_CIC2);
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		float data[6];
+
+		for (uint8_t j = 0; j < 6; j++)
+			data[j] = float((i + j) & 0xFF);
+
+		if (decimator.Push(data, data))
+			sum += data[0];
+	}
+
+	Benchmark::Sink = sum;
+}
+
+static void push_anti_alias(uint32_t iterations) {
+	static Sample_Decimator decimator;
+	float sum = 0;
+
+	decimator.Configure(8, Sample_Decimator::ORDER_CIC2);
+	decimator.Set_Anti_Alias(SAMPLE_RATE, 300);
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		float data[6];
+
+		for (uint8_t j = 0; j < 6; j++)
+			data[j] = float((i + j) & 0xFF);
+
+		if (decimator.Push(data, data))
+			sum += data[0];
+	}
+
+	Benchmark::Sink = sum;
+}
+
+// Gains measured on tones have to follow the analytic response, stop band
+// only down to what float noise lets through. Ratio 1 has to pass input as is.
+static bool check() {
+	bool ok = true;
+	Sample_Decimator bypass;
+
+	for (int16_t i = -1000; i < 1000; i++) {
+		float data[6] = { float(i), float(-i), float(i * 3), float(i * 7), 0.5f, -32768 };
+		float output[6];
+
+		if (!bypass.Push(data, output))
+			return false;
+
+		for (uint8_t j = 0; j < 6; j++)
+			ok = ok && output[j] == data[j];
+	}
+
+	for (uint8_t s = 0; s < sizeof(setups) / sizeof(setups[0]); s++) {
+		const Setup& setup = setups[s];
+		Sample_Decimator decimator;
+		double max_error = 0;
+
+		decimator.Configure(setup.ratio, setup.order);
+
+		for (uint8_t t = 0; t < sizeof(TONES) / sizeof(TONES[0]); t++) {
+			double expected = to_db(response(setup, TONES[t]));
+			double measured = to_db(measure(setup, TONES[t]));
+			double error;
+
+			if (expected > RESOLUTION)
+				error = std::fabs(measured - expected);
+			else
+				error = measured > RESOLUTION ? measured - RESOLUTION : 0;
+
+			max_error = error > max_error ? error : max_error;
+		}
+
+		// first alias band edge, output rate minus the control bandwidth of 100 Hz
+		float alias = SAMPLE_RATE / setup.ratio - 100;
+
+		printf("decimator %u:1 %s%s: %.1f dB at %.0f Hz, %.1f dB alias from %.0f Hz, delay %.1f samples, max error %.3f dB\n",
+				setup.ratio, setup.order == Sample_Decimator::ORDER_BOXCAR ? "boxcar" : "CIC2",
+				setup.anti_alias > 0 ? " + biquad" : "", to_db(response(setup, 100)), 100.0,
+				to_db(response(setup, alias)), alias, decimator.Get_Delay(), max_error);
+
+		ok = ok && max_error < TOLERANCE;
+	}
+
+	return ok;
+}
+
+static Benchmark push_benchmark("decimator_6_cic2_push", &push, 1000000, &check);
+static Benchmark anti_alias_benchmark("decimator_6_cic2_biquad_push", &push_anti_alias, 1000000);
+
+} /* namespace flyhero */
@@ -0,0 +1,126 @@
+/*
+ * Dynamic_Notch_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <cmath>
+#include "Dynamic_Notch.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+static const uint16_t RATE = 2000;
+static const float PI = 3.14159265358979323846f;
+
+// slow manoeuvre, two motor harmonics of different strength and noise,
+// phases are integrated so that frequencies may change
+struct Gyro_Signal {
+	float f1, f2;
+	float phase1, phase2;
+	uint32_t i;
+
+	void Next(float out[Dynamic_Notch::AXES]) {
+		float t = float(this->i) / RATE;
+
+		this->phase1 = std::fmod(this->phase1 + 2 * PI * this->f1 / RATE, 2 * PI);
+		this->phase2 = std::fmod(this->phase2 + 2 * PI * this->f2 / RATE, 2 * PI);
+
+		for (uint8_t j = 0; j < Dynamic_Notch::AXES; j++) {
+			float noise = float(int32_t((this->i * 1103515245u + j * 12345u) >> 16 & 0xFF) - 128) / 64;
+
+			out[j] = 30 * std::sin(2 * PI * 2 * t + j) + 12 * std::sin(this->phase1 + j)
+					+ 5 * std::sin(this->phase2) + noise;
+		}
+
+		this->i++;
+	}
+};
+
+static void step(uint32_t iterations) {
+	static Dynamic_Notch notch;
+	static Gyro_Signal signal = { 170, 340, 0, 0, 0 };
+	static bool init = false;
+	float data[Dynamic_Notch::AXES];
+
+	if (!init) {
+		notch.Init(RATE);
+
+		for (uint16_t i = 0; i < Dynamic_Notch::FFT_SIZE; i++) {
+			signal.Next(data);
+			notch.Push(data);
+		}
+
+		init = true;
+	}
+
+	// cost of one scheduler slot, samples keep coming in
+	for (uint32_t i = 0; i < iterations; i++) {
+		signal.Next(data);
+		notch.Push(data);
+		notch.Step();
+	}
+
+	Benchmark::Sink = notch.Get_Frequency(0, 0);
+}
+
+// both peaks found within a few Hz, notch follows when motors speed up
+// and the vibration is attenuated
+static bool check() {
+	static Dynamic_Notch notch;
+	Gyro_Signal signal = { 170, 340, 0, 0, 0 };
+	float data[Dynamic_Notch::AXES];
+
+	notch.Init(RATE);
+
+	for (uint32_t i = 0; i < 4 * RATE; i++) {
+		// ramp 170 -> 230 Hz in the second half
+		if (i > 2 * RATE)
+			signal.f1 = 170 + 60 * float(i - 2 * RATE) / (2 * RATE);
+
+		signal.Next(data);
+		notch.Push(data);
+		notch.Step();
+
+		if (i == 2 * RATE) {
+			for (uint8_t j = 0; j < Dynamic_Notch::AXES; j++) {
+				float low = std::fmin(notch.Get_Frequency(j, 0), notch.Get_Frequency(j, 1));
+				float high = std::fmax(notch.Get_Frequency(j, 0), notch.Get_Frequency(j, 1));
+
+				if (std::fabs(low - 170) > 3 || std::fabs(high - 340) > 3)
+					return false;
+			}
+		}
+	}
+
+	for (uint8_t j = 0; j < Dynamic_Notch::AXES; j++) {
+		float low = std::fmin(notch.Get_Frequency(j, 0), notch.Get_Frequency(j, 1));
+
+		if (std::fabs(low - signal.f1) > 8)
+			return false;
+	}
+
+	// tone at the tracked frequency has to lose at least 20 dB
+	float in_power = 0, out_power = 0;
+
+	for (uint32_t i = 0; i < RATE; i++) {
+		float tone = 10 * std::sin(2 * PI * notch.Get_Frequency(0, 0) * i / RATE);
+
+		data[0] = tone;
+		data[1] = 0;
+		data[2] = 0;
+		notch.Apply_Filter(data);
+
+		if (i > RATE / 2) {
+			in_power += tone * tone;
+			out_power += data[0] * data[0];
+		}
+	}
+
+	return out_power < 0.01f * in_power;
+}
+
+static Benchmark notch_benchmark("dynamic_notch_step", &step, 100000, &check);
+
+} /* namespace flyhero */
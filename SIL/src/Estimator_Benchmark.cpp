@@ -0,0 +1,198 @@
+/*
+ * Estimator_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <stdio.h>
+#include <cmath>
+#include "Mahony_Estimator.h"
+#include "Madgwick_Estimator.h"
+#include "EKF_Estimator.h"
+#include "Attitude_Replay.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+static const uint16_t RATE = 1000;
+static const uint8_t SECONDS = 10;
+static const double PI = 3.14159265358979323846;
+static const double DEG_TO_RAD = PI / 180;
+
+// accepted after the first second
+static const double MAX_TILT_RMS = 2.5;		// [deg]
+static const double MAX_TILT = 5;			// [deg]
+
+// sample rate, period jitter and gyro only steps between accel corrections
+struct Scenario {
+	uint16_t rate;
+	float jitter;
+	uint8_t predict_samples;
+};
+
+static const Scenario SCENARIOS[] = {
+	{ 1000, 0, 0 },
+	{ 500, 0.2f, 0 },
+	{ 2000, 0.2f, 0 },
+	{ 8000, 0.2f, 0 },
+	{ 8000, 0.2f, 7 },
+};
+
+static Attitude_Replay::Record records[8000 * SECONDS];
+static uint32_t record_count = 0;
+
+// Recording of a flight: still for a second, then swinging on all axes with
+// linear acceleration, vibration, gyro noise and residual gyro bias. Truth is
+// integrated in double with exact rotation per step, sample period varies by
+// up to +-jitter.
+static void record(uint16_t rate, float jitter) {
+	const double bias[3] = { 0.5, -0.3, 0.2 };		// [deg/s]
+	double q[4] = { 1, 0, 0, 0 };
+	double t = 0;
+
+	record_count = uint32_t(rate) * SECONDS;
+
+	for (uint32_t i = 0; i < record_count; i++) {
+		Attitude_Replay::Record& record = records[i];
+		double dt = (1 + jitter * (double(int32_t((i * 2654435761u) >> 16 & 0xFF) - 128) / 128)) / rate;
+
+		t += dt;
+
+		double moving = t < 1 ? 0 : 1;
+		double rate[3] = {
+			moving * 120 * std::sin(2 * PI * 0.7 * t),
+			moving * 90 * std::sin(2 * PI * 0.5 * t + 1),
+			moving * 60 * std::sin(2 * PI * 0.3 * t)
+		};
+
+		double norm = std::sqrt(rate[0] * rate[0] + rate[1] * rate[1] + rate[2] * rate[2]);
+		double angle = norm * DEG_TO_RAD * dt;
+
+		if (angle > 0) {
+			double s = std::sin(angle / 2) / norm;
+			double d[4] = { std::cos(angle / 2), rate[0] * s, rate[1] * s, rate[2] * s };
+			double p[4] = { q[0], q[1], q[2], q[3] };
+
+			q[0] = p[0] * d[0] - p[1] * d[1] - p[2] * d[2] - p[3] * d[3];
+			q[1] = p[0] * d[1] + p[1] * d[0] + p[2] * d[3] - p[3] * d[2];
+			q[2] = p[0] * d[2] - p[1] * d[3] + p[2] * d[0] + p[3] * d[1];
+			q[3] = p[0] * d[3] + p[1] * d[2] - p[2] * d[1] + p[3] * d[0];
+		}
+
+		// gravity direction in body frame, third row of the rotation matrix
+		double gravity[3] = {
+			2 * (q[1] * q[3] - q[0] * q[2]),
+			2 * (q[0] * q[1] + q[2] * q[3]),
+			q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3]
+		};
+
+		for (uint8_t j = 0; j < 3; j++) {
+			double noise = double(int32_t((i * 1103515245u + j * 12345u) >> 16 & 0xFF) - 128) / 128;
+			double vibration = std::sin(2 * PI * 170 * t + j);
+
+			record.gyro[j] = rate[j] + bias[j] + noise;
+			record.accel[j] = gravity[j] + moving * 0.1 * std::sin(2 * PI * 1.1 * t + 2 * j) + 0.2 * vibration + 0.02 * noise;
+		}
+
+		record.dt = dt;
+		record.roll = std::atan2(gravity[1], gravity[2]) / DEG_TO_RAD;
+		record.pitch = std::asin(2 * (q[0] * q[2] - q[3] * q[1])) / DEG_TO_RAD;
+		record.yaw = std::atan2(2 * (q[0] * q[3] + q[1] * q[2]), 1 - 2 * (q[2] * q[2] + q[3] * q[3])) / DEG_TO_RAD;
+	}
+}
+
+static Mahony_Estimator mahony;
+static Madgwick_Estimator madgwick;
+static EKF_Estimator ekf;
+
+static void update(Attitude_Estimator& estimator, uint32_t iterations) {
+	static uint32_t index = 0;
+
+	if (record_count != uint32_t(RATE) * SECONDS)
+		record(RATE, 0);
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		estimator.Update(records[index].gyro, records[index].accel, records[index].dt);
+
+		index = index + 1 < record_count ? index + 1 : 0;
+	}
+
+	Benchmark::Sink = estimator.Get_Quaternion().q1;
+}
+
+static void predict(Attitude_Estimator& estimator, uint32_t iterations) {
+	static uint32_t index = 0;
+
+	if (record_count != uint32_t(RATE) * SECONDS)
+		record(RATE, 0);
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		estimator.Predict(records[index].gyro, records[index].dt);
+
+		index = index + 1 < record_count ? index + 1 : 0;
+	}
+
+	Benchmark::Sink = estimator.Get_Quaternion().q1;
+}
+
+// every scenario has to meet the same accuracy, gains do not depend on rate
+static bool check(Attitude_Estimator& estimator) {
+	bool ok = true;
+
+	for (const Scenario& scenario : SCENARIOS) {
+		Attitude_Replay::Result result;
+
+		record(scenario.rate, scenario.jitter);
+		Attitude_Replay::Run(estimator, records, record_count, result, scenario.predict_samples);
+
+		printf("estimator %s at %u Hz, jitter %.0f %%, %u predict steps: tilt rms %.2f max %.2f deg, yaw rms %.2f deg\n",
+				estimator.Get_Name(), scenario.rate, scenario.jitter * 100, scenario.predict_samples,
+				result.tilt_rms, result.tilt_max, result.yaw_rms);
+
+		if (result.tilt_rms >= MAX_TILT_RMS || result.tilt_max >= MAX_TILT)
+			ok = false;
+	}
+
+	return ok;
+}
+
+static void update_mahony(uint32_t iterations) {
+	update(mahony, iterations);
+}
+
+static void update_madgwick(uint32_t iterations) {
+	update(madgwick, iterations);
+}
+
+static void update_ekf(uint32_t iterations) {
+	update(ekf, iterations);
+}
+
+static void predict_mahony(uint32_t iterations) {
+	predict(mahony, iterations);
+}
+
+static void predict_ekf(uint32_t iterations) {
+	predict(ekf, iterations);
+}
+
+static bool check_mahony() {
+	return check(mahony);
+}
+
+static bool check_madgwick() {
+	return check(madgwick);
+}
+
+static bool check_ekf() {
+	return check(ekf);
+}
+
+static Benchmark mahony_benchmark("estimator_mahony", &update_mahony, 1000000, &check_mahony);
+static Benchmark madgwick_benchmark("estimator_madgwick", &update_madgwick, 1000000, &check_madgwick);
+static Benchmark ekf_benchmark("estimator_ekf", &update_ekf, 1000000, &check_ekf);
+static Benchmark mahony_predict_benchmark("estimator_mahony_predict", &predict_mahony, 1000000);
+static Benchmark ekf_predict_benchmark("estimator_ekf_predict", &predict_ekf, 1000000);
+
+} /* namespace flyhero */
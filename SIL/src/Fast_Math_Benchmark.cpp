@@ -0,0 +1,198 @@
+/*
+ * Fast_Math_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <stdio.h>
+#include <cmath>
+#include "Fast_Math.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+// points per sweep, spread evenly over the domain
+static const uint32_t SWEEP = 1000000;
+
+// Sweeps a kernel against double precision, error is absolute or relative
+// to the exact value. Bounds are the ones documented in Fast_Math.h.
+static bool sweep(const char *name, double from, double to, double bound, bool relative,
+		float (*kernel)(float), double (*exact)(double)) {
+	double max_error = 0;
+	double worst = from;
+
+	for (uint32_t i = 0; i <= SWEEP; i++) {
+		float x = float(from + (to - from) * i / SWEEP);
+		double expected = exact(x);
+		double error = std::fabs(kernel(x) - expected);
+
+		if (relative && expected != 0)
+			error /= std::fabs(expected);
+
+		if (!(error <= max_error)) {
+			max_error = error;
+			worst = x;
+		}
+	}
+
+	printf("fast_math %s on [%g, %g]: max %s error %.3g at %g, bound %.3g\n", name, from, to,
+			relative ? "relative" : "absolute", max_error, worst, bound);
+
+	return max_error <= bound;
+}
+
+static float sqrt_kernel(float x) {
+	return Fast_Math::Sqrt(x);
+}
+
+static double sqrt_exact(double x) {
+	return std::sqrt(x);
+}
+
+static float inv_sqrt_kernel(float x) {
+	return Fast_Math::Inv_Sqrt(x);
+}
+
+static double inv_sqrt_exact(double x) {
+	return 1 / std::sqrt(x);
+}
+
+static float sin_kernel(float x) {
+	return Fast_Math::Sin(x);
+}
+
+static double sin_exact(double x) {
+	return std::sin(x);
+}
+
+static float cos_kernel(float x) {
+	return Fast_Math::Cos(x);
+}
+
+static double cos_exact(double x) {
+	return std::cos(x);
+}
+
+static float tan_kernel(float x) {
+	return Fast_Math::Tan(x);
+}
+
+static double tan_exact(double x) {
+	return std::tan(x);
+}
+
+static float asin_kernel(float x) {
+	return Fast_Math::Asin(x);
+}
+
+static double asin_exact(double x) {
+	return std::asin(x);
+}
+
+static float atan2_kernel(float angle) {
+	return Fast_Math::Atan2(float(std::sin(double(angle))), float(std::cos(double(angle))));
+}
+
+// atan2 is swept along the unit circle, every octant and sign combination is hit
+static double atan2_exact(double angle) {
+	return std::atan2(double(float(std::sin(angle))), double(float(std::cos(angle))));
+}
+
+// tan of the filter design, pi * cut / sample below pi / 2
+static double tan_domain_end() {
+	return std::atan(1000.0);
+}
+
+static bool check_sqrt() {
+	return sweep("sqrt", 0, 100, 6e-8, true, &sqrt_kernel, &sqrt_exact)
+			&& sweep("inv_sqrt", 1e-3, 100, 1.2e-7, true, &inv_sqrt_kernel, &inv_sqrt_exact);
+}
+
+static bool check_sin_cos() {
+	return sweep("sin", -2 * Fast_Math::PI, 2 * Fast_Math::PI, 1e-7, false, &sin_kernel, &sin_exact)
+			&& sweep("cos", -2 * Fast_Math::PI, 2 * Fast_Math::PI, 1e-7, false, &cos_kernel, &cos_exact)
+			&& sweep("sin", -8192, 8192, 1e-7, false, &sin_kernel, &sin_exact)
+			&& sweep("tan", -tan_domain_end(), tan_domain_end(), 3e-7, true, &tan_kernel, &tan_exact);
+}
+
+static bool check_asin() {
+	return sweep("asin", -1, 1, 4e-7, false, &asin_kernel, &asin_exact);
+}
+
+static bool check_atan2() {
+	return sweep("atan2", -Fast_Math::PI, Fast_Math::PI, 6e-7, false, &atan2_kernel, &atan2_exact);
+}
+
+// inputs walk through the domain so that branches are not always predicted
+static float input(uint32_t i) {
+	return float(i & 0x3FF) * (1.0f / 512) - 1;
+}
+
+static void bench_inv_sqrt(uint32_t iterations) {
+	float sum = 0;
+
+	for (uint32_t i = 0; i < iterations; i++)
+		sum += Fast_Math::Inv_Sqrt(input(i) + 2);
+
+	Benchmark::Sink = sum;
+}
+
+static void bench_sin_cos(uint32_t iterations) {
+	float sum = 0;
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		float sin, cos;
+
+		Fast_Math::Sin_Cos(input(i) * 4, sin, cos);
+		sum += sin + cos;
+	}
+
+	Benchmark::Sink = sum;
+}
+
+static void bench_tan(uint32_t iterations) {
+	float sum = 0;
+
+	for (uint32_t i = 0; i < iterations; i++)
+		sum += Fast_Math::Tan(input(i));
+
+	Benchmark::Sink = sum;
+}
+
+static void bench_asin(uint32_t iterations) {
+	float sum = 0;
+
+	for (uint32_t i = 0; i < iterations; i++)
+		sum += Fast_Math::Asin(input(i));
+
+	Benchmark::Sink = sum;
+}
+
+static void bench_atan2(uint32_t iterations) {
+	float sum = 0;
+
+	for (uint32_t i = 0; i < iterations; i++)
+		sum += Fast_Math::Atan2(input(i), input(i * 7 + 3));
+
+	Benchmark::Sink = sum;
+}
+
+// what the kernels replace
+static void bench_libm(uint32_t iterations) {
+	double sum = 0;
+
+	for (uint32_t i = 0; i < iterations; i++)
+		sum += std::atan2(double(input(i)), double(input(i * 7 + 3))) + std::asin(double(input(i)));
+
+	Benchmark::Sink = sum;
+}
+
+static Benchmark inv_sqrt_benchmark("fast_math_inv_sqrt", &bench_inv_sqrt, 1000000, &check_sqrt);
+static Benchmark sin_cos_benchmark("fast_math_sin_cos", &bench_sin_cos, 1000000, &check_sin_cos);
+static Benchmark tan_benchmark("fast_math_tan", &bench_tan, 1000000);
+static Benchmark asin_benchmark("fast_math_asin", &bench_asin, 1000000, &check_asin);
+static Benchmark atan2_benchmark("fast_math_atan2", &bench_atan2, 1000000, &check_atan2);
+static Benchmark libm_benchmark("fast_math_libm_atan2_asin", &bench_libm, 1000000);
+
+} /* namespace flyhero */
@@ -0,0 +1,139 @@
+/*
+ * Flash_Storage_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Flash_Storage.h"
+#include "IMU.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+static const uint16_t KEY = 0x0001;
+static const uint16_t OTHER_KEY = 0x0002;
+
+static bool same(const IMU::Calibration& a, const IMU::Calibration& b) {
+	for (uint8_t i = 0; i < 3; i++) {
+		if (a.accel_offsets[i] != b.accel_offsets[i] || a.gyro_offsets[i] != b.gyro_offsets[i])
+			return false;
+	}
+
+	return a.accel_fsr == b.accel_fsr && a.gyro_fsr == b.gyro_fsr;
+}
+
+static IMU::Calibration calibration(float value) {
+	IMU::Calibration calibration = { { value, -value, 2 * value }, { -3 * value, value, 0.5f }, 0x18, 0x18 };
+
+	return calibration;
+}
+
+// boot time lookup of the newest record among older ones
+static void read(uint32_t iterations) {
+	static bool init = false;
+	Flash_Storage& storage = Flash_Storage::Instance();
+	IMU::Calibration data;
+
+	if (!init) {
+		storage.Init(SIM_FLASH_SECTOR, uintptr_t(SIM_FLASH), SIM_FLASH_SIZE, 0);
+		storage.Erase();
+
+		for (uint8_t i = 0; i < 20; i++) {
+			data = calibration(i);
+			storage.Write(i % 2 == 0 ? KEY : OTHER_KEY, &data, sizeof(data));
+		}
+
+		init = true;
+	}
+
+	float sum = 0;
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		storage.Read(KEY, &data, sizeof(data));
+		sum += data.accel_offsets[0];
+	}
+
+	Benchmark::Sink = sum;
+}
+
+// newest record wins and survives re-init, broken record falls back to the
+// previous one, wrong size is refused, full sector refuses writes and is
+// erased by the next init
+static bool check() {
+	Flash_Storage& storage = Flash_Storage::Instance();
+	IMU::Calibration data, expected;
+
+	if (storage.Init(SIM_FLASH_SECTOR, uintptr_t(SIM_FLASH), SIM_FLASH_SIZE, 0) || storage.Erase())
+		return false;
+
+	if (storage.Read(KEY, &data, sizeof(data)) == HAL_OK)
+		return false;
+
+	for (uint8_t i = 1; i <= 3; i++) {
+		expected = calibration(i);
+
+		if (storage.Write(KEY, &expected, sizeof(expected)))
+			return false;
+	}
+
+	data = calibration(7);
+
+	if (storage.Write(OTHER_KEY, &data, sizeof(data)))
+		return false;
+
+	// next boot
+	if (storage.Init(SIM_FLASH_SECTOR, uintptr_t(SIM_FLASH), SIM_FLASH_SIZE, 0)
+			|| storage.Read(KEY, &data, sizeof(data)) || !same(data, expected))
+		return false;
+
+	uint32_t free_space = storage.Get_Free_Space();
+
+	// reset in the middle of programming, first data word got only some bits cleared
+	data = calibration(4);
+
+	if (storage.Write(KEY, &data, sizeof(data)))
+		return false;
+
+	uint32_t record = (SIM_FLASH_SIZE - 12 - free_space) / 4 + 3;
+
+	SIM_FLASH[record] &= 0x0000FFFF;
+
+	if (storage.Init(SIM_FLASH_SECTOR, uintptr_t(SIM_FLASH), SIM_FLASH_SIZE, 0)
+			|| storage.Read(KEY, &data, sizeof(data)) || !same(data, expected))
+		return false;
+
+	if (storage.Read(KEY, &data, sizeof(data) - 4) == HAL_OK)
+		return false;
+
+	// fill up, write that does not fit fails and leaves stored records
+	while (storage.Get_Free_Space() >= sizeof(data)) {
+		if (storage.Write(OTHER_KEY, &data, sizeof(data)))
+			return false;
+	}
+
+	data = calibration(5);
+
+	if (storage.Write(KEY, &data, sizeof(data)) == HAL_OK
+			|| storage.Read(KEY, &data, sizeof(data)) || !same(data, expected))
+		return false;
+
+	// next boot erases as the record would not fit
+	if (storage.Init(SIM_FLASH_SECTOR, uintptr_t(SIM_FLASH), SIM_FLASH_SIZE, sizeof(data))
+			|| storage.Get_Free_Space() != SIM_FLASH_SIZE - 12)
+		return false;
+
+	expected = calibration(5);
+
+	if (storage.Write(KEY, &expected, sizeof(expected)))
+		return false;
+
+	if (storage.Read(KEY, &data, sizeof(data)) || !same(data, expected))
+		return false;
+
+	return storage.Read(OTHER_KEY, &data, sizeof(data)) != HAL_OK;
+}
+
+static Benchmark read_benchmark("flash_storage_read", &read, 10000, &check);
+
+} /* namespace flyhero */
@@ -0,0 +1,165 @@
+/*
+ * Gyro_Bias_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <stdio.h>
+#include <cmath>
+#include <string.h>
+#include "MPU6050.h"
+#include "Simulator.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+static const uint16_t SAMPLE_RATE = 1000;
+static const uint32_t STEP_US = 10000;
+// frame stands on the bench while the board warms up, then flies while it cools
+static const double WARM_FROM = 20, WARM_TO = 60;	// [deg C]
+static const uint32_t WARM_S = 120;
+static const uint32_t COOL_S = 60;
+// errors are judged on 1 s means, noise would hide the bias otherwise
+static const uint16_t BLOCK_STEPS = 100;
+static const float MAX_ERROR = 0.15f;		// [deg/s]
+
+// default bias of the sensor model at 30 deg C
+static const double BIAS[3] = { 1.5, -0.8, 0.4 };
+// [deg/s / deg C] and [deg/s / deg C^2], curved so that nodes have to interpolate
+static const double SLOPE[3] = { 0.04, -0.03, 0.02 };
+static const double CURVE[3] = { 0.0008, 0.0005, -0.0006 };
+
+static double bias(uint8_t axis, double temperature) {
+	double t = temperature - 30;
+
+	return BIAS[axis] + SLOPE[axis] * t + CURVE[axis] * t * t;
+}
+
+static void set_temperature(double temperature) {
+	MPU6050_Model& imu = Simulator::Instance().Get_IMU();
+
+	imu.Set_Temperature(temperature);
+	imu.Set_Gyro_Bias(bias(0, temperature), bias(1, temperature), bias(2, temperature));
+}
+
+static void data_ready() {
+	MPU6050::Instance().Start_Read();
+}
+
+// flight control path lookup
+static void lookup(uint32_t iterations) {
+	static Gyro_Bias_Model model;
+	float sum = 0;
+
+	if (!model.Is_Learned()) {
+		for (uint8_t i = 0; i < 40; i++) {
+			float learned[3] = { float(bias(0, 20 + i)), float(bias(1, 20 + i)), float(bias(2, 20 + i)) };
+
+			model.Learn(20 + i, learned);
+		}
+	}
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		float result[3];
+
+		model.Get_Bias(20 + (i & 0x3FF) * (40.0f / 1024), result);
+		sum += result[0];
+	}
+
+	Benchmark::Sink = sum;
+}
+
+// Replays a temperature ramp through the driver: the still frame warms up with
+// learning enabled, then cools down with learning disabled as in flight. Gyro
+// output has to stay at zero where calibration offsets alone drift off.
+static bool check() {
+	Simulator& sim = Simulator::Instance();
+	MPU6050& mpu = MPU6050::Instance();
+	Gyro_Bias_Model& model = mpu.Get_Gyro_Bias_Model();
+	MPU6050::Sensor_Data gyro;
+	Gyro_Bias_Model::Table table, restored;
+	double sum[3] = { 0 };
+	double max_error = 0, max_drift = 0;
+	double temperature = WARM_FROM;
+
+	sim.Get_Model().Reset();
+	set_temperature(temperature);
+
+	if (mpu.Init() != HAL_OK || mpu.Set_Sample_Rate(SAMPLE_RATE) != HAL_OK
+			|| mpu.Set_DMP_Mode(false) != HAL_OK || mpu.Set_FIFO_Mode(false) != HAL_OK)
+		return false;
+
+	model.Reset();
+	mpu.Set_Read_Rate(SAMPLE_RATE);
+	mpu.Start_Calibration();
+	mpu.Set_Bias_Learning(true);
+	mpu.Data_Ready_Callback = &data_ready;
+
+	for (uint32_t i = 0; i < WARM_S * 1000000 / STEP_US; i++) {
+		temperature = WARM_FROM + (WARM_TO - WARM_FROM) * i / (WARM_S * 1000000 / STEP_US);
+		set_temperature(temperature);
+
+		sim.Advance(STEP_US);
+		mpu.Update_Calibration();
+		mpu.Complete_Read();
+	}
+
+	uint32_t updates = model.Get_Updates();
+
+	mpu.Set_Bias_Learning(false);
+
+	for (uint32_t i = 0; i < COOL_S * 1000000 / STEP_US; i++) {
+		temperature = WARM_TO - (WARM_TO - WARM_FROM) * i / (COOL_S * 1000000 / STEP_US);
+		set_temperature(temperature);
+
+		sim.Advance(STEP_US);
+		mpu.Complete_Read();
+		mpu.Get_Gyro(gyro);
+
+		sum[0] += gyro.x;
+		sum[1] += gyro.y;
+		sum[2] += gyro.z;
+
+		if ((i + 1) % BLOCK_STEPS != 0)
+			continue;
+
+		for (uint8_t j = 0; j < 3; j++) {
+			double error = std::fabs(sum[j] / BLOCK_STEPS);
+			// what offsets taken at the start of the warm up would leave
+			double drift = std::fabs(bias(j, temperature) - bias(j, WARM_FROM));
+
+			max_error = error > max_error ? error : max_error;
+			max_drift = drift > max_drift ? drift : max_drift;
+			sum[j] = 0;
+		}
+	}
+
+	mpu.Data_Ready_Callback = NULL;
+	// let the last transfer finish
+	sim.Advance(2000);
+
+	printf("gyro bias %.0f -> %.0f -> %.0f deg C: %u stationary periods learned, max error %.3f deg/s, without model %.3f deg/s\n",
+			WARM_FROM, WARM_TO, WARM_FROM, updates, max_error, max_drift);
+
+	// stored table gives the same model on the next boot, garbage is refused
+	model.Get_Table(table);
+	model.Reset();
+
+	bool restored_ok = model.Set_Table(table);
+
+	model.Get_Table(restored);
+	restored_ok = restored_ok && memcmp(&table, &restored, sizeof(table)) == 0;
+
+	restored.weight[0] = -1;
+	restored_ok = restored_ok && !model.Set_Table(restored);
+
+	model.Reset();
+	set_temperature(30);
+
+	return updates > 100 && max_error < MAX_ERROR && restored_ok;
+}
+
+static Benchmark lookup_benchmark("gyro_bias_model_lookup", &lookup, 1000000, &check);
+
+} /* namespace flyhero */
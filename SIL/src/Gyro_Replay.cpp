@@ -0,0 +1,90 @@
+/*
+ * Gyro_Replay.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <stdio.h>
+#include <cmath>
+#include "Gyro_Replay.h"
+#include "Dynamic_Notch.h"
+
+namespace flyhero {
+
+int Gyro_Replay::Analyze(const char *file, uint16_t rate) {
+	if (rate == 0) {
+		printf("invalid sample rate\n");
+		return 1;
+	}
+
+	FILE *input = fopen(file, "r");
+
+	if (input == NULL) {
+		printf("cannot open %s\n", file);
+		return 1;
+	}
+
+	static Dynamic_Notch notch;
+	uint16_t samples_per_step = rate > STEP_RATE ? rate / STEP_RATE : 1;
+	uint32_t samples_per_report = uint32_t(rate) * REPORT_MS / 1000;
+	double in_power[Dynamic_Notch::AXES] = { 0 };
+	double out_power[Dynamic_Notch::AXES] = { 0 };
+	uint32_t count = 0;
+	char line[128];
+
+	notch.Init(rate);
+
+	printf("t_ms;peaks x;peaks y;peaks z [Hz]\n");
+
+	while (fgets(line, sizeof(line), input) != NULL) {
+		float gyro[Dynamic_Notch::AXES];
+
+		// header or garbage lines are skipped
+		if (sscanf(line, "%f;%f;%f", &gyro[0], &gyro[1], &gyro[2]) != 3)
+			continue;
+
+		notch.Push(gyro);
+
+		float raw[Dynamic_Notch::AXES] = { gyro[0], gyro[1], gyro[2] };
+
+		notch.Apply_Filter(gyro);
+
+		for (uint8_t i = 0; i < Dynamic_Notch::AXES; i++) {
+			in_power[i] += raw[i] * raw[i];
+			out_power[i] += gyro[i] * gyro[i];
+		}
+
+		count++;
+
+		if (count % samples_per_step == 0)
+			notch.Step();
+
+		if (count % samples_per_report == 0) {
+			printf("%u", uint32_t(uint64_t(count) * 1000 / rate));
+
+			for (uint8_t i = 0; i < Dynamic_Notch::AXES; i++)
+				printf(";%.1f/%.1f", notch.Get_Frequency(i, 0), notch.Get_Frequency(i, 1));
+
+			printf("\n");
+		}
+	}
+
+	fclose(input);
+
+	if (count == 0) {
+		printf("no samples in %s\n", file);
+		return 1;
+	}
+
+	printf("%u samples, rms before/after notch [deg/s]:", count);
+
+	for (uint8_t i = 0; i < Dynamic_Notch::AXES; i++)
+		printf(" %.2f/%.2f", std::sqrt(in_power[i] / count), std::sqrt(out_power[i] / count));
+
+	printf("\n");
+
+	return 0;
+}
+
+} /* namespace flyhero */
@@ -0,0 +1,133 @@
+/*
+ * IMU_Backend_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <stdio.h>
+#include <cmath>
+#include "IMU.h"
+#include "MPU6050.h"
+#include "MPU6000.h"
+#include "Simulator.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+static const uint32_t RUN_US = 100000;
+static const uint32_t STEP_US = 1000;
+static const double TEMPERATURE = 40;		// [deg C]
+
+struct Backend {
+	const char *name;
+	IMU_Type type;
+	uint8_t who_am_i;
+	uint16_t sample_rate;
+};
+
+// I2C cannot read every sample at more than 1 kHz, SPI goes to 8 kHz
+static const Backend backends[] = {
+	{ "MPU6050 I2C", IMU_MPU6050, MPU6050_Model::WHO_AM_I_MPU6050, 1000 },
+	{ "MPU6000 SPI", IMU_MPU6000, MPU6050_Model::WHO_AM_I_MPU6050, 1000 },
+	{ "ICM-20602 SPI", IMU_MPU6000, MPU6050_Model::WHO_AM_I_ICM20602, 8000 },
+};
+
+static volatile uint32_t data_readys, reads;
+
+static void data_ready() {
+	data_readys++;
+	IMU::Instance().Start_Read();
+}
+
+static void data_read() {
+	reads++;
+}
+
+// control loop at 1 kHz averaging 8 kHz samples
+static void complete_read(uint32_t iterations) {
+	IMU& imu = IMU::Instance();
+	IMU::Ring& ring = imu.Get_Sample_Ring();
+	IMU::Sample sample = IMU::Sample();
+	IMU::Sensor_Data gyro;
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		for (uint8_t j = 0; j < 8; j++) {
+			sample.gyro.x = int16_t(i + j);
+			ring.Push(sample);
+		}
+
+		imu.Complete_Read();
+	}
+
+	imu.Get_Gyro(gyro);
+	Benchmark::Sink = gyro.x;
+}
+
+// Every sample the model produces has to reach the ring, at the rate asked for,
+// and temperature has to come out right for the part WHO_AM_I reports.
+static bool run(const Backend& backend) {
+	Simulator& sim = Simulator::Instance();
+	MPU6050_Model& model = sim.Get_IMU();
+	IMU& imu = IMU::Create_Instance(backend.type);
+	uint32_t samples = 0;
+
+	model.Set_WHO_AM_I(backend.who_am_i);
+	model.Set_Temperature(TEMPERATURE);
+
+	if (imu.Init() != HAL_OK || imu.Set_Sample_Rate(backend.sample_rate) != HAL_OK
+			|| imu.Set_FIFO_Mode(false) != HAL_OK)
+		return false;
+
+	// model picks the new sample period up with the next sample
+	sim.Advance(2000);
+
+	imu.Data_Ready_Callback = &data_ready;
+	imu.Data_Read_Callback = &data_read;
+	data_readys = 0;
+	reads = 0;
+	// no stale samples from the other backend
+	imu.Complete_Read();
+
+	for (uint32_t t = 0; t < RUN_US; t += STEP_US) {
+		sim.Advance(STEP_US);
+		samples += imu.Complete_Read();
+	}
+
+	imu.Data_Ready_Callback = NULL;
+	imu.Data_Read_Callback = NULL;
+	// let the last transfer finish
+	sim.Advance(2000);
+	samples += imu.Complete_Read();
+
+	uint32_t expected = uint32_t(uint64_t(RUN_US) * backend.sample_rate / 1000000);
+	float temperature = imu.Get_Temperature();
+	bool ok = imu.Get_Sample_Rate() == backend.sample_rate && data_readys == reads && reads == samples
+			&& samples + 1 >= expected && samples <= expected + 1
+			&& std::fabs(temperature - TEMPERATURE) < 0.1;
+
+	printf("imu backend %s: %u samples at %u Hz in %u ms, %u expected, temperature %.2f deg C\n",
+			backend.name, samples, imu.Get_Sample_Rate(), RUN_US / 1000, expected, temperature);
+
+	return ok;
+}
+
+static bool check() {
+	bool ok = true;
+
+	for (uint8_t i = 0; i < sizeof(backends) / sizeof(backends[0]); i++)
+		ok = run(backends[i]) && ok;
+
+	ok = MPU6000::Instance().Get_Device() == MPU6000::DEVICE_ICM20602 && ok;
+
+	// the rest of SIL runs on MPU6050
+	Simulator::Instance().Get_IMU().Set_WHO_AM_I(MPU6050_Model::WHO_AM_I_MPU6050);
+	Simulator::Instance().Get_IMU().Set_Temperature(30);
+	IMU::Create_Instance(IMU_MPU6050);
+
+	return ok;
+}
+
+static Benchmark complete_read_benchmark("imu_complete_read_8x", &complete_read, 100000, &check);
+
+} /* namespace flyhero */
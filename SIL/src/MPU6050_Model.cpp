@@ -0,0 +1,288 @@
+/*
+ * MPU6050_Model.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "MPU6050_Model.h"
+
+namespace flyhero {
+
+MPU6050_Model::MPU6050_Model()
+	: generator(1234)
+	, normal(0, 1)
+{
+	this->temperature = 30;
+	this->gyro_bias = { 1.5, -0.8, 0.4 };
+	this->accel_bias = { 0.02, -0.03, 0.05 };
+	this->gyro_noise = 0.05;
+	this->accel_noise = 0.004;
+	this->who_am_i = WHO_AM_I_MPU6050;
+
+	this->Reset();
+}
+
+void MPU6050_Model::Reset() {
+	memset(this->registers, 0, sizeof(this->registers));
+	this->fifo_head = 0;
+	this->fifo_count = 0;
+	this->dmp_samples = 0;
+	memset(this->dmp_memory, 0, sizeof(this->dmp_memory));
+
+	// sleep after reset
+	this->registers[this->REGISTERS.PWR_MGMT_1] = 0x40;
+	this->registers[this->REGISTERS.WHO_AM_I] = this->who_am_i;
+}
+
+int16_t MPU6050_Model::read_word(uint8_t reg) {
+	return (this->registers[reg] << 8) | this->registers[reg + 1];
+}
+
+void MPU6050_Model::write_word(uint8_t reg, int16_t value) {
+	this->registers[reg] = uint16_t(value) >> 8;
+	this->registers[reg + 1] = uint16_t(value) & 0xFF;
+}
+
+int16_t MPU6050_Model::saturate(double value) {
+	if (value > 32767)
+		return 32767;
+	if (value < -32768)
+		return -32768;
+
+	return int16_t(std::lround(value));
+}
+
+// full FIFO drops the oldest bytes and flags overflow
+void MPU6050_Model::fifo_push(const uint8_t *data, uint8_t size) {
+	for (uint8_t i = 0; i < size; i++) {
+		this->fifo[(this->fifo_head + this->fifo_count) % FIFO_SIZE] = data[i];
+
+		if (this->fifo_count < FIFO_SIZE)
+			this->fifo_count++;
+		else {
+			this->fifo_head = (this->fifo_head + 1) % FIFO_SIZE;
+			this->registers[this->REGISTERS.INT_STATUS] |= 0x10;
+		}
+	}
+}
+
+uint8_t MPU6050_Model::fifo_pop() {
+	if (this->fifo_count == 0)
+		return 0;
+
+	uint8_t data = this->fifo[this->fifo_head];
+
+	this->fifo_head = (this->fifo_head + 1) % FIFO_SIZE;
+	this->fifo_count--;
+
+	return data;
+}
+
+void MPU6050_Model::fifo_update_count() {
+	this->registers[this->REGISTERS.FIFO_COUNT_H] = this->fifo_count >> 8;
+	this->registers[this->REGISTERS.FIFO_COUNT_H + 1] = this->fifo_count & 0xFF;
+}
+
+uint16_t MPU6050_Model::dmp_address() {
+	return ((this->registers[this->REGISTERS.BANK_SEL] << 8) | this->registers[this->REGISTERS.MEM_START_ADDR]) % DMP_MEMORY_SIZE;
+}
+
+// MEM_R_W access moves the address within the bank
+void MPU6050_Model::dmp_advance() {
+	this->registers[this->REGISTERS.MEM_START_ADDR]++;
+}
+
+// q30 big endian w, x, y, z like the DMP 6 axis quaternion
+void MPU6050_Model::dmp_sample(Quadcopter_Model& model) {
+	bool running = (this->registers[this->REGISTERS.USER_CTRL] & 0xC0) == 0xC0
+			&& (this->registers[this->REGISTERS.PRGM_START_H] | this->registers[this->REGISTERS.PRGM_START_H + 1]) != 0;
+
+	if (!running)
+		return;
+
+	this->dmp_samples++;
+
+	if (this->dmp_samples <= this->dmp_memory[DMP_RATE_DIVIDER_ADDRESS])
+		return;
+
+	this->dmp_samples = 0;
+
+	double q[4];
+	model.Get_Quaternion(q);
+
+	uint8_t packet[16];
+
+	for (uint8_t i = 0; i < 4; i++) {
+		uint32_t value = uint32_t(int32_t(std::lround(q[i] * (1 << 30))));
+
+		packet[4 * i] = value >> 24;
+		packet[4 * i + 1] = (value >> 16) & 0xFF;
+		packet[4 * i + 2] = (value >> 8) & 0xFF;
+		packet[4 * i + 3] = value & 0xFF;
+	}
+
+	this->fifo_push(packet, sizeof(packet));
+
+	this->fifo_update_count();
+}
+
+void MPU6050_Model::Write(uint8_t reg, const uint8_t *data, uint16_t size) {
+	for (uint16_t i = 0; i < size && reg + i < 128; i++) {
+		uint8_t r = reg + i;
+
+		if (r == this->REGISTERS.PWR_MGMT_1 && (data[i] & 0x80)) {
+			this->Reset();
+			continue;
+		}
+		if (r == this->REGISTERS.WHO_AM_I || r == this->REGISTERS.INT_STATUS)
+			continue;
+
+		// FIFO_RESET and DMP_RESET are taken only while disabled and clear themselves
+		if (r == this->REGISTERS.USER_CTRL && (data[i] & 0x0C)) {
+			if ((data[i] & 0x04) && !(data[i] & 0x40)) {
+				this->fifo_head = 0;
+				this->fifo_count = 0;
+				this->fifo_update_count();
+			}
+
+			if ((data[i] & 0x08) && !(data[i] & 0x80))
+				this->dmp_samples = 0;
+
+			this->registers[r] = data[i] & ~0x0C;
+			continue;
+		}
+
+		// burst goes to DMP memory, register address stays
+		if (r == this->REGISTERS.MEM_R_W) {
+			for (; i < size; i++) {
+				this->dmp_memory[this->dmp_address()] = data[i];
+				this->dmp_advance();
+			}
+
+			break;
+		}
+
+		this->registers[r] = data[i];
+	}
+}
+
+// burst read of FIFO_R_W does not advance the address, it pops the FIFO
+void MPU6050_Model::Read(uint8_t reg, uint8_t *data, uint16_t size) {
+	if (reg == this->REGISTERS.FIFO_R_W) {
+		for (uint16_t i = 0; i < size; i++)
+			data[i] = this->fifo_pop();
+
+		this->fifo_update_count();
+		return;
+	}
+
+	if (reg == this->REGISTERS.MEM_R_W) {
+		for (uint16_t i = 0; i < size; i++) {
+			data[i] = this->dmp_memory[this->dmp_address()];
+			this->dmp_advance();
+		}
+
+		return;
+	}
+
+	for (uint16_t i = 0; i < size; i++)
+		data[i] = (reg + i < 128) ? this->registers[reg + i] : 0;
+}
+
+void MPU6050_Model::Sample(Quadcopter_Model& model) {
+	Quadcopter_Model::Vector rates = model.Get_Rates_Dps();
+	Quadcopter_Model::Vector force = model.Get_Specific_Force_G();
+
+	// LSB per unit for current full scale ranges
+	double g_lsb = 131.0 / (1 << ((this->registers[this->REGISTERS.GYRO_CONFIG] >> 3) & 0x03));
+	double a_lsb = 16384.0 / (1 << ((this->registers[this->REGISTERS.ACCEL_CONFIG] >> 3) & 0x03));
+
+	// offset registers: gyro in +-1000 dps format, accel in +-16 g format with bit 0 reserved
+	double g_off_scale = g_lsb / 32.8;
+	double a_off_scale = a_lsb / 2048.0;
+
+	int16_t accel_off_x = this->read_word(this->REGISTERS.ACCEL_X_OFFSET) & ~0x01;
+	int16_t accel_off_y = this->read_word(this->REGISTERS.ACCEL_X_OFFSET + 2) & ~0x01;
+	int16_t accel_off_z = this->read_word(this->REGISTERS.ACCEL_X_OFFSET + 4) & ~0x01;
+
+	this->write_word(this->REGISTERS.ACCEL_XOUT_H,
+			this->saturate((force.x + this->accel_bias.x + this->accel_noise * this->normal(this->generator)) * a_lsb + accel_off_x * a_off_scale));
+	this->write_word(this->REGISTERS.ACCEL_XOUT_H + 2,
+			this->saturate((force.y + this->accel_bias.y + this->accel_noise * this->normal(this->generator)) * a_lsb + accel_off_y * a_off_scale));
+	this->write_word(this->REGISTERS.ACCEL_XOUT_H + 4,
+			this->saturate((force.z + this->accel_bias.z + this->accel_noise * this->normal(this->generator)) * a_lsb + accel_off_z * a_off_scale));
+
+	if (this->who_am_i == WHO_AM_I_ICM20602)
+		this->write_word(this->REGISTERS.ACCEL_XOUT_H + 6, this->saturate((this->temperature - 25) * 326.8));
+	else
+		this->write_word(this->REGISTERS.ACCEL_XOUT_H + 6, this->saturate((this->temperature - 36.53) * 340));
+
+	this->write_word(this->REGISTERS.ACCEL_XOUT_H + 8,
+			this->saturate((rates.x + this->gyro_bias.x + this->gyro_noise * this->normal(this->generator)) * g_lsb + this->read_word(this->REGISTERS.GYRO_X_OFFSET) * g_off_scale));
+	this->write_word(this->REGISTERS.ACCEL_XOUT_H + 10,
+			this->saturate((rates.y + this->gyro_bias.y + this->gyro_noise * this->normal(this->generator)) * g_lsb + this->read_word(this->REGISTERS.GYRO_X_OFFSET + 2) * g_off_scale));
+	this->write_word(this->REGISTERS.ACCEL_XOUT_H + 12,
+			this->saturate((rates.z + this->gyro_bias.z + this->gyro_noise * this->normal(this->generator)) * g_lsb + this->read_word(this->REGISTERS.GYRO_X_OFFSET + 4) * g_off_scale));
+
+	// same order as output registers
+	if (this->registers[this->REGISTERS.USER_CTRL] & 0x40) {
+		uint8_t fifo_en = this->registers[this->REGISTERS.FIFO_EN];
+
+		if (fifo_en & 0x08)
+			this->fifo_push(this->registers + this->REGISTERS.ACCEL_XOUT_H, 6);
+		if (fifo_en & 0x80)
+			this->fifo_push(this->registers + this->REGISTERS.ACCEL_XOUT_H + 6, 2);
+		if (fifo_en & 0x40)
+			this->fifo_push(this->registers + this->REGISTERS.ACCEL_XOUT_H + 8, 2);
+		if (fifo_en & 0x20)
+			this->fifo_push(this->registers + this->REGISTERS.ACCEL_XOUT_H + 10, 2);
+		if (fifo_en & 0x10)
+			this->fifo_push(this->registers + this->REGISTERS.ACCEL_XOUT_H + 12, 2);
+
+		this->fifo_update_count();
+	}
+
+	this->dmp_sample(model);
+
+	this->registers[this->REGISTERS.INT_STATUS] |= 0x01;
+}
+
+void MPU6050_Model::Set_Gyro_Bias(double x, double y, double z) {
+	this->gyro_bias = { x, y, z };
+}
+
+void MPU6050_Model::Set_Accel_Bias(double x, double y, double z) {
+	this->accel_bias = { x, y, z };
+}
+
+void MPU6050_Model::Set_Noise(double gyro_dps, double accel_g) {
+	this->gyro_noise = gyro_dps;
+	this->accel_noise = accel_g;
+}
+
+void MPU6050_Model::Set_Temperature(double temperature) {
+	this->temperature = temperature;
+}
+
+void MPU6050_Model::Set_WHO_AM_I(uint8_t who_am_i) {
+	this->who_am_i = who_am_i;
+	this->registers[this->REGISTERS.WHO_AM_I] = who_am_i;
+}
+
+uint32_t MPU6050_Model::Get_Sample_Period_us() {
+	uint8_t dlpf = this->registers[this->REGISTERS.CONFIG] & 0x07;
+	uint32_t gyro_rate = (dlpf == 0 || dlpf == 7) ? 8000 : 1000;
+
+	return 1000000 * (1 + this->registers[this->REGISTERS.SMPRT_DIV]) / gyro_rate;
+}
+
+uint8_t MPU6050_Model::Get_DMP_Memory(uint16_t address) {
+	return this->dmp_memory[address % DMP_MEMORY_SIZE];
+}
+
+bool MPU6050_Model::Data_Ready_Interrupt_Enabled() {
+	return (this->registers[this->REGISTERS.INT_ENABLE] & 0x01) && !(this->registers[this->REGISTERS.PWR_MGMT_1] & 0x40);
+}
+
+} /* namespace flyhero */
@@ -0,0 +1,95 @@
+/*
+ * Mixer_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <cmath>
+#include "Mixer.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+static const float MIN = 1050;
+static const float MAX = 2000;
+
+template <Frame_Type FRAME>
+static void mix(uint32_t iterations) {
+	float outputs[Mixer<FRAME>::MOTORS];
+	float sum = 0;
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		// sweeps into saturation every few calls
+		float correction = float(i & 0xFF) - 128;
+
+		Mixer<FRAME>::Mix(1400, correction, -0.5f * correction, 2 * correction, MIN, MAX, outputs);
+		sum += outputs[i % Mixer<FRAME>::MOTORS];
+	}
+
+	Benchmark::Sink = sum;
+}
+
+template <Frame_Type FRAME>
+static bool check() {
+	typedef Mixer<FRAME> Frame_Mixer;
+
+	float outputs[Frame_Mixer::MOTORS];
+	float corrections[Frame_Mixer::MOTORS];
+
+	for (int16_t throttle = 1000; throttle <= 2050; throttle += 50) {
+		for (int16_t c = -1000; c <= 1000; c += 25) {
+			float roll = c, pitch = -0.7f * c, yaw = 0.3f * c;
+			float lowest = 0, highest = 0;
+
+			for (uint8_t i = 0; i < Frame_Mixer::MOTORS; i++) {
+				const Motor_Mix& m = Frame_Mixer::Geometry::MIX[i];
+
+				corrections[i] = roll * m.roll + pitch * m.pitch + yaw * m.yaw;
+
+				if (i == 0 || corrections[i] < lowest)
+					lowest = corrections[i];
+				if (i == 0 || corrections[i] > highest)
+					highest = corrections[i];
+			}
+
+			Frame_Mixer::Mix(throttle, roll, pitch, yaw, MIN, MAX, outputs);
+
+			for (uint8_t i = 0; i < Frame_Mixer::MOTORS; i++) {
+				// never outside limits
+				if (outputs[i] < MIN - 0.01f || outputs[i] > MAX + 0.01f)
+					return false;
+
+				// motor differences are kept whenever they fit at all
+				if (highest - lowest <= MAX - MIN
+						&& std::fabs((outputs[i] - outputs[0]) - (corrections[i] - corrections[0])) > 0.01f)
+					return false;
+
+				// untouched when not saturated
+				if (throttle + lowest >= MIN && throttle + highest <= MAX
+						&& std::fabs(outputs[i] - (throttle + corrections[i])) > 0.01f)
+					return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// matches the hand written quad X mix it replaced
+static bool check_quad_x() {
+	float outputs[4];
+
+	Mixer<FRAME_QUAD_X>::Mix(1500, 10, 20, 30, MIN, MAX, outputs);
+
+	return outputs[0] == 1500 - 10 - 20 - 30 && outputs[1] == 1500 - 10 + 20 + 30
+			&& outputs[2] == 1500 + 10 - 20 + 30 && outputs[3] == 1500 + 10 + 20 - 30
+			&& check<FRAME_QUAD_X>();
+}
+
+static Benchmark quad_x_benchmark("mixer_quad_x", &mix<FRAME_QUAD_X>, 1000000, &check_quad_x);
+static Benchmark quad_plus_benchmark("mixer_quad_plus", &mix<FRAME_QUAD_PLUS>, 1000000, &check<FRAME_QUAD_PLUS>);
+static Benchmark hexa_x_benchmark("mixer_hexa_x", &mix<FRAME_HEXA_X>, 1000000, &check<FRAME_HEXA_X>);
+static Benchmark octo_x_benchmark("mixer_octo_x", &mix<FRAME_OCTO_X>, 1000000, &check<FRAME_OCTO_X>);
+
+} /* namespace flyhero */
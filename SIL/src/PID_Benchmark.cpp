@@ -0,0 +1,102 @@
+/*
+ * PID_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <cmath>
+#include "PID.h"
+#include "PID3.h"
+#include "Timer.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+// control loop period, virtual timer is moved by hand
+static const uint32_t PERIOD_US = 1000;
+
+static float error(uint32_t i, uint8_t axis) {
+	return std::sin(i * 0.01f + axis) * 20;
+}
+
+static void pid(uint32_t iterations) {
+	static PID roll(50, 1, 1, 0.02f), pitch(50, 1, 1, 0.02f), yaw(50, 1, 0.5f, 0);
+	float sum = 0;
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		TIM5->CNT += PERIOD_US;
+
+		float e = float(i & 0x3F) - 32;
+
+		sum += roll.Get_PID(e);
+		sum += pitch.Get_PID(-e);
+		sum += yaw.Get_PID(0.5f * e);
+	}
+
+	Benchmark::Sink = sum;
+}
+
+static void pid3(uint32_t iterations) {
+	static PID3 pid;
+	static bool init = false;
+	float sum = 0;
+
+	if (!init) {
+		pid.Set_I_Max(50);
+		pid.Set_Constants(0, 1, 1, 0.02f);
+		pid.Set_Constants(1, 1, 1, 0.02f);
+		pid.Set_Constants(2, 1, 0.5f, 0);
+		init = true;
+	}
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		TIM5->CNT += PERIOD_US;
+
+		float e = float(i & 0x3F) - 32;
+		float errors[PID3::AXES] = { e, -e, 0.5f * e };
+		float output[PID3::AXES];
+
+		pid.Update(Timer::Get_Tick_Count(), errors, output);
+
+		sum += output[0] + output[1] + output[2];
+	}
+
+	Benchmark::Sink = sum;
+}
+
+// both engines agree once the first D term sample is behind them
+static bool check() {
+	PID roll(50, 1.5f, 1, 0.05f), pitch(50, 1.5f, 1, 0.05f), yaw(50, 2, 0.5f, 0);
+	PID3 pid;
+
+	pid.Set_I_Max(50);
+	pid.Set_Constants(0, 1.5f, 1, 0.05f);
+	pid.Set_Constants(1, 1.5f, 1, 0.05f);
+	pid.Set_Constants(2, 2, 0.5f, 0);
+
+	for (uint32_t i = 0; i < 2000; i++) {
+		TIM5->CNT += PERIOD_US;
+
+		float errors[PID3::AXES] = { error(i, 0), error(i, 1), error(i, 2) };
+		float output[PID3::AXES];
+		float expected[PID3::AXES] = { roll.Get_PID(errors[0]), pitch.Get_PID(errors[1]), yaw.Get_PID(errors[2]) };
+
+		pid.Update(Timer::Get_Tick_Count(), errors, output);
+
+		if (i < 500)
+			continue;
+
+		for (uint8_t j = 0; j < PID3::AXES; j++) {
+			if (std::fabs(output[j] - expected[j]) > 0.01f * (1 + std::fabs(expected[j])))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+static Benchmark pid_benchmark("pid_3x_legacy", &pid, 1000000);
+static Benchmark pid3_benchmark("pid3", &pid3, 1000000, &check);
+
+} /* namespace flyhero */
@@ -0,0 +1,247 @@
+/*
+ * Quadcopter_Model.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Quadcopter_Model.h"
+
+namespace flyhero {
+
+Quadcopter_Model::Quadcopter_Model() {
+	// arm layout as Frame_Geometry<FRAME_QUAD_X> expects it
+	// FL -> channel 3, BL -> channel 2, FR -> channel 4, BR -> channel 1
+	this->motors[0] = { 3,  0.115, -0.115, -1 };
+	this->motors[1] = { 2, -0.115, -0.115,  1 };
+	this->motors[2] = { 4,  0.115,  0.115,  1 };
+	this->motors[3] = { 1, -0.115,  0.115, -1 };
+
+	this->vibration_accel = 0;
+	this->vibration_gyro = 0;
+
+	this->Reset();
+}
+
+void Quadcopter_Model::Reset() {
+	for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+		this->motor_output[i] = 0;
+		this->motor_phase[i] = i * 0.7;
+	}
+
+	this->q0 = 1;
+	this->q1 = 0;
+	this->q2 = 0;
+	this->q3 = 0;
+
+	this->position = { 0, 0, 0 };
+	this->velocity = { 0, 0, 0 };
+	this->rates = { 0, 0, 0 };
+	this->specific_force = { 0, 0, this->GRAVITY };
+	this->disturbance = { 0, 0, 0 };
+	this->vibration_a = { 0, 0, 0 };
+	this->vibration_g = { 0, 0, 0 };
+	this->on_ground = true;
+}
+
+double Quadcopter_Model::pulse_to_output(uint16_t pulse) {
+	if (pulse <= 1000)
+		return 0;
+	if (pulse >= 2000)
+		return 1;
+
+	return (pulse - 1000) * 0.001;
+}
+
+void Quadcopter_Model::Step(double dt, const uint16_t pulses[MOTOR_COUNT]) {
+	Vector torque = this->disturbance;
+	double thrust = 0;
+
+	this->vibration_a = { 0, 0, 0 };
+	this->vibration_g = { 0, 0, 0 };
+
+	for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+		Motor& m = this->motors[i];
+
+		// ESC + motor modelled as first order lag
+		double command = this->pulse_to_output(pulses[m.channel - 1]);
+		this->motor_output[i] += (command - this->motor_output[i]) * dt / this->MOTOR_TIME_CONSTANT;
+
+		// thrust goes with square of RPM
+		double u = this->motor_output[i];
+		double f = this->MAX_THRUST * u * u;
+
+		thrust += f;
+		torque.x += m.y * f;
+		torque.y -= m.x * f;
+		torque.z += m.yaw * this->YAW_COEFFICIENT * f;
+
+		// prop imbalance shows up at rotation frequency
+		this->motor_phase[i] += 2 * this->PI * (this->VIBRATION_BASE_FREQUENCY + this->VIBRATION_FREQUENCY_SPAN * u) * dt;
+		if (this->motor_phase[i] > 2 * this->PI)
+			this->motor_phase[i] -= 2 * this->PI;
+
+		double s = std::sin(this->motor_phase[i]) * u * u;
+		double c = std::cos(this->motor_phase[i]) * u * u;
+
+		this->vibration_a.x += this->vibration_accel * s;
+		this->vibration_a.y += this->vibration_accel * c;
+		this->vibration_a.z += this->vibration_accel * 0.5 * s;
+		this->vibration_g.x += this->vibration_gyro * c;
+		this->vibration_g.y += this->vibration_gyro * s;
+		this->vibration_g.z += this->vibration_gyro * 0.3 * c;
+	}
+
+	// body to world rotation, third row is world Z in IMU frame
+	double r00 = 1 - 2 * (q2 * q2 + q3 * q3);
+	double r01 = 2 * (q1 * q2 - q0 * q3);
+	double r02 = 2 * (q1 * q3 + q0 * q2);
+	double r10 = 2 * (q1 * q2 + q0 * q3);
+	double r11 = 1 - 2 * (q1 * q1 + q3 * q3);
+	double r12 = 2 * (q2 * q3 - q0 * q1);
+	double r20 = 2 * (q1 * q3 - q0 * q2);
+	double r21 = 2 * (q0 * q1 + q2 * q3);
+	double r22 = 1 - 2 * (q1 * q1 + q2 * q2);
+
+	Vector accel;
+	accel.x = r02 * thrust / this->MASS - this->LINEAR_DRAG * this->velocity.x;
+	accel.y = r12 * thrust / this->MASS - this->LINEAR_DRAG * this->velocity.y;
+	accel.z = r22 * thrust / this->MASS - this->LINEAR_DRAG * this->velocity.z - this->GRAVITY;
+
+	this->on_ground = this->position.z <= 0 && accel.z <= 0;
+
+	if (this->on_ground) {
+		// resting on legs, ground takes all forces and torques
+		this->position.z = 0;
+		this->velocity = { 0, 0, 0 };
+		this->rates = { 0, 0, 0 };
+		accel = { 0, 0, 0 };
+	}
+	else {
+		// Euler's rotation equation
+		Vector w = this->rates;
+
+		this->rates.x += (torque.x - (this->INERTIA_ZZ - this->INERTIA_YY) * w.y * w.z - this->RATE_DAMPING * w.x) / this->INERTIA_XX * dt;
+		this->rates.y += (torque.y - (this->INERTIA_XX - this->INERTIA_ZZ) * w.z * w.x - this->RATE_DAMPING * w.y) / this->INERTIA_YY * dt;
+		this->rates.z += (torque.z - (this->INERTIA_YY - this->INERTIA_XX) * w.x * w.y - this->RATE_DAMPING * w.z) / this->INERTIA_ZZ * dt;
+
+		this->velocity.x += accel.x * dt;
+		this->velocity.y += accel.y * dt;
+		this->velocity.z += accel.z * dt;
+
+		this->position.x += this->velocity.x * dt;
+		this->position.y += this->velocity.y * dt;
+		this->position.z += this->velocity.z * dt;
+
+		// integrate attitude
+		double hx = 0.5 * this->rates.x * dt;
+		double hy = 0.5 * this->rates.y * dt;
+		double hz = 0.5 * this->rates.z * dt;
+
+		double a = this->q0, b = this->q1, c = this->q2, d = this->q3;
+
+		this->q0 += -b * hx - c * hy - d * hz;
+		this->q1 += a * hx + c * hz - d * hy;
+		this->q2 += a * hy - b * hz + d * hx;
+		this->q3 += a * hz + b * hy - c * hx;
+
+		double norm = 1 / std::sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+		this->q0 *= norm;
+		this->q1 *= norm;
+		this->q2 *= norm;
+		this->q3 *= norm;
+	}
+
+	// accelerometer senses everything but gravity
+	Vector f = { accel.x, accel.y, accel.z + this->GRAVITY };
+
+	this->specific_force.x = r00 * f.x + r10 * f.y + r20 * f.z;
+	this->specific_force.y = r01 * f.x + r11 * f.y + r21 * f.z;
+	this->specific_force.z = r02 * f.x + r12 * f.y + r22 * f.z;
+}
+
+void Quadcopter_Model::Set_Attitude(double roll, double pitch, double yaw) {
+	double cr = std::cos(roll * this->PI / 360), sr = std::sin(roll * this->PI / 360);
+	double cp = std::cos(pitch * this->PI / 360), sp = std::sin(pitch * this->PI / 360);
+	double cy = std::cos(yaw * this->PI / 360), sy = std::sin(yaw * this->PI / 360);
+
+	this->q0 = cr * cp * cy + sr * sp * sy;
+	this->q1 = sr * cp * cy - cr * sp * sy;
+	this->q2 = cr * sp * cy + sr * cp * sy;
+	this->q3 = cr * cp * sy - sr * sp * cy;
+}
+
+void Quadcopter_Model::Set_Disturbance(Vector torque) {
+	this->disturbance = torque;
+}
+
+void Quadcopter_Model::Set_Vibration(double accel_g, double gyro_dps) {
+	this->vibration_accel = accel_g * this->GRAVITY;
+	this->vibration_gyro = gyro_dps * this->PI / 180;
+}
+
+void Quadcopter_Model::Get_Euler(double& roll, double& pitch, double& yaw) {
+	double sin_p = 2 * (q0 * q2 - q3 * q1);
+
+	if (sin_p > 1)
+		sin_p = 1;
+	if (sin_p < -1)
+		sin_p = -1;
+
+	roll = std::atan2(2 * (q0 * q1 + q2 * q3), 1 - 2 * (q1 * q1 + q2 * q2)) * 180 / this->PI;
+	pitch = std::asin(sin_p) * 180 / this->PI;
+	yaw = std::atan2(2 * (q0 * q3 + q1 * q2), 1 - 2 * (q2 * q2 + q3 * q3)) * 180 / this->PI;
+}
+
+// w, x, y, z
+void Quadcopter_Model::Get_Quaternion(double q[4]) {
+	q[0] = this->q0;
+	q[1] = this->q1;
+	q[2] = this->q2;
+	q[3] = this->q3;
+}
+
+Quadcopter_Model::Vector Quadcopter_Model::Get_Rates_Dps() {
+	Vector ret;
+
+	ret.x = (this->rates.x + this->vibration_g.x) * 180 / this->PI;
+	ret.y = (this->rates.y + this->vibration_g.y) * 180 / this->PI;
+	ret.z = (this->rates.z + this->vibration_g.z) * 180 / this->PI;
+
+	return ret;
+}
+
+Quadcopter_Model::Vector Quadcopter_Model::Get_Specific_Force_G() {
+	Vector ret;
+
+	ret.x = (this->specific_force.x + this->vibration_a.x) / this->GRAVITY;
+	ret.y = (this->specific_force.y + this->vibration_a.y) / this->GRAVITY;
+	ret.z = (this->specific_force.z + this->vibration_a.z) / this->GRAVITY;
+
+	return ret;
+}
+
+Quadcopter_Model::Vector Quadcopter_Model::Get_Position() {
+	return this->position;
+}
+
+double Quadcopter_Model::Get_Motor_Output(uint8_t index) {
+	return this->motor_output[index];
+}
+
+// [Hz]
+double Quadcopter_Model::Get_Vibration_Frequency(uint8_t index) {
+	return this->VIBRATION_BASE_FREQUENCY + this->VIBRATION_FREQUENCY_SPAN * this->motor_output[index];
+}
+
+uint16_t Quadcopter_Model::Get_Hover_Pulse() {
+	double u = std::sqrt(this->MASS * this->GRAVITY / (MOTOR_COUNT * this->MAX_THRUST));
+
+	return 1000 + uint16_t(u * 1000);
+}
+
+bool Quadcopter_Model::Is_On_Ground() {
+	return this->on_ground;
+}
+
+} /* namespace flyhero */
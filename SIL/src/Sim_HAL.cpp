@@ -0,0 +1,284 @@
+/*
+ * Sim_HAL.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <stm32f4xx_hal.h>
+#include "Simulator.h"
+
+using namespace flyhero;
+
+GPIO_TypeDef SIM_GPIO[8];
+I2C_TypeDef SIM_I2C[3];
+SPI_TypeDef SIM_SPI[3];
+DMA_Stream_TypeDef SIM_DMA1_Stream[8];
+DMA_Stream_TypeDef SIM_DMA2_Stream[8];
+TIM_TypeDef SIM_TIM2;
+TIM_TypeDef SIM_TIM5;
+CRC_TypeDef SIM_CRC;
+uint32_t SIM_FLASH[SIM_FLASH_SIZE / 4];
+
+static bool flash_locked = true;
+
+// flash comes out of the factory erased
+static struct Flash_Eraser {
+	Flash_Eraser() {
+		for (uint32_t i = 0; i < SIM_FLASH_SIZE / 4; i++)
+			SIM_FLASH[i] = 0xFFFFFFFF;
+	}
+} flash_eraser;
+
+// CRC unit: polynomial 0x04C11DB7, whole words MSB first, no reflection;
+// the unit takes a word in 4 cycles, a byte table keeps benchmarks close
+static struct CRC_Table {
+	uint32_t entries[256];
+
+	CRC_Table() {
+		for (uint16_t i = 0; i < 256; i++) {
+			uint32_t crc = uint32_t(i) << 24;
+
+			for (uint8_t j = 0; j < 8; j++)
+				crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+
+			this->entries[i] = crc;
+		}
+	}
+} crc_table;
+
+static void crc_word(uint32_t word) {
+	uint32_t crc = SIM_CRC.DR;
+
+	for (int8_t shift = 24; shift >= 0; shift -= 8)
+		crc = (crc << 8) ^ crc_table.entries[((crc >> 24) ^ (word >> shift)) & 0xFF];
+
+	SIM_CRC.DR = crc;
+}
+
+// every poll of HAL_GetTick costs some time, otherwise busy loops never end
+static const uint32_t TICK_POLL_US = 10;
+
+extern "C" {
+
+HAL_StatusTypeDef HAL_Init(void) {
+	return HAL_InitTick(0);
+}
+
+void HAL_IncTick(void) {
+}
+
+uint32_t HAL_GetTick(void) {
+	Simulator::Instance().Advance(TICK_POLL_US);
+
+	return uint32_t(Simulator::Instance().Get_Time_us() / 1000);
+}
+
+void HAL_Delay(uint32_t Delay) {
+	Simulator::Instance().Advance((Delay + 1) * 1000);
+}
+
+void HAL_RCC_GetClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t *pFLatency) {
+	RCC_ClkInitStruct->ClockType = 0;
+	RCC_ClkInitStruct->SYSCLKSource = 0;
+	RCC_ClkInitStruct->AHBCLKDivider = 0;
+	RCC_ClkInitStruct->APB1CLKDivider = 0;
+	RCC_ClkInitStruct->APB2CLKDivider = 0;
+	*pFLatency = 5;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) {
+	return 45000000;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority) {
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) {
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn) {
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init) {
+	// only EXTI on port B is wired to anything
+	if ((GPIO_Init->Mode & 0x10000000U) && GPIOx == GPIOB)
+		Simulator::Instance().Enable_EXTI(GPIO_Init->Pin);
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin) {
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+	return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+	if (PinState == GPIO_PIN_SET)
+		GPIOx->ODR |= GPIO_Pin;
+	else
+		GPIOx->ODR &= ~GPIO_Pin;
+
+	GPIOx->IDR = GPIOx->ODR;
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+	GPIOx->ODR ^= GPIO_Pin;
+	GPIOx->IDR = GPIOx->ODR;
+}
+
+void HAL_GPIO_EXTI_IRQHandler(uint16_t GPIO_Pin) {
+	HAL_GPIO_EXTI_Callback(GPIO_Pin);
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma) {
+	return HAL_OK;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma) {
+}
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c) {
+	hi2c->State = 0;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c) {
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+	return Simulator::Instance().I2C_Write(hi2c, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+	return Simulator::Instance().I2C_Read(hi2c, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+	return Simulator::Instance().I2C_Read_DMA(hi2c, DevAddress, MemAddress, pData, Size);
+}
+
+void HAL_I2C_EV_IRQHandler(I2C_HandleTypeDef *hi2c) {
+}
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi) {
+	hspi->Instance->CR1 = hspi->Init.BaudRatePrescaler;
+	hspi->State = HAL_SPI_STATE_READY;
+
+	return HAL_OK;
+}
+
+// like the HAL, a transfer enables the peripheral if it was disabled
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData, uint16_t Size, uint32_t Timeout) {
+	if (hspi->State != HAL_SPI_STATE_READY)
+		return HAL_BUSY;
+
+	hspi->Instance->CR1 |= SPI_CR1_SPE;
+
+	return Simulator::Instance().SPI_Transfer(hspi, pTxData, pRxData, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData, uint16_t Size) {
+	if (hspi->State != HAL_SPI_STATE_READY)
+		return HAL_BUSY;
+
+	hspi->Instance->CR1 |= SPI_CR1_SPE;
+
+	return Simulator::Instance().SPI_Transfer_DMA(hspi, pTxData, pRxData, Size);
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef *hspi) {
+	return hspi->State;
+}
+
+HAL_StatusTypeDef HAL_TIM_OC_Init(TIM_HandleTypeDef *htim) {
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_OC_Start(TIM_HandleTypeDef *htim, uint32_t Channel) {
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_OC_Stop(TIM_HandleTypeDef *htim, uint32_t Channel) {
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim) {
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *sConfig, uint32_t Channel) {
+	__HAL_TIM_SET_COMPARE(htim, Channel, sConfig->Pulse);
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel) {
+	return HAL_OK;
+}
+
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim) {
+}
+
+HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef *hcrc) {
+	hcrc->Instance->DR = 0xFFFFFFFF;
+
+	return HAL_OK;
+}
+
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength) {
+	hcrc->Instance->DR = 0xFFFFFFFF;
+
+	return HAL_CRC_Accumulate(hcrc, pBuffer, BufferLength);
+}
+
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength) {
+	for (uint32_t i = 0; i < BufferLength; i++)
+		crc_word(pBuffer[i]);
+
+	return hcrc->Instance->DR;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) {
+	flash_locked = false;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void) {
+	flash_locked = true;
+
+	return HAL_OK;
+}
+
+// programming only clears bits like NOR flash does
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uintptr_t Address, uint64_t Data) {
+	uintptr_t start = uintptr_t(SIM_FLASH);
+
+	if (flash_locked || TypeProgram != FLASH_TYPEPROGRAM_WORD || (Address & 0x03) != 0
+			|| Address < start || Address + 4 > start + SIM_FLASH_SIZE)
+		return HAL_ERROR;
+
+	SIM_FLASH[(Address - start) / 4] &= uint32_t(Data);
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError) {
+	*SectorError = 0xFFFFFFFF;
+
+	if (flash_locked || pEraseInit->TypeErase != FLASH_TYPEERASE_SECTORS
+			|| pEraseInit->Sector != SIM_FLASH_SECTOR || pEraseInit->NbSectors != 1) {
+		*SectorError = pEraseInit->Sector;
+		return HAL_ERROR;
+	}
+
+	for (uint32_t i = 0; i < SIM_FLASH_SIZE / 4; i++)
+		SIM_FLASH[i] = 0xFFFFFFFF;
+
+	return HAL_OK;
+}
+
+}
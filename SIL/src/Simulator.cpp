@@ -0,0 +1,254 @@
+/*
+ * Simulator.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Simulator.h"
+
+namespace flyhero {
+
+Simulator& Simulator::Instance() {
+	static Simulator instance;
+
+	return instance;
+}
+
+Simulator::Simulator() {
+	this->time_us = 0;
+	this->next_physics_us = PHYSICS_PERIOD_US;
+	this->next_sample_us = this->imu.Get_Sample_Period_us();
+	this->next_pwm_us = PWM_PERIOD_US;
+	this->last_sample_us = 0;
+	this->transfer_sample_us = 0;
+	this->exti_pins = 0;
+	this->in_interrupt = false;
+	this->i2c_dma.busy = false;
+	this->spi_dma.busy = false;
+
+	for (uint8_t i = 0; i < Quadcopter_Model::MOTOR_COUNT; i++)
+		this->pulses[i] = 0;
+}
+
+void Simulator::set_time(uint64_t time_us) {
+	this->time_us = time_us;
+
+	// TIM5 runs at 1 MHz, see HAL_InitTick in Timer.cpp
+	SIM_TIM5.CNT = uint32_t(time_us);
+}
+
+uint32_t Simulator::transfer_time_us(I2C_HandleTypeDef *hi2c, uint16_t size) {
+	// address + register + repeated address + data, 9 clocks each, plus start/stop
+	uint32_t bits = (3 + size) * 9 + 3;
+	uint32_t clock = hi2c->Init.ClockSpeed != 0 ? hi2c->Init.ClockSpeed : 100000;
+
+	return (bits * 1000000 + clock - 1) / clock;
+}
+
+uint32_t Simulator::spi_clock(SPI_HandleTypeDef *hspi) {
+	return SPI_CLOCK >> (1 + ((hspi->Instance->CR1 & SPI_CR1_BR) >> 3));
+}
+
+uint32_t Simulator::transfer_time_us(SPI_HandleTypeDef *hspi, uint16_t size) {
+	uint32_t clock = this->spi_clock(hspi);
+
+	return uint32_t((uint64_t(size) * 8 * 1000000 + clock - 1) / clock);
+}
+
+// First byte is the register with bit 7 set for read, the sensor answers from
+// the second byte on. It only listens while chip select is low and ignores
+// writes clocked faster than it allows.
+void Simulator::spi_exchange(SPI_HandleTypeDef *hspi, const uint8_t *tx, uint8_t *rx, uint16_t size) {
+	memset(rx, 0xFF, size);
+
+	if ((GPIOA->ODR & IMU_CS_PIN) || size < 2)
+		return;
+
+	uint8_t reg = tx[0] & 0x7F;
+
+	if (tx[0] & 0x80)
+		this->imu.Read(reg, rx + 1, size - 1);
+	else if (this->spi_clock(hspi) <= SPI_WRITE_CLOCK)
+		this->imu.Write(reg, tx + 1, size - 1);
+}
+
+void Simulator::complete(DMA_Transfer& transfer) {
+	memcpy(transfer.data, transfer.buffer, transfer.size);
+	transfer.busy = false;
+	this->transfer_sample_us = transfer.sample_us;
+
+	this->in_interrupt = true;
+
+	if (transfer.hspi != NULL) {
+		transfer.hspi->State = HAL_SPI_STATE_READY;
+		HAL_SPI_TxRxCpltCallback(transfer.hspi);
+	}
+	else
+		HAL_I2C_MemRxCpltCallback(transfer.hi2c);
+
+	this->in_interrupt = false;
+}
+
+void Simulator::Advance(uint32_t us) {
+	uint64_t target = this->time_us + us;
+
+	// code running in interrupt context only burns time, nothing can preempt it here
+	if (this->in_interrupt) {
+		this->set_time(target);
+		return;
+	}
+
+	while (true) {
+		uint64_t next = target;
+
+		if (this->next_physics_us < next)
+			next = this->next_physics_us;
+		if (this->next_pwm_us < next)
+			next = this->next_pwm_us;
+		if (this->next_sample_us < next)
+			next = this->next_sample_us;
+		if (this->i2c_dma.busy && this->i2c_dma.done_us < next)
+			next = this->i2c_dma.done_us;
+		if (this->spi_dma.busy && this->spi_dma.done_us < next)
+			next = this->spi_dma.done_us;
+
+		this->set_time(next);
+
+		if (this->time_us >= this->next_physics_us) {
+			this->model.Step(PHYSICS_PERIOD_US * 0.000001, this->pulses);
+			this->next_physics_us += PHYSICS_PERIOD_US;
+		}
+
+		// new compare values are taken at update event
+		if (this->time_us >= this->next_pwm_us) {
+			this->pulses[0] = SIM_TIM2.CCR1;
+			this->pulses[1] = SIM_TIM2.CCR2;
+			this->pulses[2] = SIM_TIM2.CCR3;
+			this->pulses[3] = SIM_TIM2.CCR4;
+			this->next_pwm_us += PWM_PERIOD_US;
+		}
+
+		if (this->i2c_dma.busy && this->time_us >= this->i2c_dma.done_us)
+			this->complete(this->i2c_dma);
+
+		if (this->spi_dma.busy && this->time_us >= this->spi_dma.done_us)
+			this->complete(this->spi_dma);
+
+		if (this->time_us >= this->next_sample_us) {
+			this->imu.Sample(this->model);
+			this->last_sample_us = this->time_us;
+			this->next_sample_us += this->imu.Get_Sample_Period_us();
+
+			if (this->imu.Data_Ready_Interrupt_Enabled() && (this->exti_pins & IMU_INT_PIN)) {
+				this->in_interrupt = true;
+				HAL_GPIO_EXTI_Callback(IMU_INT_PIN);
+				this->in_interrupt = false;
+			}
+		}
+
+		if (this->time_us >= target)
+			break;
+	}
+}
+
+uint64_t Simulator::Get_Time_us() {
+	return this->time_us;
+}
+
+uint64_t Simulator::Get_Next_PWM_Update_us() {
+	return this->next_pwm_us;
+}
+
+uint64_t Simulator::Get_Transfer_Sample_us() {
+	return this->transfer_sample_us;
+}
+
+Quadcopter_Model& Simulator::Get_Model() {
+	return this->model;
+}
+
+MPU6050_Model& Simulator::Get_IMU() {
+	return this->imu;
+}
+
+void Simulator::Enable_EXTI(uint16_t pin) {
+	this->exti_pins |= pin;
+}
+
+HAL_StatusTypeDef Simulator::I2C_Write(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t reg, uint8_t *data, uint16_t size) {
+	if (this->i2c_dma.busy)
+		return HAL_BUSY;
+	if (address != MPU6050_Model::I2C_ADDRESS)
+		return HAL_ERROR;
+
+	this->imu.Write(reg, data, size);
+	this->Advance(this->transfer_time_us(hi2c, size));
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef Simulator::I2C_Read(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t reg, uint8_t *data, uint16_t size) {
+	if (this->i2c_dma.busy)
+		return HAL_BUSY;
+	if (address != MPU6050_Model::I2C_ADDRESS)
+		return HAL_ERROR;
+
+	this->imu.Read(reg, data, size);
+	this->Advance(this->transfer_time_us(hi2c, size));
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef Simulator::I2C_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t reg, uint8_t *data, uint16_t size) {
+	if (this->i2c_dma.busy)
+		return HAL_BUSY;
+	if (address != MPU6050_Model::I2C_ADDRESS || size > MAX_TRANSFER)
+		return HAL_ERROR;
+
+	// sensor latches its output registers when the burst read starts
+	this->imu.Read(reg, this->i2c_dma.buffer, size);
+
+	this->i2c_dma.busy = true;
+	this->i2c_dma.hi2c = hi2c;
+	this->i2c_dma.hspi = NULL;
+	this->i2c_dma.data = data;
+	this->i2c_dma.size = size;
+	this->i2c_dma.sample_us = this->last_sample_us;
+	this->i2c_dma.done_us = this->time_us + this->transfer_time_us(hi2c, size);
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef Simulator::SPI_Transfer(SPI_HandleTypeDef *hspi, uint8_t *tx, uint8_t *rx, uint16_t size) {
+	if (this->spi_dma.busy)
+		return HAL_BUSY;
+
+	this->spi_exchange(hspi, tx, rx, size);
+	this->Advance(this->transfer_time_us(hspi, size));
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef Simulator::SPI_Transfer_DMA(SPI_HandleTypeDef *hspi, uint8_t *tx, uint8_t *rx, uint16_t size) {
+	if (this->spi_dma.busy)
+		return HAL_BUSY;
+	if (size > MAX_TRANSFER)
+		return HAL_ERROR;
+
+	// output registers are latched when the register address is clocked in
+	this->spi_exchange(hspi, tx, this->spi_dma.buffer, size);
+
+	hspi->State = HAL_SPI_STATE_BUSY_TX_RX;
+	this->spi_dma.busy = true;
+	this->spi_dma.hi2c = NULL;
+	this->spi_dma.hspi = hspi;
+	this->spi_dma.data = rx;
+	this->spi_dma.size = size;
+	this->spi_dma.sample_us = this->last_sample_us;
+	this->spi_dma.done_us = this->time_us + this->transfer_time_us(hspi, size);
+
+	return HAL_OK;
+}
+
+} /* namespace flyhero */
@@ -0,0 +1,392 @@
+/*
+ * Telemetry_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "Telemetry.h"
+#include "Telemetry_Decoder.h"
+#include "CRC_Calculator.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+static const uint32_t ALL_FIELDS = (1 << (Telemetry::FIELD_SAMPLE_AGE + 1)) - 1;
+// what the ground station plots in flight
+static const uint32_t FLIGHT_FIELDS = (1 << Telemetry::FIELD_ROLL) | (1 << Telemetry::FIELD_PITCH)
+		| (1 << Telemetry::FIELD_YAW) | (1 << Telemetry::FIELD_THROTTLE) | (1 << Telemetry::FIELD_MOTOR_FL)
+		| (1 << Telemetry::FIELD_MOTOR_FR) | (1 << Telemetry::FIELD_MOTOR_BL) | (1 << Telemetry::FIELD_MOTOR_BR);
+static const uint16_t ALL_FIELDS_SIZE = 166;
+static const uint16_t FLIGHT_FIELDS_SIZE = 18 + 3 * 6 + 5 * 4;
+// 8N1 takes 10 bits per byte
+static const uint32_t UART_BYTES_PER_MS = 2000000 / 10 / 1000;
+static const uint16_t FRAMES = 500;
+// this one gets a bit flipped
+static const uint16_t CORRUPTED_FRAME = 123;
+
+static uint32_t random_state;
+
+static uint32_t next_random() {
+	random_state = random_state * 1664525 + 1013904223;
+
+	return random_state;
+}
+
+static void fill(Telemetry::Snapshot& snapshot, uint32_t index) {
+	snapshot.timestamp = 0x100000000ULL + index * 1000ULL;
+
+	for (uint8_t i = 0; i < 3; i++) {
+		snapshot.accel[i] = int16_t(next_random());
+		snapshot.gyro[i] = int16_t(next_random());
+		snapshot.euler[i] = int32_t(next_random()) * 1e-7f;
+	}
+
+	snapshot.temperature = int16_t(next_random());
+	snapshot.throttle = uint16_t(next_random());
+	snapshot.sample_age = uint16_t(next_random());
+
+	for (uint8_t i = 0; i < 4; i++) {
+		snapshot.motors[i] = uint16_t(next_random());
+		snapshot.timing[i] = next_random();
+	}
+
+	for (uint8_t i = 0; i < Telemetry::TIMING_BINS; i++)
+		snapshot.timing_histogram[i] = uint16_t(next_random());
+
+	for (uint8_t i = 0; i < 6; i++) {
+		snapshot.vibration_accel[i] = uint16_t(next_random());
+		snapshot.vibration_gyro[i] = uint16_t(next_random());
+		snapshot.clips[i] = uint16_t(next_random());
+	}
+}
+
+static uint8_t* put_field(uint8_t *buffer, Telemetry::Field_ID id, Telemetry::Field_Type type, const void *values,
+		uint8_t count) {
+	uint8_t size = Telemetry::Get_Type_Size(type) * count;
+
+	buffer[0] = id;
+	buffer[1] = Telemetry::Get_Type_Byte(type, count);
+	memcpy(buffer + 2, values, size);
+
+	return buffer + 2 + size;
+}
+
+// CRC32 a bit at a time, as in the reference manual
+static uint32_t crc_bitwise(const uint8_t *data, uint32_t size) {
+	uint32_t crc = 0xFFFFFFFF;
+
+	for (uint32_t i = 0; i < size; i += 4) {
+		uint32_t word = 0;
+
+		for (uint8_t j = 0; j < 4 && i + j < size; j++)
+			word |= uint32_t(data[i + j]) << (8 * j);
+
+		crc ^= word;
+
+		for (uint8_t j = 0; j < 32; j++)
+			crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+	}
+
+	return crc;
+}
+
+// if chain the descriptor table replaced, kept to compare output and speed;
+// CRC goes through the CRC unit like in Encode(), so only the encoders differ
+static uint16_t encode_chain(const Telemetry::Snapshot& snapshot, uint32_t fields, uint16_t sequence, uint8_t *buffer) {
+	uint8_t *pos = buffer + Telemetry::HEADER_SIZE;
+
+	if (fields & (1 << Telemetry::FIELD_ACCEL_X))
+		pos = put_field(pos, Telemetry::FIELD_ACCEL_X, Telemetry::TYPE_INT16, &snapshot.accel[0], 1);
+	if (fields & (1 << Telemetry::FIELD_ACCEL_Y))
+		pos = put_field(pos, Telemetry::FIELD_ACCEL_Y, Telemetry::TYPE_INT16, &snapshot.accel[1], 1);
+	if (fields & (1 << Telemetry::FIELD_ACCEL_Z))
+		pos = put_field(pos, Telemetry::FIELD_ACCEL_Z, Telemetry::TYPE_INT16, &snapshot.accel[2], 1);
+	if (fields & (1 << Telemetry::FIELD_GYRO_X))
+		pos = put_field(pos, Telemetry::FIELD_GYRO_X, Telemetry::TYPE_INT16, &snapshot.gyro[0], 1);
+	if (fields & (1 << Telemetry::FIELD_GYRO_Y))
+		pos = put_field(pos, Telemetry::FIELD_GYRO_Y, Telemetry::TYPE_INT16, &snapshot.gyro[1], 1);
+	if (fields & (1 << Telemetry::FIELD_GYRO_Z))
+		pos = put_field(pos, Telemetry::FIELD_GYRO_Z, Telemetry::TYPE_INT16, &snapshot.gyro[2], 1);
+	if (fields & (1 << Telemetry::FIELD_TEMPERATURE))
+		pos = put_field(pos, Telemetry::FIELD_TEMPERATURE, Telemetry::TYPE_INT16, &snapshot.temperature, 1);
+	if (fields & (1 << Telemetry::FIELD_ROLL))
+		pos = put_field(pos, Telemetry::FIELD_ROLL, Telemetry::TYPE_FLOAT, &snapshot.euler[0], 1);
+	if (fields & (1 << Telemetry::FIELD_PITCH))
+		pos = put_field(pos, Telemetry::FIELD_PITCH, Telemetry::TYPE_FLOAT, &snapshot.euler[1], 1);
+	if (fields & (1 << Telemetry::FIELD_YAW))
+		pos = put_field(pos, Telemetry::FIELD_YAW, Telemetry::TYPE_FLOAT, &snapshot.euler[2], 1);
+	if (fields & (1 << Telemetry::FIELD_THROTTLE))
+		pos = put_field(pos, Telemetry::FIELD_THROTTLE, Telemetry::TYPE_UINT16, &snapshot.throttle, 1);
+	if (fields & (1 << Telemetry::FIELD_MOTOR_FL))
+		pos = put_field(pos, Telemetry::FIELD_MOTOR_FL, Telemetry::TYPE_UINT16, &snapshot.motors[0], 1);
+	if (fields & (1 << Telemetry::FIELD_MOTOR_FR))
+		pos = put_field(pos, Telemetry::FIELD_MOTOR_FR, Telemetry::TYPE_UINT16, &snapshot.motors[1], 1);
+	if (fields & (1 << Telemetry::FIELD_MOTOR_BL))
+		pos = put_field(pos, Telemetry::FIELD_MOTOR_BL, Telemetry::TYPE_UINT16, &snapshot.motors[2], 1);
+	if (fields & (1 << Telemetry::FIELD_MOTOR_BR))
+		pos = put_field(pos, Telemetry::FIELD_MOTOR_BR, Telemetry::TYPE_UINT16, &snapshot.motors[3], 1);
+	if (fields & (1 << Telemetry::FIELD_TIMING)) {
+		pos = put_field(pos, Telemetry::FIELD_TIMING, Telemetry::TYPE_UINT32, snapshot.timing, 4);
+		pos = put_field(pos, Telemetry::FIELD_TIMING_HISTOGRAM, Telemetry::TYPE_UINT16, snapshot.timing_histogram,
+				Telemetry::TIMING_BINS);
+	}
+	if (fields & (1 << Telemetry::FIELD_VIBRATION_ACCEL))
+		pos = put_field(pos, Telemetry::FIELD_VIBRATION_ACCEL, Telemetry::TYPE_UINT16, snapshot.vibration_accel, 6);
+	if (fields & (1 << Telemetry::FIELD_VIBRATION_GYRO))
+		pos = put_field(pos, Telemetry::FIELD_VIBRATION_GYRO, Telemetry::TYPE_UINT16, snapshot.vibration_gyro, 6);
+	if (fields & (1 << Telemetry::FIELD_CLIPPING))
+		pos = put_field(pos, Telemetry::FIELD_CLIPPING, Telemetry::TYPE_UINT16, snapshot.clips, 6);
+	if (fields & (1 << Telemetry::FIELD_SAMPLE_AGE))
+		pos = put_field(pos, Telemetry::FIELD_SAMPLE_AGE, Telemetry::TYPE_UINT16, &snapshot.sample_age, 1);
+
+	buffer[0] = Telemetry::SYNC_1;
+	buffer[1] = Telemetry::SYNC_2;
+	buffer[2] = Telemetry::VERSION;
+	buffer[3] = uint8_t(pos - buffer - Telemetry::HEADER_SIZE);
+	memcpy(buffer + 4, &sequence, 2);
+	memcpy(buffer + 6, &snapshot.timestamp, 8);
+
+	uint32_t crc = CRC_Calculator::Instance().Calculate(buffer, uint32_t(pos - buffer));
+	memcpy(pos, &crc, 4);
+
+	return uint16_t(pos + Telemetry::TRAILER_SIZE - buffer);
+}
+
+// value a field has to decode to, the way Encode() lays it out
+static bool expected(const Telemetry::Snapshot& snapshot, uint8_t id, uint8_t index, double& value) {
+	switch (id) {
+	case Telemetry::FIELD_ACCEL_X:
+	case Telemetry::FIELD_ACCEL_Y:
+	case Telemetry::FIELD_ACCEL_Z:
+		value = snapshot.accel[Telemetry::FIELD_ACCEL_X - id];
+		return index == 0;
+	case Telemetry::FIELD_GYRO_X:
+	case Telemetry::FIELD_GYRO_Y:
+	case Telemetry::FIELD_GYRO_Z:
+		value = snapshot.gyro[Telemetry::FIELD_GYRO_X - id];
+		return index == 0;
+	case Telemetry::FIELD_TEMPERATURE:
+		value = snapshot.temperature;
+		return index == 0;
+	case Telemetry::FIELD_ROLL:
+	case Telemetry::FIELD_PITCH:
+	case Telemetry::FIELD_YAW:
+		value = snapshot.euler[Telemetry::FIELD_ROLL - id];
+		return index == 0;
+	case Telemetry::FIELD_THROTTLE:
+		value = snapshot.throttle;
+		return index == 0;
+	case Telemetry::FIELD_MOTOR_FL:
+	case Telemetry::FIELD_MOTOR_FR:
+	case Telemetry::FIELD_MOTOR_BL:
+	case Telemetry::FIELD_MOTOR_BR:
+		value = snapshot.motors[Telemetry::FIELD_MOTOR_FL - id];
+		return index == 0;
+	case Telemetry::FIELD_TIMING:
+		value = snapshot.timing[index];
+		return index < 4;
+	case Telemetry::FIELD_TIMING_HISTOGRAM:
+		value = snapshot.timing_histogram[index];
+		return index < Telemetry::TIMING_BINS;
+	case Telemetry::FIELD_VIBRATION_ACCEL:
+		value = snapshot.vibration_accel[index];
+		return index < 6;
+	case Telemetry::FIELD_VIBRATION_GYRO:
+		value = snapshot.vibration_gyro[index];
+		return index < 6;
+	case Telemetry::FIELD_CLIPPING:
+		value = snapshot.clips[index];
+		return index < 6;
+	case Telemetry::FIELD_SAMPLE_AGE:
+		value = snapshot.sample_age;
+		return index == 0;
+	default:
+		return false;
+	}
+}
+
+static bool verify(const Telemetry::Snapshot& snapshot, uint32_t fields, uint16_t sequence,
+		const Telemetry_Decoder::Frame& frame) {
+	uint32_t seen = 0;
+
+	if (frame.version != Telemetry::VERSION || frame.sequence != sequence || frame.timestamp != snapshot.timestamp)
+		return false;
+
+	for (uint8_t i = 0; i < frame.field_count; i++) {
+		const Telemetry_Decoder::Field& field = frame.fields[i];
+
+		for (uint8_t j = 0; j < field.count; j++) {
+			double value;
+
+			if (!expected(snapshot, field.id, j, value) || field.values[j] != value)
+				return false;
+		}
+
+		if (field.id < 32)
+			seen |= 1 << field.id;
+		else if (field.id == Telemetry::FIELD_TIMING_HISTOGRAM && !(fields & (1 << Telemetry::FIELD_TIMING)))
+			return false;
+	}
+
+	return seen == fields;
+}
+
+template <uint32_t FIELDS>
+static void encode(uint32_t iterations) {
+	static uint8_t buffer[Telemetry::MAX_FRAME_SIZE];
+	Telemetry::Snapshot snapshot = Telemetry::Snapshot();
+	Telemetry::Layout layout;
+	uint32_t sum = 0;
+
+	random_state = 1;
+	fill(snapshot, 0);
+	Telemetry::Build_Layout(FIELDS, layout);
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		snapshot.accel[0] = int16_t(i);
+		sum += Telemetry::Encode(snapshot, layout, uint16_t(i), buffer);
+		sum += buffer[Telemetry::HEADER_SIZE + 2];
+	}
+
+	Benchmark::Sink = sum;
+}
+
+template <uint32_t FIELDS>
+static void encode_reference(uint32_t iterations) {
+	static uint8_t buffer[Telemetry::MAX_FRAME_SIZE];
+	Telemetry::Snapshot snapshot = Telemetry::Snapshot();
+	uint32_t sum = 0;
+
+	random_state = 1;
+	fill(snapshot, 0);
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		snapshot.accel[0] = int16_t(i);
+		sum += encode_chain(snapshot, FIELDS, uint16_t(i), buffer);
+		sum += buffer[Telemetry::HEADER_SIZE + 2];
+	}
+
+	Benchmark::Sink = sum;
+}
+
+// ground side CRC of a full frame
+static void crc_table(uint32_t iterations) {
+	uint8_t data[ALL_FIELDS_SIZE];
+	uint32_t sum = 0;
+
+	for (uint16_t i = 0; i < ALL_FIELDS_SIZE; i++)
+		data[i] = uint8_t(i * 7);
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		data[0] = uint8_t(i);
+		sum += Telemetry_Decoder::Calculate_CRC(data, ALL_FIELDS_SIZE);
+	}
+
+	Benchmark::Sink = sum;
+}
+
+// CRC unit, decoder table and the bit by bit definition agree on every
+// length and offset, a word of the unit is not an aligned word of memory
+static bool crc_check() {
+	static uint8_t data[300];
+	CRC_Calculator& crc = CRC_Calculator::Instance();
+
+	random_state = 7;
+	crc.Init();
+
+	for (uint16_t i = 0; i < sizeof(data); i++)
+		data[i] = uint8_t(next_random() >> 24);
+
+	for (uint16_t size = 0; size < 290; size++) {
+		const uint8_t *start = data + size % 4;
+		uint32_t expected = crc_bitwise(start, size);
+
+		if (crc.Calculate(start, size) != expected || Telemetry_Decoder::Calculate_CRC(start, size) != expected)
+			return false;
+	}
+
+	return true;
+}
+
+// Frames with random field sets go through the decoder in one stream with
+// garbage between them, including a false sync with a long length and one
+// corrupted frame. Every other frame has to come out exactly as encoded,
+// byte for byte the same as the if chain made it, and the corrupted one
+// shows as a lost sequence number.
+static bool check() {
+	static Telemetry_Decoder decoder;
+	static uint8_t buffer[Telemetry::MAX_FRAME_SIZE];
+	static uint8_t reference[Telemetry::MAX_FRAME_SIZE];
+	Telemetry::Layout layout;
+	static Telemetry::Snapshot snapshots[FRAMES];
+	static uint32_t masks[FRAMES];
+	const uint8_t garbage[] = { 0x00, Telemetry::SYNC_1, Telemetry::SYNC_2, Telemetry::VERSION, 200, 0x46, 0xFF };
+	uint16_t decoded = 0;
+	bool ok = true;
+
+	random_state = 42;
+	CRC_Calculator::Instance().Init();
+
+	Telemetry::Snapshot full = Telemetry::Snapshot();
+	Telemetry::Build_Layout(ALL_FIELDS, layout);
+	uint16_t full_size = Telemetry::Encode(full, layout, 0, buffer);
+	Telemetry::Build_Layout(FLIGHT_FIELDS, layout);
+	uint16_t flight_size = Telemetry::Encode(full, layout, 0, buffer);
+
+	if (full_size != ALL_FIELDS_SIZE || flight_size != FLIGHT_FIELDS_SIZE)
+		ok = false;
+
+	for (uint16_t i = 0; i < FRAMES; i++) {
+		fill(snapshots[i], i);
+		masks[i] = i == 0 ? 0 : (i == 1 ? ALL_FIELDS : next_random() & ALL_FIELDS);
+
+		Telemetry::Build_Layout(masks[i], layout);
+		uint16_t size = Telemetry::Encode(snapshots[i], layout, i, buffer);
+
+		if (encode_chain(snapshots[i], masks[i], i, reference) != size || memcmp(buffer, reference, size) != 0)
+			ok = false;
+
+		if (i == CORRUPTED_FRAME)
+			buffer[size / 2] ^= 0x10;
+
+		for (uint16_t j = 0; j < size; j++) {
+			if (!decoder.Push(buffer[j]))
+				continue;
+
+			const Telemetry_Decoder::Frame& frame = decoder.Get_Frame();
+
+			if (frame.sequence >= FRAMES || !verify(snapshots[frame.sequence], masks[frame.sequence], frame.sequence, frame))
+				ok = false;
+
+			decoded++;
+		}
+
+		if (i % 50 == 7) {
+			for (uint8_t j = 0; j < sizeof(garbage); j++) {
+				if (decoder.Push(garbage[j]))
+					decoded++;
+			}
+		}
+	}
+
+	printf("telemetry full frame %u B, %u %% of 2 Mbaud at 1 kHz, %u of %u frames decoded, %u lost, %u bad, "
+			"%u bytes skipped\n", full_size, full_size * 100 / UART_BYTES_PER_MS, decoded, FRAMES, decoder.Get_Lost(),
+			decoder.Get_Errors(), decoder.Get_Skipped());
+
+	return ok && full_size <= UART_BYTES_PER_MS && decoded == FRAMES - 1 && decoder.Get_Frames() == decoded
+			&& decoder.Get_Lost() == 1;
+}
+
+static Benchmark full_benchmark("telemetry_encode_full", &encode<ALL_FIELDS>, 1000000, &check, ALL_FIELDS_SIZE);
+static Benchmark full_reference_benchmark("telemetry_encode_full_if_chain", &encode_reference<ALL_FIELDS>, 1000000,
+		NULL, ALL_FIELDS_SIZE);
+static Benchmark flight_benchmark("telemetry_encode_flight", &encode<FLIGHT_FIELDS>, 1000000, NULL,
+		FLIGHT_FIELDS_SIZE);
+static Benchmark flight_reference_benchmark("telemetry_encode_flight_if_chain", &encode_reference<FLIGHT_FIELDS>,
+		1000000, NULL, FLIGHT_FIELDS_SIZE);
+static Benchmark crc_benchmark("telemetry_crc_table", &crc_table, 1000000, &crc_check, ALL_FIELDS_SIZE);
+
+} /* namespace flyhero */
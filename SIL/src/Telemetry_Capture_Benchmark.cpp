@@ -0,0 +1,68 @@
+/*
+ * Telemetry_Capture_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Telemetry_Capture.h"
+#include "Simulator.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+// what the control cycle pays for telemetry
+static void push(uint32_t iterations) {
+	Telemetry_Capture& capture = Telemetry_Capture::Instance();
+
+	for (uint32_t i = 0; i < iterations; i++)
+		capture.Push();
+
+	Benchmark::Sink = iterations;
+}
+
+// Readers see snapshots in order, one that falls behind gets the newest
+// RING_SIZE - 1 and the rest counted as lost; statistics are only in
+// snapshots read with them.
+static bool check() {
+	Telemetry_Capture& capture = Telemetry_Capture::Instance();
+	Telemetry_Capture::Ring::Reader fast, slow;
+	Telemetry::Snapshot snapshot;
+	uint64_t last = 0;
+	const uint32_t PUSHES = Telemetry_Capture::RING_SIZE + 4;
+
+	capture.Attach(fast);
+	capture.Attach(slow);
+
+	if (capture.Read(fast, snapshot, 0))
+		return false;
+
+	for (uint32_t i = 0; i < PUSHES; i++) {
+		Simulator::Instance().Advance(1000);
+		capture.Push();
+
+		if (!capture.Read(fast, snapshot, Telemetry_Capture::FIELDS_STATISTICS) || snapshot.timestamp <= last)
+			return false;
+
+		last = snapshot.timestamp;
+
+		if (capture.Read(fast, snapshot, 0))
+			return false;
+	}
+
+	uint32_t read = 0;
+
+	while (capture.Read(slow, snapshot, 0)) {
+		if (snapshot.timing[3] != 0 || snapshot.vibration_gyro[0] != 0)
+			return false;
+
+		read++;
+	}
+
+	return fast.lost == 0 && read == Telemetry_Capture::RING_SIZE - 1
+			&& slow.lost == PUSHES - read && snapshot.timestamp == last;
+}
+
+static Benchmark push_benchmark("telemetry_capture_push", &push, 100000, &check, sizeof(Telemetry::Snapshot));
+
+} /* namespace flyhero */
@@ -0,0 +1,55 @@
+/*
+ * Telemetry_Dump.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <stdio.h>
+#include "Telemetry_Dump.h"
+#include "Telemetry_Decoder.h"
+
+namespace flyhero {
+
+int Telemetry_Dump::Decode(const char *file) {
+	FILE *input = fopen(file, "rb");
+
+	if (input == NULL) {
+		printf("cannot open %s\n", file);
+		return 1;
+	}
+
+	static Telemetry_Decoder decoder;
+	int byte;
+
+	printf("t_us;sequence;fields\n");
+
+	while ((byte = fgetc(input)) != EOF) {
+		if (!decoder.Push(uint8_t(byte)))
+			continue;
+
+		const Telemetry_Decoder::Frame& frame = decoder.Get_Frame();
+
+		printf("%llu;%u", (unsigned long long)frame.timestamp, frame.sequence);
+
+		for (uint8_t i = 0; i < frame.field_count; i++) {
+			const Telemetry_Decoder::Field& field = frame.fields[i];
+
+			printf(";%s=", Telemetry_Decoder::Get_Field_Name(field.id));
+
+			for (uint8_t j = 0; j < field.count; j++)
+				printf(j == 0 ? "%g" : ",%g", field.values[j]);
+		}
+
+		printf("\n");
+	}
+
+	fclose(input);
+
+	printf("%u frames, %u lost, %u bad frames, %u bytes skipped\n", decoder.Get_Frames(), decoder.Get_Lost(),
+			decoder.Get_Errors(), decoder.Get_Skipped());
+
+	return 0;
+}
+
+} /* namespace flyhero */
@@ -0,0 +1,118 @@
+/*
+ * Vibration_Benchmark.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <stdio.h>
+#include <cmath>
+#include <algorithm>
+#include "Vibration_Monitor.h"
+#include "Benchmark.h"
+
+namespace flyhero {
+
+static const double PI = 3.14159265358979;
+static const uint32_t SAMPLE_PERIOD = 125;		// [us], 8 kHz
+static const uint32_t WINDOW = 100000;		// [us]
+static const double AMPLITUDES[] = { 1000, 8000, 20000, 30000, 40000, 60000 };
+static const double FREQUENCY = 200;		// [Hz], whole periods in a window
+// every axis gets an offset on top, RMS must not see it
+static const int16_t OFFSET = 2000;
+
+static void add(uint32_t iterations) {
+	static Vibration_Monitor monitor;
+	Vibration_Monitor::Window window = Vibration_Monitor::Window();
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		int16_t data[6];
+
+		for (uint8_t j = 0; j < 6; j++)
+			data[j] = int16_t((i * 37 + j * 1000) & 0x7FFF) - 16384;
+
+		monitor.Add(data, i * SAMPLE_PERIOD);
+	}
+
+	monitor.Get_Window(window);
+	Benchmark::Sink = window.rms[0];
+}
+
+static int16_t saturate(double value) {
+	if (value > 32767)
+		return 32767;
+	if (value < -32768)
+		return -32768;
+
+	return int16_t(std::floor(value + 0.5));
+}
+
+// Sine of known amplitude on every axis, saturated like the ADC does, for one
+// window. RMS and peak around the mean have to match the saturated signal and
+// every sample at the rails has to be counted.
+static bool check() {
+	Vibration_Monitor monitor;
+	Vibration_Monitor::Window window;
+	double sum[6] = { 0 }, sum_squares[6] = { 0 };
+	int16_t min[6], max[6];
+	uint16_t clips[6] = { 0 };
+	uint32_t samples = WINDOW / SAMPLE_PERIOD;
+	bool ok = true;
+
+	monitor.Set_Window(WINDOW);
+
+	for (uint8_t j = 0; j < 6; j++) {
+		min[j] = INT16_MAX;
+		max[j] = INT16_MIN;
+	}
+
+	if (monitor.Get_Window(window))
+		return false;
+
+	for (uint32_t i = 0; i <= samples; i++) {
+		uint32_t t = i * SAMPLE_PERIOD;
+		int16_t data[6];
+
+		for (uint8_t j = 0; j < 6; j++) {
+			data[j] = saturate(OFFSET + AMPLITUDES[j] * std::sin(2 * PI * FREQUENCY * t * 1e-6 + j));
+
+			sum[j] += data[j];
+			sum_squares[j] += double(data[j]) * data[j];
+
+			uint16_t magnitude = uint16_t(data[j] < 0 ? -data[j] : data[j]);
+			min[j] = data[j] < min[j] ? data[j] : min[j];
+			max[j] = data[j] > max[j] ? data[j] : max[j];
+			clips[j] += magnitude >= 32767;
+		}
+
+		monitor.Add(data, t);
+	}
+
+	if (!monitor.Get_Window(window) || window.samples != samples + 1)
+		return false;
+
+	for (uint8_t j = 0; j < 6; j++) {
+		double mean = sum[j] / window.samples;
+		double rms = std::sqrt(sum_squares[j] / window.samples - mean * mean);
+		uint16_t peak = uint16_t(std::max(max[j] - mean, mean - min[j]) + 0.5);
+
+		printf("vibration amplitude %.0f LSB: RMS %.1f (%.1f expected, %.1f unclipped), peak %u, %u clips\n",
+				AMPLITUDES[j], window.rms[j], rms, AMPLITUDES[j] / std::sqrt(2.0), window.peak[j], window.clips[j]);
+
+		ok = ok && std::fabs(window.rms[j] - rms) < 0.01 * rms && window.peak[j] == peak
+				&& window.clips[j] == clips[j] && monitor.Get_Total_Clips(j) == clips[j];
+
+		// no clipping, whole periods in the window
+		if (AMPLITUDES[j] + OFFSET < 32767)
+			ok = ok && std::fabs(window.rms[j] - AMPLITUDES[j] / std::sqrt(2.0)) < 0.01 * AMPLITUDES[j]
+					&& std::fabs(window.peak[j] - AMPLITUDES[j]) < 0.01 * AMPLITUDES[j] && clips[j] == 0;
+		else
+			ok = ok && clips[j] > 0;
+	}
+
+	return ok;
+}
+
+static Benchmark add_benchmark("vibration_monitor_add", &add, 1000000, &check);
+
+} /* namespace flyhero */
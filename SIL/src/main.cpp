@@ -0,0 +1,609 @@
+/**
+  ******************************************************************************
+  * @file    main.cpp
+  * @author  Michal Prevratil
+  * @version V1.0
+  * @date    18-October-2026
+  * @brief   Software-in-the-loop run of The_Eye control path.
+  ******************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <chrono>
+#include "PWM_Generator.h"
+#include "IMU.h"
+#include "LEDs.h"
+#include "Motors_Controller.h"
+#include "Timer.h"
+#include "Scheduler.h"
+#include "Timing_Probe.h"
+#include "Simulator.h"
+#include "Benchmark.h"
+#include "Gyro_Replay.h"
+#include "Attitude_Replay.h"
+#include "Telemetry_Dump.h"
+#include "Flash_Storage.h"
+#include "Blackbox.h"
+#include "Blackbox_File.h"
+#include "Telemetry_Capture.h"
+#include "Telemetry_Decoder.h"
+
+using namespace flyhero;
+
+IMU& mpu = IMU::Create_Instance(IMU_MPU6050);
+PWM_Generator& pwm = PWM_Generator::Instance();
+Motors_Controller& motors_controller = Motors_Controller::Instance();
+Scheduler& scheduler = Scheduler::Instance();
+Simulator& sim = Simulator::Instance();
+Flash_Storage& storage = Flash_Storage::Instance();
+Blackbox& blackbox = Blackbox::Instance();
+// 2 MB is enough for the scenario
+Blackbox_File blackbox_flash(NULL, 2 * 1024 * 1024);
+Telemetry_Capture& capture = Telemetry_Capture::Instance();
+Telemetry_Capture::Ring::Reader blackbox_reader;
+
+Timing_Probe control_probe("control", 1);
+Timing_Probe complete_read_probe("imu_read", 1);
+Timing_Probe ahrs_probe("ahrs", 1);
+Timing_Probe motors_probe("motors", 1);
+
+void IMU_Data_Ready_Callback();
+void IMU_Data_Read_Callback();
+void Control_Task();
+void IMU_Task();
+void Notch_Task();
+void Calibration_Task();
+void Blackbox_Task();
+void Watchdog_Callback(int signal);
+bool Check_Blackbox();
+
+struct Statistics {
+	double min, max, sum;
+	uint32_t count;
+
+	void Add(double value) {
+		if (this->count == 0 || value < this->min)
+			this->min = value;
+		if (this->count == 0 || value > this->max)
+			this->max = value;
+
+		this->sum += value;
+		this->count++;
+	}
+
+	double Average() {
+		return this->count != 0 ? this->sum / this->count : 0;
+	}
+};
+
+Statistics latency = Statistics();
+// sample timestamps against the time the simulator took the sample
+Statistics timestamp_error = Statistics();
+
+// scenario timeline in ms, IMU calibrates once the frame settles after arming
+const uint32_t TAKE_OFF_MS = 2500;
+const uint32_t KICK_MS = 4000;
+const uint32_t KICK_LENGTH_MS = 100;
+const uint32_t END_MS = 8000;
+const double KICK_TORQUE = 0.2;		// [N m] about roll axis
+const double SETTLED_DEG = 1;
+// motor vibration picked up by the IMU, frequency follows motor speed
+const double VIBRATION_ACCEL_G = 0.3;
+const double VIBRATION_GYRO_DPS = 50;
+
+// main loop is polled this often in virtual time
+const uint32_t IDLE_STEP_US = 50;
+
+// 14 B burst at 400 kHz I2C takes ~390 us
+const uint16_t SAMPLE_RATE = 2000;
+const uint16_t RATE_LOOP_RATE = 1000;
+// sensor buffers samples, each rate loop reads all of them in one burst
+const bool IMU_FIFO = true;
+// accel corrects attitude at angle loop rate, rate loops between only integrate gyro
+const uint16_t ANGLE_LOOP_RATE = 1000;
+// attitude rotated ahead by sample age, new compare values wait for the next
+// PWM update, half a period on average
+const bool LATENCY_COMPENSATION = true;
+const uint32_t PWM_OUTPUT_DELAY_US = Simulator::PWM_PERIOD_US / 2;
+
+// notch removes motor vibration so the gyro LPF does not have to
+const float GYRO_LPF_FREQUENCY = 100;
+
+const uint32_t STORAGE_RESERVE = 16 * 1024;
+const uint16_t CALIBRATION_KEY = 0x0001;
+const uint16_t GYRO_BIAS_KEY = 0x0002;
+const uint32_t GYRO_BIAS_STORE_INTERVAL = 60000;	// [ms]
+
+// what The_Eye records, every control loop
+const uint32_t BLACKBOX_DATA = (Telemetry::FIELDS_RAW & ~(1 << Telemetry::FIELD_TEMPERATURE)) | Telemetry::FIELDS_EULER
+		| Telemetry::FIELDS_MOTORS | (1 << Telemetry::FIELD_SAMPLE_AGE);
+
+enum Task_ID { CONTROL_TASK, IMU_TASK, NOTCH_TASK, CALIBRATION_TASK, BLACKBOX_TASK };
+
+const Scheduler::Task TASKS[] = {
+	// name			function			period	budget	triggered	enabled
+	{ "control",	&Control_Task,		1000000 / RATE_LOOP_RATE,	150,	true,		true },
+	{ "imu",		&IMU_Task,			1000000 / RATE_LOOP_RATE,	20,		false,		IMU_FIFO },
+	{ "notch",		&Notch_Task,		1000,	25,		false,		true },
+	{ "calibration",	&Calibration_Task,	10000,	20,		false,		true },
+	{ "blackbox",	&Blackbox_Task,		1000,	20,		false,		true },
+};
+
+static_assert(sizeof(TASKS) / sizeof(TASKS[0]) <= Scheduler::MAX_TASKS, "scheduler cannot take all tasks");
+
+uint64_t calibrated_us = 0;
+bool calibrating = false;
+
+int main(int argc, char *argv[])
+{
+	FILE *trace = NULL;
+
+	// host benchmarks instead of the flight scenario, they need the virtual timer
+	if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+		HAL_Init();
+		return Benchmark::Run_All(argc > 2 ? argv[2] : NULL);
+	}
+
+	// recorded gyro data through the notch analyzer
+	if (argc > 1 && strcmp(argv[1], "analyze") == 0) {
+		if (argc < 4) {
+			printf("usage: %s analyze <gx;gy;gz file> <sample rate>\n", argv[0]);
+			return 1;
+		}
+
+		return Gyro_Replay::Analyze(argv[2], atoi(argv[3]));
+	}
+
+	// recorded IMU data with truth through all attitude estimators
+	if (argc > 1 && strcmp(argv[1], "attitude") == 0) {
+		if (argc < 4) {
+			printf("usage: %s attitude <gx;gy;gz;ax;ay;az;roll;pitch;yaw file> <sample rate>\n", argv[0]);
+			return 1;
+		}
+
+		return Attitude_Replay::Compare(argv[2], atoi(argv[3]));
+	}
+
+	// captured telemetry bytes decoded into text
+	if (argc > 1 && strcmp(argv[1], "telemetry") == 0) {
+		if (argc < 3) {
+			printf("usage: %s telemetry <file>\n", argv[0]);
+			return 1;
+		}
+
+		return Telemetry_Dump::Decode(argv[2]);
+	}
+
+	if (argc > 1) {
+		trace = fopen(argv[1], "w");
+
+		if (trace == NULL) {
+			printf("cannot open %s\n", argv[1]);
+			return 1;
+		}
+
+		fprintf(trace, "t_ms;roll;pitch;yaw;true_roll;true_pitch;true_yaw;altitude\n");
+	}
+
+	// a stuck scenario must not hang the build
+	signal(SIGALRM, &Watchdog_Callback);
+	alarm(60);
+
+	HAL_Init();
+	Timing_Probe::Init();
+	LEDs::Init();
+
+	if (mpu.Init()) {
+		printf("IMU init failed\n");
+		return 1;
+	}
+
+	// simulated flash starts erased, stored offsets are only found on the check below
+	IMU::Calibration calibration;
+	Gyro_Bias_Model::Table gyro_bias;
+
+	if (storage.Init(SIM_FLASH_SECTOR, uintptr_t(SIM_FLASH), SIM_FLASH_SIZE, STORAGE_RESERVE) == HAL_OK) {
+		if (storage.Read(CALIBRATION_KEY, &calibration, sizeof(calibration)) == HAL_OK)
+			mpu.Set_Calibration(calibration);
+
+		if (storage.Read(GYRO_BIAS_KEY, &gyro_bias, sizeof(gyro_bias)) == HAL_OK)
+			mpu.Get_Gyro_Bias_Model().Set_Table(gyro_bias);
+	}
+
+	pwm.Init();
+	pwm.Arm(NULL);
+
+	if (mpu.Set_Sample_Rate(SAMPLE_RATE) != HAL_OK) {
+		printf("cannot set IMU sample rate\n");
+		return 1;
+	}
+
+	if (mpu.Set_FIFO_Mode(IMU_FIFO) != HAL_OK) {
+		printf("cannot set IMU FIFO mode\n");
+		return 1;
+	}
+
+	// each FIFO burst comes down to one sample
+	if (mpu.Set_Decimation(SAMPLE_RATE / RATE_LOOP_RATE) != HAL_OK) {
+		printf("cannot set IMU decimation\n");
+		return 1;
+	}
+
+	mpu.Set_Read_Rate(RATE_LOOP_RATE);
+	mpu.Set_Latency_Compensation(LATENCY_COMPENSATION, PWM_OUTPUT_DELAY_US);
+	mpu.Set_Gyro_LPF(GYRO_LPF_FREQUENCY);
+	mpu.Set_Dynamic_Notch(true);
+	motors_controller.Set_Loop_Rates(RATE_LOOP_RATE, ANGLE_LOOP_RATE);
+
+	motors_controller.Set_PID_Constants(Roll, 8, 0.5f, 0);
+	motors_controller.Set_PID_Constants(Pitch, 8, 0.5f, 0);
+	motors_controller.Set_PID_Constants(Yaw, 3, 0, 0);
+	motors_controller.Set_Rate_PID_Constants(Roll, 1, 1, 0.02f);
+	motors_controller.Set_Rate_PID_Constants(Pitch, 1, 1, 0.02f);
+	motors_controller.Set_Rate_PID_Constants(Yaw, 1, 0.5f, 0);
+
+	if (scheduler.Init(TASKS, sizeof(TASKS) / sizeof(TASKS[0])) != HAL_OK) {
+		printf("scheduler init failed\n");
+		return 1;
+	}
+
+	blackbox.Set_Data_Type(BLACKBOX_DATA);
+
+	if (blackbox.Init(&blackbox_flash) != HAL_OK || blackbox.Start() != HAL_OK) {
+		printf("blackbox init failed\n");
+		return 1;
+	}
+
+	capture.Attach(blackbox_reader);
+
+	if (mpu.Get_Calibration_State() != IMU::CALIBRATION_DONE) {
+		mpu.Start_Calibration();
+		calibrating = true;
+	}
+
+	mpu.Data_Ready_Callback = &IMU_Data_Ready_Callback;
+	mpu.Data_Read_Callback = &IMU_Data_Read_Callback;
+
+	Quadcopter_Model& model = sim.Get_Model();
+	uint16_t hover = model.Get_Hover_Pulse();
+
+	model.Set_Vibration(VIBRATION_ACCEL_G, VIBRATION_GYRO_DPS);
+
+	auto wall_start = std::chrono::steady_clock::now();
+	uint64_t sim_start = sim.Get_Time_us();
+
+	double peak = 0;
+	double settle_ms = -1;
+	double estimator_error = 0;
+
+	for (uint32_t t = 0; t < END_MS; t++) {
+		if (t == TAKE_OFF_MS)
+			motors_controller.Set_Throttle(hover + 30);
+		if (t == TAKE_OFF_MS + 500)
+			motors_controller.Set_Throttle(hover);
+		if (t == KICK_MS)
+			model.Set_Disturbance({ KICK_TORQUE, 0, 0 });
+		if (t == KICK_MS + KICK_LENGTH_MS)
+			model.Set_Disturbance({ 0, 0, 0 });
+
+		for (uint32_t us = 0; us < 1000; us += IDLE_STEP_US) {
+			sim.Advance(IDLE_STEP_US);
+
+			while (scheduler.Run());
+		}
+
+		double roll, pitch, yaw;
+		model.Get_Euler(roll, pitch, yaw);
+
+		float est_roll, est_pitch, est_yaw;
+		mpu.Get_Euler(est_roll, est_pitch, est_yaw);
+
+		// controller only sees the estimate, so settling is judged on it
+		// and the truth is used to report how far the estimate drifted
+		if (t > KICK_MS) {
+			if (std::fabs(roll) > peak)
+				peak = std::fabs(roll);
+
+			if (std::fabs(roll - est_roll) > estimator_error)
+				estimator_error = std::fabs(roll - est_roll);
+
+			if (t < KICK_MS + KICK_LENGTH_MS || std::fabs(est_roll) > SETTLED_DEG)
+				settle_ms = -1;
+			else if (settle_ms < 0)
+				settle_ms = t - KICK_MS;
+		}
+
+		if (trace != NULL)
+			fprintf(trace, "%u;%.3f;%.3f;%.3f;%.3f;%.3f;%.3f;%.3f\n", t, est_roll, est_pitch, est_yaw,
+					roll, pitch, yaw, model.Get_Position().z);
+	}
+
+	double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+	double sim_s = (sim.Get_Time_us() - sim_start) * 0.000001;
+
+	if (trace != NULL)
+		fclose(trace);
+
+	printf("simulated %.1f s in %.3f s (%.0fx real time)\n", sim_s, wall_s, sim_s / wall_s);
+	for (uint8_t i = 0; i < Timing_Probe::Get_Probe_Count(); i++) {
+		Timing_Probe *probe = Timing_Probe::Get_Probe(i);
+		const Timing_Probe::Statistics& statistics = probe->Get_Statistics();
+
+		printf("probe %s [us]: min %.2f avg %.2f max %.2f, histogram per %u us:", probe->Get_Name(),
+				probe->Get_Min_us(), probe->Get_Average_us(), probe->Get_Max_us(), probe->Get_Bin_Width_us());
+
+		for (uint8_t j = 0; j < Timing_Probe::HISTOGRAM_BINS; j++)
+			printf(" %u", statistics.histogram[j]);
+
+		printf("\n");
+	}
+	printf("sample to motor latency [us]: min %.0f avg %.0f max %.0f\n",
+			latency.min, latency.Average(), latency.max);
+	printf("sample age at PWM write [us]: %u, timestamp error min %.0f avg %.0f max %.0f\n",
+			motors_controller.Get_Sample_Age(), timestamp_error.min, timestamp_error.Average(), timestamp_error.max);
+	printf("roll disturbance %.2f N m for %u ms: peak %.2f deg, settled within %.0f deg after %.0f ms\n",
+			KICK_TORQUE, KICK_LENGTH_MS, peak, SETTLED_DEG, settle_ms);
+	printf("max roll estimate error after disturbance: %.2f deg\n", estimator_error);
+
+	if (mpu.Get_FIFO_Mode())
+		printf("IMU FIFO overflows: %u\n", mpu.Get_FIFO_Overflows());
+
+	printf("motor vibration %.0f Hz, notch [Hz]:", model.Get_Vibration_Frequency(0));
+
+	for (uint8_t i = 0; i < Dynamic_Notch::AXES; i++) {
+		Dynamic_Notch& notch = mpu.Get_Dynamic_Notch();
+
+		printf(" %.0f/%.0f", notch.Get_Frequency(i, 0), notch.Get_Frequency(i, 1));
+	}
+
+	printf("\n");
+
+	Vibration_Monitor::Window vibration;
+
+	if (mpu.Get_Vibration_Monitor().Get_Window(vibration)) {
+		printf("IMU vibration over %u samples, RMS/peak/clips accel [LSB]:", vibration.samples);
+
+		for (uint8_t i = 0; i < Vibration_Monitor::AXES; i++) {
+			if (i == 3)
+				printf(", gyro [LSB]:");
+
+			printf(" %.0f/%u/%u", vibration.rms[i], vibration.peak[i], vibration.clips[i]);
+		}
+
+		printf("\n");
+	}
+
+	// next boot has to pick up what this one stored
+	IMU::Calibration stored;
+	bool stored_ok = mpu.Get_Calibration(calibration)
+			&& storage.Init(SIM_FLASH_SECTOR, uintptr_t(SIM_FLASH), SIM_FLASH_SIZE, STORAGE_RESERVE) == HAL_OK
+			&& storage.Read(CALIBRATION_KEY, &stored, sizeof(stored)) == HAL_OK
+			&& stored.accel_fsr == calibration.accel_fsr && stored.gyro_fsr == calibration.gyro_fsr;
+
+	for (uint8_t i = 0; i < 3; i++) {
+		if (stored.accel_offsets[i] != calibration.accel_offsets[i] || stored.gyro_offsets[i] != calibration.gyro_offsets[i])
+			stored_ok = false;
+	}
+
+	printf("IMU calibrated after %.0f ms, gyro offsets [deg/s]: %.2f %.2f %.2f, stored: %s\n", (calibrated_us - sim_start) * 0.001,
+			-calibration.gyro_offsets[0] * 2000 / 32768, -calibration.gyro_offsets[1] * 2000 / 32768,
+			-calibration.gyro_offsets[2] * 2000 / 32768, stored_ok ? "yes" : "no");
+
+	// frame stands still only until take off, the bias model has that period at least
+	Gyro_Bias_Model::Table stored_bias;
+	Gyro_Bias_Model& bias_model = mpu.Get_Gyro_Bias_Model();
+	bool bias_ok = bias_model.Get_Updates() > 0 && storage.Read(GYRO_BIAS_KEY, &stored_bias, sizeof(stored_bias)) == HAL_OK;
+
+	bias_model.Get_Table(gyro_bias);
+
+	if (memcmp(&stored_bias, &gyro_bias, sizeof(gyro_bias)) != 0)
+		bias_ok = false;
+
+	printf("gyro bias model: %u stationary periods at %.1f deg C, stored: %s\n", bias_model.Get_Updates(),
+			mpu.Get_Temperature(), bias_ok ? "yes" : "no");
+
+	bool blackbox_ok = Check_Blackbox();
+
+	for (uint8_t i = 0; i < scheduler.Get_Task_Count(); i++) {
+		const Scheduler::Task_Statistics& statistics = scheduler.Get_Statistics(i);
+
+		printf("task %s: %u runs, %u overruns, %u deferrals, %u misses, max latency %u us, jitter avg %u max %u us\n",
+				scheduler.Get_Task(i).name, statistics.runs, statistics.overruns, statistics.deferrals, statistics.misses,
+				statistics.max_latency_us, scheduler.Get_Average_Jitter_us(i), statistics.max_jitter_us);
+	}
+
+	// fail when the frame never recovered or fell back on the ground
+	if (settle_ms < 0 || peak > 45 || model.Is_On_Ground() || motors_controller.Get_Tilt_Lock() || !stored_ok || !bias_ok
+			|| !blackbox_ok)
+		return 1;
+
+	return 0;
+}
+
+// Recorded frames read back through the ground decoder, each one has to be
+// there or be counted as dropped.
+bool Check_Blackbox() {
+	const uint16_t CHUNK_SIZE = 1024;
+	uint8_t chunk[CHUNK_SIZE];
+	Telemetry_Decoder decoder;
+	uint32_t decoded = 0;
+	uint32_t missing = 0;
+	uint16_t next_sequence = 0;
+
+	blackbox.Stop();
+
+	for (uint16_t i = 0; i < 100 && blackbox.Get_State() == Blackbox::BLACKBOX_STOPPING; i++) {
+		sim.Advance(1000);
+		blackbox.Process();
+	}
+
+	for (uint32_t offset = 0; offset < blackbox.Get_Size(); offset += CHUNK_SIZE) {
+		uint16_t size = blackbox.Get_Size() - offset < CHUNK_SIZE ? blackbox.Get_Size() - offset : CHUNK_SIZE;
+
+		if (blackbox.Read(offset, chunk, size) != HAL_OK)
+			return false;
+
+		for (uint16_t i = 0; i < size; i++) {
+			if (!decoder.Push(chunk[i]))
+				continue;
+
+			uint16_t sequence = decoder.Get_Frame().sequence;
+
+			missing += uint16_t(sequence - next_sequence);
+			next_sequence = sequence + 1;
+			decoded++;
+		}
+	}
+
+	printf("blackbox: %u frames in %u kB, %u dropped, read back %u, missing %u, decode errors %u\n",
+			blackbox.Get_Frames(), blackbox.Get_Size() / 1024, blackbox.Get_Dropped(), decoded, missing,
+			decoder.Get_Errors());
+
+	return blackbox.Get_State() == Blackbox::BLACKBOX_IDLE && decoded == blackbox.Get_Frames()
+			&& missing == blackbox.Get_Dropped() && decoder.Get_Errors() == 0 && decoded > 0;
+}
+
+void Watchdog_Callback(int signal) {
+	printf("SIL timed out\n");
+	_exit(2);
+}
+
+void IMU_Data_Ready_Callback() {
+	if (mpu.Start_Read() != HAL_OK)
+		LEDs::TurnOn(LEDs::Orange);
+}
+
+void IMU_Data_Read_Callback() {
+	static uint8_t samples = 0;
+
+	// burst holds everything sampled since the last read
+	if (mpu.Get_FIFO_Mode()) {
+		scheduler.Trigger(CONTROL_TASK);
+		return;
+	}
+
+	// IMU may sample faster than control runs
+	samples++;
+
+	if (samples >= mpu.Get_Output_Rate() / RATE_LOOP_RATE) {
+		samples = 0;
+		scheduler.Trigger(CONTROL_TASK);
+	}
+}
+
+void IMU_Task() {
+	if (mpu.Start_Read() != HAL_OK)
+		LEDs::TurnOn(LEDs::Orange);
+}
+
+void Notch_Task() {
+	mpu.Get_Dynamic_Notch().Step();
+}
+
+void Calibration_Task() {
+	static uint32_t gyro_bias_updates = 0;
+	static uint32_t gyro_bias_ticks = 0;
+	IMU::Calibration calibration;
+	Gyro_Bias_Model::Table gyro_bias;
+	bool motors_off = motors_controller.Get_Motors_Off();
+
+	mpu.Set_Bias_Learning(motors_off);
+
+	if (mpu.Update_Calibration() != IMU::CALIBRATION_DONE)
+		return;
+
+	if (calibrating) {
+		calibrating = false;
+		calibrated_us = sim.Get_Time_us();
+
+		if (!mpu.Get_Calibration(calibration) || storage.Write(CALIBRATION_KEY, &calibration, sizeof(calibration)))
+			LEDs::TurnOn(LEDs::Orange);
+	}
+
+	Gyro_Bias_Model& model = mpu.Get_Gyro_Bias_Model();
+
+	if (!motors_off || model.Get_Updates() == gyro_bias_updates
+			|| (gyro_bias_updates != 0 && HAL_GetTick() - gyro_bias_ticks < GYRO_BIAS_STORE_INTERVAL))
+		return;
+
+	gyro_bias_updates = model.Get_Updates();
+	gyro_bias_ticks = HAL_GetTick();
+
+	model.Get_Table(gyro_bias);
+
+	if (storage.Write(GYRO_BIAS_KEY, &gyro_bias, sizeof(gyro_bias)))
+		LEDs::TurnOn(LEDs::Orange);
+}
+
+// drains snapshots as Logger does on The_Eye, the SIL has no link
+void Blackbox_Task() {
+	Telemetry::Snapshot snapshot;
+	uint32_t lost = blackbox_reader.lost;
+
+	while (capture.Read(blackbox_reader, snapshot, blackbox.Get_Data_Type())) {
+		if (blackbox_reader.lost != lost) {
+			blackbox.Skip(blackbox_reader.lost - lost);
+			lost = blackbox_reader.lost;
+		}
+
+		blackbox.Record(snapshot);
+	}
+
+	blackbox.Process();
+}
+
+void Control_Task() {
+	static uint8_t rate_loops = 0;
+
+	control_probe.Start();
+
+	complete_read_probe.Start();
+	mpu.Complete_Read();
+	complete_read_probe.Stop();
+
+	// motors stay off until gyro offsets are known
+	if (mpu.Get_Calibration_State() != IMU::CALIBRATION_DONE) {
+		capture.Push();
+		control_probe.Stop();
+		return;
+	}
+
+	rate_loops++;
+
+	if (rate_loops >= RATE_LOOP_RATE / ANGLE_LOOP_RATE) {
+		rate_loops = 0;
+
+		ahrs_probe.Start();
+		mpu.Compute_Attitude();
+		motors_controller.Update_Angle_Loop();
+		ahrs_probe.Stop();
+	}
+	else
+		mpu.Predict_Attitude();
+
+	motors_probe.Start();
+	motors_controller.Update_Motors();
+	motors_probe.Stop();
+
+	capture.Push();
+
+	control_probe.Stop();
+
+	// compare values are loaded on the next PWM update event
+	if (motors_controller.Get_Throttle() >= 1050) {
+		// decimated samples are stamped at their centre, stamp of the newest one in it
+		// is never before the sample was taken
+		uint64_t stamp = mpu.Get_Sample_Timestamp() + uint32_t(mpu.Get_Decimator().Get_Delay() * 1000000 / SAMPLE_RATE + 0.5f);
+		uint64_t taken = sim.Get_Transfer_Sample_us();
+
+		while (taken > stamp)
+			taken -= sim.Get_IMU().Get_Sample_Period_us();
+
+		latency.Add(sim.Get_Next_PWM_Update_us() - sim.Get_Transfer_Sample_us());
+		timestamp_error.Add(double(stamp - taken));
+	}
+}
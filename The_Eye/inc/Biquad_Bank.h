@@ -0,0 +1,121 @@
+/*
+ * Biquad_Bank.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef BIQUAD_BANK_H_
+#define BIQUAD_BANK_H_
+
+#include <stdint.h>
+#include "Biquad_Filter.h"
+
+namespace flyhero {
+
+// N biquads filtered in lock-step, one sample per channel and call.
+// Coefficients and state are kept per channel in arrays padded to 4 lanes
+// so that the whole bank is one loop without remainder - the compiler
+// unrolls it on target and vectorises it on host. Spare lanes filter zeros.
+template <uint8_t N>
+class Biquad_Bank {
+	static_assert(N > 0, "empty bank");
+
+private:
+	static const uint8_t LANES = (N + 3) & ~3;
+
+	float a0[LANES], a1[LANES], a2[LANES];
+	float b1[LANES], b2[LANES];
+	float z1[LANES], z2[LANES];
+
+	void set_coefficients(uint8_t channel, Biquad_Filter::Filter_Type type, float sample_frequency, float cut_frequency) {
+		Biquad_Filter::Coefficients coefficients = Biquad_Filter::Get_Coefficients(type, sample_frequency, cut_frequency);
+
+		this->a0[channel] = coefficients.a0;
+		this->a1[channel] = coefficients.a1;
+		this->a2[channel] = coefficients.a2;
+		this->b1[channel] = coefficients.b1;
+		this->b2[channel] = coefficients.b2;
+		this->z1[channel] = 0;
+		this->z2[channel] = 0;
+	}
+
+public:
+	// all channels bypassed
+	Biquad_Bank() {
+		for (uint8_t i = 0; i < LANES; i++)
+			this->Bypass(i);
+	}
+
+	Biquad_Bank(Biquad_Filter::Filter_Type type, float sample_frequency, float cut_frequency) {
+		this->Set_Coefficients(type, sample_frequency, cut_frequency);
+	}
+
+	// all channels, resets state
+	void Set_Coefficients(Biquad_Filter::Filter_Type type, float sample_frequency, float cut_frequency) {
+		for (uint8_t i = 0; i < LANES; i++)
+			this->set_coefficients(i, type, sample_frequency, cut_frequency);
+	}
+
+	// one channel, resets its state
+	void Set_Coefficients(uint8_t channel, Biquad_Filter::Filter_Type type, float sample_frequency, float cut_frequency) {
+		if (channel < N)
+			this->set_coefficients(channel, type, sample_frequency, cut_frequency);
+	}
+
+	// moves running filter, state is kept so output does not jump
+	void Tune(uint8_t channel, Biquad_Filter::Filter_Type type, float sample_frequency, float cut_frequency, float Q) {
+		if (channel >= N)
+			return;
+
+		Biquad_Filter::Coefficients coefficients = Biquad_Filter::Get_Coefficients(type, sample_frequency, cut_frequency, Q);
+
+		this->a0[channel] = coefficients.a0;
+		this->a1[channel] = coefficients.a1;
+		this->a2[channel] = coefficients.a2;
+		this->b1[channel] = coefficients.b1;
+		this->b2[channel] = coefficients.b2;
+	}
+
+	// channel passes input unchanged
+	void Bypass(uint8_t channel) {
+		if (channel >= LANES)
+			return;
+
+		this->a0[channel] = 1;
+		this->a1[channel] = 0;
+		this->a2[channel] = 0;
+		this->b1[channel] = 0;
+		this->b2[channel] = 0;
+		this->z1[channel] = 0;
+		this->z2[channel] = 0;
+	}
+
+	void Reset() {
+		for (uint8_t i = 0; i < LANES; i++) {
+			this->z1[i] = 0;
+			this->z2[i] = 0;
+		}
+	}
+
+	// input and output may be the same array
+	inline void Apply_Filter(const float input[N], float output[N]) {
+		float in[LANES], out[LANES];
+
+		for (uint8_t i = 0; i < LANES; i++)
+			in[i] = i < N ? input[i] : 0;
+
+		for (uint8_t i = 0; i < LANES; i++) {
+			out[i] = in[i] * this->a0[i] + this->z1[i];
+			this->z1[i] = in[i] * this->a1[i] + this->z2[i] - this->b1[i] * out[i];
+			this->z2[i] = in[i] * this->a2[i] - this->b2[i] * out[i];
+		}
+
+		for (uint8_t i = 0; i < N; i++)
+			output[i] = out[i];
+	}
+};
+
+} /* namespace flyhero */
+
+#endif /* BIQUAD_BANK_H_ */
@@ -15,17 +15,28 @@ namespace flyhero {
 // Many thanks to http://www.earlevel.com/main/2012/11/26/biquad-c-source-code/
 
 class Biquad_Filter {
-private:
-	const double PI = 3.14159265358979323846;
+public:
+	enum Filter_Type { FILTER_LOW_PASS, FILTER_NOTCH };
 
+	struct Coefficients {
+		float a0, a1, a2;
+		float b1, b2;
+	};
+
+private:
 	float a0, a1, a2;
 	float b1, b2;
 	float z1, z2;
 public:
-	enum Filter_Type { FILTER_LOW_PASS, FILTER_NOTCH };
-
 	Biquad_Filter(Filter_Type type, float sample_frequency, float cut_frequency);
 
+	// Q of 1 / sqrt(2) gives Butterworth low pass, higher Q narrows notch
+	static Coefficients Get_Coefficients(Filter_Type type, float sample_frequency, float cut_frequency,
+			float Q = 0.70710678f);
+
+	void Set_Coefficients(Filter_Type type, float sample_frequency, float cut_frequency);
+	void Reset();
+
 	inline float Apply_Filter(float value);
 };
 
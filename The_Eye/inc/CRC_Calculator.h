@@ -26,6 +26,8 @@ public:
 	HAL_StatusTypeDef Init();
 	uint32_t Calculate(uint32_t *buffer, uint32_t buffer_length);
 	uint32_t Accumulate(uint32_t *buffer, uint32_t buffer_length);
+	// any alignment, size in bytes
+	uint32_t Calculate(const uint8_t *data, uint32_t size);
 };
 
 } /* namespace flyhero */
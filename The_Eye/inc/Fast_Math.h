@@ -0,0 +1,179 @@
+/*
+ * Fast_Math.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef FAST_MATH_H_
+#define FAST_MATH_H_
+
+#include <stdint.h>
+#include <cmath>
+
+namespace flyhero {
+
+// Single precision kernels for the control path, double precision library
+// calls are emulated in software on Cortex-M4. Error bounds are absolute
+// unless stated otherwise and are checked by "sil bench fast_math", which
+// sweeps each kernel over its domain against double precision results.
+class Fast_Math {
+private:
+	Fast_Math();
+
+	// pi / 4 split so that k * DP1 is exact for reduction of large arguments
+	static constexpr float DP1 = 0.78515625f;
+	static constexpr float DP2 = 2.4187564849853515625e-4f;
+	static constexpr float DP3 = 3.77489497744594108e-8f;
+	static constexpr float FOUR_OVER_PI = 1.27323954473516f;
+
+public:
+	static constexpr float PI = 3.14159265358979323846f;
+	static constexpr float HALF_PI = 1.57079632679489661923f;
+
+	// VSQRT, correctly rounded, 14 cycles
+	static inline float Sqrt(float x);
+	// VSQRT and VDIV, 1 ulp relative
+	static inline float Inv_Sqrt(float x);
+	// |x| < 8192 [rad], 1e-7 for sin and cos, both come from one reduction
+	static inline void Sin_Cos(float x, float& sin, float& cos);
+	static inline float Sin(float x);
+	static inline float Cos(float x);
+	// |x| < 8192 [rad], 3e-7 relative where |tan| < 1000
+	static inline float Tan(float x);
+	// [rad], 4e-7, asin(+-1) = +-pi / 2, input is clamped to [-1, 1]
+	static inline float Asin(float x);
+	// [rad], 6e-7, atan2(0, 0) = 0, Betaflight polynomial
+	static inline float Atan2(float y, float x);
+};
+
+float Fast_Math::Sqrt(float x) {
+#if defined(__ARM_FP)
+	float result;
+
+	__asm__ ("vsqrt.f32 %0, %1" : "=t" (result) : "t" (x));
+
+	return result;
+#else
+	return std::sqrt(x);
+#endif
+}
+
+float Fast_Math::Inv_Sqrt(float x) {
+	return 1 / Fast_Math::Sqrt(x);
+}
+
+// Cephes sinf/cosf, reduction to [-pi / 4, pi / 4] and polynomials there
+void Fast_Math::Sin_Cos(float x, float& sin, float& cos) {
+	float sign_sin = 1;
+	float sign_cos = 1;
+
+	if (x < 0) {
+		x = -x;
+		sign_sin = -1;
+	}
+
+	uint32_t octant = uint32_t(x * FOUR_OVER_PI);
+
+	// odd octant goes to the next even one, x is then in [-pi / 4, pi / 4]
+	octant = (octant + 1) & ~1u;
+
+	float k = float(octant);
+
+	x = ((x - k * DP1) - k * DP2) - k * DP3;
+	octant &= 7;
+
+	if (octant > 3) {
+		sign_sin = -sign_sin;
+		sign_cos = -sign_cos;
+		octant -= 4;
+	}
+
+	if (octant > 1)
+		sign_cos = -sign_cos;
+
+	float z = x * x;
+	float s = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * x + x;
+	float c = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - 0.5f * z + 1;
+
+	if (octant == 2) {
+		sin = sign_sin * c;
+		cos = sign_cos * s;
+	}
+	else {
+		sin = sign_sin * s;
+		cos = sign_cos * c;
+	}
+}
+
+float Fast_Math::Sin(float x) {
+	float sin, cos;
+
+	Fast_Math::Sin_Cos(x, sin, cos);
+
+	return sin;
+}
+
+float Fast_Math::Cos(float x) {
+	float sin, cos;
+
+	Fast_Math::Sin_Cos(x, sin, cos);
+
+	return cos;
+}
+
+float Fast_Math::Tan(float x) {
+	float sin, cos;
+
+	Fast_Math::Sin_Cos(x, sin, cos);
+
+	return sin / cos;
+}
+
+// Abramowitz and Stegun 4.4.46, acos(x) = sqrt(1 - x) * P(x) for x in [0, 1]
+float Fast_Math::Asin(float x) {
+	bool negative = x < 0;
+
+	x = std::fabs(x);
+	x = x > 1 ? 1 : x;
+
+	float p = ((((((-0.0012624911f * x + 0.0066700901f) * x - 0.0170881256f) * x + 0.0308918810f) * x
+			- 0.0501743046f) * x + 0.0889789874f) * x - 0.2145988016f) * x + 1.5707963050f;
+	float result = HALF_PI - Fast_Math::Sqrt(1 - x) * p;
+
+	return negative ? -result : result;
+}
+
+// https://github.com/betaflight/betaflight/blob/master/src/main/common/maths.c
+float Fast_Math::Atan2(float y, float x) {
+	const float atanPolyCoef1 = 3.14551665884836e-07f;
+	const float atanPolyCoef2 = 0.99997356613987f;
+	const float atanPolyCoef3 = 0.14744007058297684f;
+	const float atanPolyCoef4 = 0.3099814292351353f;
+	const float atanPolyCoef5 = 0.05030176425872175f;
+	const float atanPolyCoef6 = 0.1471039133652469f;
+	const float atanPolyCoef7 = 0.6444640676891548f;
+
+	float abs_x = std::fabs(x);
+	float abs_y = std::fabs(y);
+	float result = abs_x > abs_y ? abs_x : abs_y;
+
+	if (result != 0)
+		result = (abs_x < abs_y ? abs_x : abs_y) / result;
+
+	result = -((((atanPolyCoef5 * result - atanPolyCoef4) * result - atanPolyCoef3) * result - atanPolyCoef2) * result
+			- atanPolyCoef1) / ((atanPolyCoef7 * result + atanPolyCoef6) * result + 1);
+
+	if (abs_y > abs_x)
+		result = HALF_PI - result;
+	if (x < 0)
+		result = PI - result;
+	if (y < 0)
+		result = -result;
+
+	return result;
+}
+
+} /* namespace flyhero */
+
+#endif /* FAST_MATH_H_ */
@@ -0,0 +1,63 @@
+/*
+ * Flash_Storage.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef FLASH_STORAGE_H_
+#define FLASH_STORAGE_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "stm32f4xx_hal.h"
+#include "CRC_Calculator.h"
+
+namespace flyhero {
+
+// Keeps small records in one flash sector reserved in the linker script.
+// Records are only appended, reading returns the newest one with given key
+// and valid CRC, so a write interrupted by reset leaves the previous value.
+// Erase takes 1 - 2 s with the CPU stalled, so Write() never erases - writes
+// fail once the sector is full and Init() erases it at the next boot, before
+// the watchdog is started. All records are lost then, stored values are meant
+// to be re-creatable. Key 0xFFFF is reserved.
+class Flash_Storage {
+private:
+	Flash_Storage();
+	Flash_Storage(Flash_Storage const&);
+	Flash_Storage& operator=(Flash_Storage const&);
+
+	struct Record_Header {
+		uint32_t magic;
+		uint16_t key;
+		uint16_t size;		// [B] data follows padded to words
+		uint32_t crc;		// key, size and data, written last
+	};
+
+	static const uint32_t MAGIC = 0x43464731;
+	static const uint32_t ERASED = 0xFFFFFFFF;
+
+	uint32_t sector;
+	uintptr_t address;
+	uint32_t size;
+	uintptr_t free_address;
+
+	static uint16_t words(uint16_t size);
+	uint32_t crc(const Record_Header *header, const uint32_t *data);
+	const Record_Header* find(uint16_t key, uintptr_t& end);
+	HAL_StatusTypeDef program(uintptr_t address, uint32_t word);
+
+public:
+	static Flash_Storage& Instance();
+
+	HAL_StatusTypeDef Init(uint32_t sector, uintptr_t address, uint32_t size, uint32_t reserve);
+	HAL_StatusTypeDef Read(uint16_t key, void *data, uint16_t size);
+	HAL_StatusTypeDef Write(uint16_t key, const void *data, uint16_t size);
+	HAL_StatusTypeDef Erase();
+	uint32_t Get_Free_Space();
+};
+
+} /* namespace flyhero */
+
+#endif /* FLASH_STORAGE_H_ */
@@ -0,0 +1,136 @@
+/*
+ * Mixer.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef MIXER_H_
+#define MIXER_H_
+
+#include <stdint.h>
+
+namespace flyhero {
+
+enum Frame_Type { FRAME_QUAD_X, FRAME_QUAD_PLUS, FRAME_HEXA_X, FRAME_OCTO_X };
+
+// contribution of roll, pitch and yaw corrections to one motor,
+// roll is positive on the right side, pitch on the back side,
+// yaw sign gives spin direction
+struct Motor_Mix {
+	float roll, pitch, yaw;
+	uint8_t channel;		// PWM_Generator index
+};
+
+template <Frame_Type FRAME>
+struct Frame_Geometry;
+
+template <>
+struct Frame_Geometry<FRAME_QUAD_X> {
+	static const uint8_t MOTORS = 4;
+	// FL, BL, FR, BR
+	static constexpr Motor_Mix MIX[MOTORS] = {
+		{ -1, -1, -1, 3 },
+		{ -1,  1,  1, 2 },
+		{  1, -1,  1, 4 },
+		{  1,  1, -1, 1 },
+	};
+};
+
+template <>
+struct Frame_Geometry<FRAME_QUAD_PLUS> {
+	static const uint8_t MOTORS = 4;
+	// F, R, B, L
+	static constexpr Motor_Mix MIX[MOTORS] = {
+		{  0, -1, -1, 3 },
+		{  1,  0,  1, 4 },
+		{  0,  1, -1, 1 },
+		{ -1,  0,  1, 2 },
+	};
+};
+
+template <>
+struct Frame_Geometry<FRAME_HEXA_X> {
+	static const uint8_t MOTORS = 6;
+	// clockwise from 30 deg, roll = sin(angle), pitch = -cos(angle)
+	static constexpr Motor_Mix MIX[MOTORS] = {
+		{  0.5f, -0.866025f, -1, 1 },
+		{  1.0f,  0.0f,       1, 2 },
+		{  0.5f,  0.866025f, -1, 3 },
+		{ -0.5f,  0.866025f,  1, 4 },
+		{ -1.0f,  0.0f,      -1, 5 },
+		{ -0.5f, -0.866025f,  1, 6 },
+	};
+};
+
+template <>
+struct Frame_Geometry<FRAME_OCTO_X> {
+	static const uint8_t MOTORS = 8;
+	// clockwise from 22.5 deg, roll = sin(angle), pitch = -cos(angle)
+	static constexpr Motor_Mix MIX[MOTORS] = {
+		{  0.382683f, -0.923880f, -1, 1 },
+		{  0.923880f, -0.382683f,  1, 2 },
+		{  0.923880f,  0.382683f, -1, 3 },
+		{  0.382683f,  0.923880f,  1, 4 },
+		{ -0.382683f,  0.923880f, -1, 5 },
+		{ -0.923880f,  0.382683f,  1, 6 },
+		{ -0.923880f, -0.382683f, -1, 7 },
+		{ -0.382683f, -0.923880f,  1, 8 },
+	};
+};
+
+// Frame is picked at compile time, mixing is a MOTORS x 3 matrix-vector product.
+// Saturated outputs are not clipped one by one, corrections are scaled down
+// and throttle is shifted so that their differences (attitude authority) are kept.
+template <Frame_Type FRAME>
+class Mixer {
+public:
+	typedef Frame_Geometry<FRAME> Geometry;
+
+	static const uint8_t MOTORS = Geometry::MOTORS;
+
+	static inline uint8_t Get_Channel(uint8_t motor) {
+		return Geometry::MIX[motor].channel;
+	}
+
+	static inline void Mix(float throttle, float roll, float pitch, float yaw,
+			float min, float max, float outputs[MOTORS]) {
+		float lowest = 0, highest = 0;
+
+		for (uint8_t i = 0; i < MOTORS; i++) {
+			const Motor_Mix& mix = Geometry::MIX[i];
+			float correction = roll * mix.roll + pitch * mix.pitch + yaw * mix.yaw;
+
+			outputs[i] = correction;
+
+			if (i == 0 || correction < lowest)
+				lowest = correction;
+			if (i == 0 || correction > highest)
+				highest = correction;
+		}
+
+		// corrections do not fit in at all, scale them down
+		if (highest - lowest > max - min) {
+			float scale = (max - min) / (highest - lowest);
+
+			for (uint8_t i = 0; i < MOTORS; i++)
+				outputs[i] *= scale;
+
+			lowest *= scale;
+			highest *= scale;
+		}
+
+		// move whole range inside limits
+		if (throttle + highest > max)
+			throttle = max - highest;
+		if (throttle + lowest < min)
+			throttle = min - lowest;
+
+		for (uint8_t i = 0; i < MOTORS; i++)
+			outputs[i] += throttle;
+	}
+};
+
+} /* namespace flyhero */
+
+#endif /* MIXER_H_ */
@@ -8,34 +8,63 @@
 #ifndef MOTORS_CONTROLLER_H_
 #define MOTORS_CONTROLLER_H_
 
-#include "PID.h"
+#include "PID3.h"
 #include "PWM_Generator.h"
-#include "MPU6050.h"
+#include "IMU.h"
+#include "Mixer.h"
+#include "Timer.h"
+#include "Timing_Probe.h"
 
 namespace flyhero {
 
 enum Axis { Roll, Pitch, Yaw };
 
+typedef Mixer<FRAME_QUAD_X> Frame_Mixer;
+
+// Cascaded controller, angle loop produces rate setpoints for the rate loop
+// which runs on filtered gyro data. Angle loop may run slower.
 class Motors_Controller {
 private:
 	Motors_Controller();
 	Motors_Controller(Motors_Controller const&);
 	Motors_Controller& operator=(Motors_Controller const&);
 
-	PID roll_PID, pitch_PID, yaw_PID;
-	/*volatile*/ uint16_t motor_FL, motor_FR, motor_BL, motor_BR;
+	const float MAX_RATE = 250;		// [deg/s]
+	// more than 70 deg from level is unsafe
+	const float MAX_TILT_COS = 0.342f;
+	const float RAD_TO_DEG = 57.2957795f;
+	const float D_TERM_LPF_FREQUENCY = 20;
+	const uint16_t MOTOR_OFF = 940;
+	const uint16_t MOTOR_IDLE = 1050;
+	const uint16_t MOTOR_MAX = 2000;
+
+	PID3 angle_PID, rate_PID;
+	float rate_setpoint[PID3::AXES];
+	/*volatile*/ uint16_t motors[Frame_Mixer::MOTORS];
 	/*volatile*/ uint16_t throttle;
 	/*volatile*/ bool invert_yaw;
+	// motors stay off until throttle is pulled down
+	bool tilt_lock;
+	// age of the gyro sample behind the last PWM write [us]
+	uint32_t sample_age;
 
 public:
 	static Motors_Controller& Instance();
 
 	void Set_PID_Constants(Axis axis, float Kp, float Ki, float Kd);
+	void Set_Rate_PID_Constants(Axis axis, float Kp, float Ki, float Kd);
+	void Set_Loop_Rates(uint16_t rate_loop, uint16_t angle_loop);
 	void Set_Throttle(uint16_t throttle);
 	void Set_Invert_Yaw(bool invert);
+	void Update_Angle_Loop();
 	void Update_Motors();
 
 	uint16_t Get_Throttle();
+	bool Get_Tilt_Lock();
+	// not spinning, throttle below idle or tilt lock
+	bool Get_Motors_Off();
+	uint32_t Get_Sample_Age();
+	uint16_t Get_Motor(uint8_t index);
 	uint16_t Get_Motor_FL();
 	uint16_t Get_Motor_FR();
 	uint16_t Get_Motor_BL();
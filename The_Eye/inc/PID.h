@@ -32,6 +32,7 @@ public:
 	void Set_Ki(float Ki);
 	void Set_Kd(float Kd);
 	void Set_I_Max(float i_max);
+	void Set_D_Term_LPF(float sample_frequency, float cut_frequency);
 };
 
 } /* namespace flyhero */
@@ -0,0 +1,50 @@
+/*
+ * PID3.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef PID3_H_
+#define PID3_H_
+
+#include <stdint.h>
+#include "Biquad_Bank.h"
+
+namespace flyhero {
+
+// Roll, pitch and yaw PIDs updated together from one timestamp. State is kept
+// per term in arrays (structure of arrays), math is single precision only.
+class PID3 {
+public:
+	static const uint8_t AXES = 3;
+
+private:
+	PID3(PID3 const&);
+	PID3& operator=(PID3 const&);
+
+	// longer gaps restart integration
+	const uint8_t MAX_DT_PERIODS = 10;
+
+	Biquad_Bank<AXES> d_term_lpf;
+	uint32_t last_t;
+	float max_dt;
+	float Kp[AXES], Ki[AXES], Kd[AXES];
+	float integrator[AXES];
+	float i_max[AXES];
+	float last_error[AXES];
+
+public:
+	PID3(uint16_t rate = 1000, float d_term_cut_frequency = 20);
+
+	// timestamp in us
+	void Update(uint32_t timestamp, const float error[AXES], float output[AXES]);
+	void Reset();
+	void Set_Rate(uint16_t rate, float d_term_cut_frequency = 20);
+	void Set_Constants(uint8_t axis, float Kp, float Ki, float Kd);
+	void Set_I_Max(float i_max);
+};
+
+} /* namespace flyhero */
+
+#endif /* PID3_H_ */
@@ -0,0 +1,90 @@
+/*
+ * Scheduler.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stm32f4xx_hal.h>
+#include "Timer.h"
+
+namespace flyhero {
+
+// Cooperative table driven scheduler. Tasks are listed in priority order,
+// every Run() executes the first task that is ready. Triggered tasks are
+// made ready from an interrupt (e.g. IMU data read), periodic tasks by time.
+// A periodic task is deferred when its budget does not fit before the next
+// expected trigger, so background work cannot stretch the control period.
+class Scheduler {
+public:
+	typedef void (*Task_Function)();
+
+	static const uint8_t MAX_TASKS = 12;
+
+	struct Task {
+		const char *name;
+		Task_Function function;
+		uint32_t period_us;		// for triggered tasks expected trigger interval
+		uint32_t budget_us;
+		bool triggered;
+		bool enabled;
+	};
+
+	struct Task_Statistics {
+		uint32_t runs;
+		uint32_t overruns;			// run took longer than budget
+		uint32_t deferrals;			// not started as budget did not fit
+		uint32_t misses;			// whole period lost
+		uint32_t last_duration_us;
+		uint32_t max_duration_us;
+		uint32_t max_latency_us;	// from trigger / due time to start
+		uint32_t max_jitter_us;		// start to start deviation from period
+		uint64_t jitter_sum_us;
+	};
+
+private:
+	Scheduler();
+	Scheduler(Scheduler const&);
+	Scheduler& operator=(Scheduler const&);
+
+	struct Task_State {
+		Task task;
+		Task_Statistics statistics;
+		uint32_t due_us;
+		uint32_t last_start_us;
+		volatile uint32_t trigger_us;
+		volatile bool pending;
+		bool started;
+		bool deferred;
+	};
+
+	// slack kept free before the next expected trigger
+	const uint32_t TRIGGER_MARGIN_US = 20;
+
+	Task_State tasks[MAX_TASKS];
+	uint8_t task_count;
+
+	bool fits(uint32_t budget_us, uint32_t now);
+	void execute(Task_State& state, uint32_t due_us, uint32_t now);
+
+public:
+	static Scheduler& Instance();
+
+	HAL_StatusTypeDef Init(const Task *tasks, uint8_t count);
+	void Trigger(uint8_t task);
+	bool Run();
+
+	void Set_Enabled(uint8_t task, bool enabled);
+	uint8_t Get_Task_Count();
+	const Task& Get_Task(uint8_t task);
+	const Task_Statistics& Get_Statistics(uint8_t task);
+	uint32_t Get_Average_Jitter_us(uint8_t task);
+	void Reset_Statistics();
+};
+
+} /* namespace flyhero */
+
+#endif /* SCHEDULER_H_ */
@@ -0,0 +1,86 @@
+/*
+ * Timing_Probe.h
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#ifndef TIMING_PROBE_H_
+#define TIMING_PROBE_H_
+
+#include <stm32f4xx_hal.h>
+
+#ifdef SIL
+#include <chrono>
+#endif
+
+namespace flyhero {
+
+// Measures cost of a code section. On target ticks are DWT core cycles,
+// in SIL nanoseconds of the host steady clock. Every probe registers itself
+// so that all of them can be listed (e.g. by Logger).
+class Timing_Probe {
+public:
+	static const uint8_t MAX_PROBES = 16;
+	static const uint8_t HISTOGRAM_BINS = 8;
+
+	struct Statistics {
+		uint32_t count;
+		uint32_t min, max;		// ticks
+		uint64_t sum;
+		// last bin collects everything above
+		uint32_t histogram[HISTOGRAM_BINS];
+	};
+
+private:
+	Timing_Probe(Timing_Probe const&);
+	Timing_Probe& operator=(Timing_Probe const&);
+
+	static Timing_Probe *probes[MAX_PROBES];
+	static uint8_t probe_count;
+	static uint32_t ticks_per_us;
+
+	const char *name;
+	uint32_t bin_width_us;
+	uint32_t start_ticks;
+	Statistics statistics;
+
+public:
+	Timing_Probe(const char *name, uint32_t bin_width_us);
+
+	static void Init();
+	static uint32_t Get_Ticks_Per_us();
+	static uint8_t Get_Probe_Count();
+	static Timing_Probe* Get_Probe(uint8_t index);
+
+	static inline uint32_t Get_Ticks() {
+#ifdef SIL
+		return uint32_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count());
+#else
+		return DWT->CYCCNT;
+#endif
+	}
+
+	inline void Start() {
+		this->start_ticks = Timing_Probe::Get_Ticks();
+	}
+
+	inline void Stop() {
+		this->Add(Timing_Probe::Get_Ticks() - this->start_ticks);
+	}
+
+	void Add(uint32_t ticks);
+	void Reset();
+
+	const char* Get_Name();
+	uint32_t Get_Bin_Width_us();
+	const Statistics& Get_Statistics();
+	float Get_Min_us();
+	float Get_Average_us();
+	float Get_Max_us();
+};
+
+} /* namespace flyhero */
+
+#endif /* TIMING_PROBE_H_ */
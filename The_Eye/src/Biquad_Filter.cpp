@@ -6,38 +6,64 @@
  */
 
 #include <Biquad_Filter.h>
+#include "Fast_Math.h"
 
 namespace flyhero {
 
 Biquad_Filter::Biquad_Filter(Filter_Type type, float sample_frequency, float cut_frequency) {
-	double K = std::tan(this->PI * cut_frequency / sample_frequency);
-	double Q = 1.0 / std::sqrt(2); // let Q be 1 / sqrt(2) for Butterworth
+	this->Set_Coefficients(type, sample_frequency, cut_frequency);
+}
+
+Biquad_Filter::Coefficients Biquad_Filter::Get_Coefficients(Filter_Type type, float sample_frequency, float cut_frequency,
+		float Q) {
+	// float is enough down to cut of 1e-3 sample rate, coefficients are stored as float
+	// anyway and dynamic notch retunes them in flight
+	float K = Fast_Math::Tan(Fast_Math::PI * cut_frequency / sample_frequency);
 
-	double norm;
+	float norm;
+	Coefficients coefficients = Coefficients();
 
 	switch (type) {
 	case FILTER_LOW_PASS:
-		norm = 1.0 / (1 + K / Q + K * K);
+		norm = 1 / (1 + K / Q + K * K);
 
-		this->a0 = K * K * norm;
-		this->a1 = 2 * this->a0;
-		this->a2 = this->a0;
-		this->b1 = 2 * (K * K - 1) * norm;
-		this->b2 = (1 - K / Q + K * K) * norm;
+		coefficients.a0 = K * K * norm;
+		coefficients.a1 = 2 * coefficients.a0;
+		coefficients.a2 = coefficients.a0;
+		coefficients.b1 = 2 * (K * K - 1) * norm;
+		coefficients.b2 = (1 - K / Q + K * K) * norm;
 
 		break;
 	case FILTER_NOTCH:
-		norm = 1.0 / (1 + K / Q + K * K);
+		norm = 1 / (1 + K / Q + K * K);
 
-		this->a0 = (1 + K * K) * norm;
-		this->a1 = 2 * (K * K - 1) * norm;
-		this->a2 = this->a0;
-		this->b1 = this->a1;
-		this->b2 = (1 - K / Q + K * K) * norm;
+		coefficients.a0 = (1 + K * K) * norm;
+		coefficients.a1 = 2 * (K * K - 1) * norm;
+		coefficients.a2 = coefficients.a0;
+		coefficients.b1 = coefficients.a1;
+		coefficients.b2 = (1 - K / Q + K * K) * norm;
 
 		break;
 	}
 
+	return coefficients;
+}
+
+// also resets filter state
+void Biquad_Filter::Set_Coefficients(Filter_Type type, float sample_frequency, float cut_frequency) {
+	Coefficients coefficients = Biquad_Filter::Get_Coefficients(type, sample_frequency, cut_frequency);
+
+	this->a0 = coefficients.a0;
+	this->a1 = coefficients.a1;
+	this->a2 = coefficients.a2;
+	this->b1 = coefficients.b1;
+	this->b2 = coefficients.b2;
+
+	this->Reset();
+}
+
+// clears filter state, coefficients are kept
+void Biquad_Filter::Reset() {
 	this->z1 = 0;
 	this->z2 = 0;
 }
@@ -5,6 +5,7 @@
  *      Author: michp
  */
 
+#include <string.h>
 #include <CRC_Calculator.h>
 
 namespace flyhero {
@@ -16,6 +17,8 @@ CRC_Calculator& CRC_Calculator::Instance() {
 }
 
 HAL_StatusTypeDef CRC_Calculator::Init() {
+	__HAL_RCC_CRC_CLK_ENABLE();
+
 	this->hcrc.Instance = CRC;
 
 	return HAL_CRC_Init(&this->hcrc);
@@ -31,4 +34,28 @@ uint32_t CRC_Calculator::Accumulate(uint32_t *buffer, uint32_t buffer_length) {
 	return HAL_CRC_Accumulate(&this->hcrc, buffer, buffer_length);
 }
 
+// Bytes go in as little endian words the way the CPU loads them, the last
+// word padded with zeros. Copied through an aligned buffer, so frames do not
+// have to start on a word boundary.
+uint32_t CRC_Calculator::Calculate(const uint8_t *data, uint32_t size) {
+	uint32_t words[16];
+	uint32_t crc = 0xFFFFFFFF;
+	bool first = true;
+
+	while (size > 0) {
+		uint32_t chunk = size < sizeof(words) ? size : sizeof(words);
+		uint32_t count = (chunk + 3) / 4;
+
+		words[count - 1] = 0;
+		memcpy(words, data, chunk);
+
+		crc = first ? this->Calculate(words, count) : this->Accumulate(words, count);
+		first = false;
+		data += chunk;
+		size -= chunk;
+	}
+
+	return crc;
+}
+
 } /* namespace flyhero */
@@ -0,0 +1,200 @@
+/*
+ * Flash_Storage.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include <Flash_Storage.h>
+
+namespace flyhero {
+
+Flash_Storage& Flash_Storage::Instance() {
+	static Flash_Storage instance;
+
+	return instance;
+}
+
+Flash_Storage::Flash_Storage() {
+	this->sector = 0;
+	this->address = 0;
+	this->size = 0;
+	this->free_address = 0;
+}
+
+// sector has to be reserved in the linker script, address and size have to match it,
+// sector is erased when less than reserve [B] of data is left for this boot
+HAL_StatusTypeDef Flash_Storage::Init(uint32_t sector, uintptr_t address, uint32_t size, uint32_t reserve) {
+	this->sector = sector;
+	this->address = address;
+	this->size = size;
+
+	if (CRC_Calculator::Instance().Init())
+		return HAL_ERROR;
+
+	// no key is 0xFFFF, only free space is looked for
+	this->find(0xFFFF, this->free_address);
+
+	if (this->Get_Free_Space() < reserve)
+		return this->Erase();
+
+	return HAL_OK;
+}
+
+// stored size has to match, record of older layout is not returned
+HAL_StatusTypeDef Flash_Storage::Read(uint16_t key, void *data, uint16_t size) {
+	uintptr_t end;
+	const Record_Header *header = this->find(key, end);
+
+	if (header == NULL || header->size != size)
+		return HAL_ERROR;
+
+	memcpy(data, header + 1, size);
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef Flash_Storage::Write(uint16_t key, const void *data, uint16_t size) {
+	uint32_t record_size = sizeof(Record_Header) + words(size) * 4;
+
+	// full until Init() erases at next boot
+	if (this->free_address + record_size > this->address + this->size)
+		return HAL_ERROR;
+
+	uintptr_t record = this->free_address;
+	Record_Header header;
+
+	header.magic = MAGIC;
+	header.key = key;
+	header.size = size;
+
+	uint32_t header_words[2];
+	memcpy(header_words, &header, sizeof(header_words));
+
+	HAL_FLASH_Unlock();
+
+	// space is taken even when programming fails, that record is skipped by its CRC
+	this->free_address += record_size;
+
+	if (this->program(record, header_words[0]) || this->program(record + 4, header_words[1])) {
+		HAL_FLASH_Lock();
+		return HAL_ERROR;
+	}
+
+	const uint8_t *bytes = static_cast<const uint8_t*>(data);
+	uintptr_t data_address = record + sizeof(Record_Header);
+
+	for (uint16_t i = 0; i < size; i += 4) {
+		// padding stays erased
+		uint32_t word = ERASED;
+
+		memcpy(&word, bytes + i, size - i < 4 ? size - i : 4);
+
+		if (this->program(data_address + i, word)) {
+			HAL_FLASH_Lock();
+			return HAL_ERROR;
+		}
+	}
+
+	// data cache may still hold erased lines read by find()
+	__HAL_FLASH_DATA_CACHE_DISABLE();
+	__HAL_FLASH_DATA_CACHE_RESET();
+	__HAL_FLASH_DATA_CACHE_ENABLE();
+
+	// CRC of what is really in flash certifies only data that made it there
+	const Record_Header *written = reinterpret_cast<const Record_Header*>(record);
+
+	if (memcmp(written + 1, data, size) != 0) {
+		HAL_FLASH_Lock();
+		return HAL_ERROR;
+	}
+
+	HAL_StatusTypeDef status = this->program(record + 8, this->crc(written, reinterpret_cast<const uint32_t*>(written + 1)));
+
+	HAL_FLASH_Lock();
+
+	return status;
+}
+
+HAL_StatusTypeDef Flash_Storage::Erase() {
+	FLASH_EraseInitTypeDef erase;
+	uint32_t sector_error;
+
+	erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+	erase.Banks = FLASH_BANK_1;
+	erase.Sector = this->sector;
+	erase.NbSectors = 1;
+	erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+	HAL_FLASH_Unlock();
+	HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&erase, &sector_error);
+	HAL_FLASH_Lock();
+
+	if (status)
+		return HAL_ERROR;
+
+	this->free_address = this->address;
+
+	return HAL_OK;
+}
+
+uint32_t Flash_Storage::Get_Free_Space() {
+	uintptr_t end = this->address + this->size;
+
+	if (this->free_address + sizeof(Record_Header) >= end)
+		return 0;
+
+	return end - this->free_address - sizeof(Record_Header);
+}
+
+uint16_t Flash_Storage::words(uint16_t size) {
+	return (size + 3) / 4;
+}
+
+uint32_t Flash_Storage::crc(const Record_Header *header, const uint32_t *data) {
+	CRC_Calculator& crc = CRC_Calculator::Instance();
+	uint32_t key_size;
+
+	memcpy(&key_size, &header->key, sizeof(key_size));
+
+	crc.Calculate(&key_size, 1);
+
+	return crc.Accumulate(const_cast<uint32_t*>(data), words(header->size));
+}
+
+// Newest valid record with the key, end is set to where the next record goes.
+// Anything else than a record or erased flash means the rest is unusable until erase.
+const Flash_Storage::Record_Header* Flash_Storage::find(uint16_t key, uintptr_t& end) {
+	const Record_Header *found = NULL;
+	uintptr_t sector_end = this->address + this->size;
+	uintptr_t record = this->address;
+
+	while (record + sizeof(Record_Header) <= sector_end) {
+		const Record_Header *header = reinterpret_cast<const Record_Header*>(record);
+
+		if (header->magic == ERASED) {
+			end = record;
+			return found;
+		}
+
+		uintptr_t next = record + sizeof(Record_Header) + words(header->size) * 4;
+
+		if (header->magic != MAGIC || next > sector_end)
+			break;
+
+		if (header->key == key && header->crc == this->crc(header, reinterpret_cast<const uint32_t*>(header + 1)))
+			found = header;
+
+		record = next;
+	}
+
+	end = sector_end;
+
+	return found;
+}
+
+HAL_StatusTypeDef Flash_Storage::program(uintptr_t address, uint32_t word) {
+	return HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address, word);
+}
+
+} /* namespace flyhero */
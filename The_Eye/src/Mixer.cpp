@@ -0,0 +1,18 @@
+/*
+ * Mixer.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Mixer.h"
+
+namespace flyhero {
+
+// tables are indexed at run time so they need a definition
+constexpr Motor_Mix Frame_Geometry<FRAME_QUAD_X>::MIX[];
+constexpr Motor_Mix Frame_Geometry<FRAME_QUAD_PLUS>::MIX[];
+constexpr Motor_Mix Frame_Geometry<FRAME_HEXA_X>::MIX[];
+constexpr Motor_Mix Frame_Geometry<FRAME_OCTO_X>::MIX[];
+
+} /* namespace flyhero */
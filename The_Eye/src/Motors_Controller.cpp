@@ -15,38 +15,45 @@ Motors_Controller& Motors_Controller::Instance() {
 	return instance;
 }
 
+// sample capture to PWM write, in probe ticks so that it is listed with the others
+static Timing_Probe sample_age_probe("sample_age", 250);
+
+// PWM_Generator drives TIM2 channels 1 - 4 only
+static_assert(Frame_Mixer::MOTORS <= 4, "frame needs more PWM outputs");
+
 Motors_Controller::Motors_Controller() {
-	this->motor_FR = 940;
-	this->motor_FL = 940;
-	this->motor_BR = 940;
-	this->motor_BL = 940;
+	for (uint8_t i = 0; i < Frame_Mixer::MOTORS; i++)
+		this->motors[i] = this->MOTOR_OFF;
+
+	this->angle_PID.Set_I_Max(50);
+	this->rate_PID.Set_I_Max(50);
 
-	this->roll_PID.Set_I_Max(50);
-	this->pitch_PID.Set_I_Max(50);
-	this->yaw_PID.Set_I_Max(50);
+	// tuned in SIL, ground station may overwrite them
+	this->Set_Rate_PID_Constants(Roll, 1, 1, 0.02f);
+	this->Set_Rate_PID_Constants(Pitch, 1, 1, 0.02f);
+	this->Set_Rate_PID_Constants(Yaw, 1, 0.5f, 0);
+
+	for (uint8_t i = 0; i < PID3::AXES; i++)
+		this->rate_setpoint[i] = 0;
 
 	this->invert_yaw = false;
+	this->tilt_lock = false;
+	this->sample_age = 0;
 	this->throttle = 1000;
 }
 
 void Motors_Controller::Set_PID_Constants(Axis axis, float Kp, float Ki, float Kd) {
-	switch (axis) {
-	case Roll:
-		this->roll_PID.Set_Kp(Kp);
-		this->roll_PID.Set_Ki(Ki);
-		this->roll_PID.Set_Kd(Kd);
-		break;
-	case Pitch:
-		this->pitch_PID.Set_Kp(Kp);
-		this->pitch_PID.Set_Ki(Ki);
-		this->pitch_PID.Set_Kd(Kd);
-		break;
-	case Yaw:
-		this->yaw_PID.Set_Kp(Kp);
-		this->yaw_PID.Set_Ki(Ki);
-		this->yaw_PID.Set_Kd(Kd);
-		break;
-	}
+	this->angle_PID.Set_Constants(axis, Kp, Ki, Kd);
+}
+
+void Motors_Controller::Set_Rate_PID_Constants(Axis axis, float Kp, float Ki, float Kd) {
+	this->rate_PID.Set_Constants(axis, Kp, Ki, Kd);
+}
+
+// D term filters assume 1 kHz by default
+void Motors_Controller::Set_Loop_Rates(uint16_t rate_loop, uint16_t angle_loop) {
+	this->rate_PID.Set_Rate(rate_loop, this->D_TERM_LPF_FREQUENCY);
+	this->angle_PID.Set_Rate(angle_loop, this->D_TERM_LPF_FREQUENCY);
 }
 
 void Motors_Controller::Set_Throttle(uint16_t throttle) {
@@ -57,70 +64,92 @@ void Motors_Controller::Set_Invert_Yaw(bool invert) {
 	this->invert_yaw = invert;
 }
 
+// has to be called after attitude was computed
+void Motors_Controller::Update_Angle_Loop() {
+	if (this->throttle < this->MOTOR_IDLE) {
+		for (uint8_t i = 0; i < PID3::AXES; i++)
+			this->rate_setpoint[i] = 0;
+
+		return;
+	}
+
+	IMU::Quaternion q;
+
+	IMU::Instance().Get_Quaternion(q);
+
+	// body Z axis in world frame, cos of tilt is its Z component
+	if (1 - 2 * (q.q1 * q.q1 + q.q2 * q.q2) < this->MAX_TILT_COS) {
+		this->tilt_lock = true;
+
+		for (uint8_t i = 0; i < PID3::AXES; i++)
+			this->rate_setpoint[i] = 0;
+
+		return;
+	}
+
+	// rotation to level with zero heading as rotation vector, 2 * sin(angle / 2)
+	// is close enough to the angle here and there is no gimbal lock
+	float sign = q.q0 < 0 ? -1 : 1;
+	float errors[PID3::AXES] = {
+		-2 * sign * q.q1 * this->RAD_TO_DEG,
+		-2 * sign * q.q2 * this->RAD_TO_DEG,
+		-2 * sign * q.q3 * this->RAD_TO_DEG
+	};
+
+	this->angle_PID.Update(Timer::Get_Tick_Count(), errors, this->rate_setpoint);
+
+	for (uint8_t i = 0; i < PID3::AXES; i++) {
+		if (this->rate_setpoint[i] > this->MAX_RATE)
+			this->rate_setpoint[i] = this->MAX_RATE;
+		else if (this->rate_setpoint[i] < -this->MAX_RATE)
+			this->rate_setpoint[i] = -this->MAX_RATE;
+	}
+}
+
+// rate loop, has to be called after gyro data were read
 void Motors_Controller::Update_Motors() {
 	PWM_Generator& PWM_generator = PWM_Generator::Instance();
 
-	if (this->throttle >= 1050) {
-		float pitch_correction, roll_correction, yaw_correction;
-		MPU6050::Sensor_Data euler_data;
+	if (this->throttle < this->MOTOR_IDLE)
+		this->tilt_lock = false;
 
-		MPU6050::Instance().Get_Euler(euler_data.x, euler_data.y, euler_data.z);
+	if (this->throttle >= this->MOTOR_IDLE && !this->tilt_lock) {
+		float corrections[PID3::AXES];
+		float outputs[Frame_Mixer::MOTORS];
+		IMU::Sensor_Data gyro;
 
-		// consider more then 70 deg unsafe, also prevents gimbal lock
-		if (std::fabs(euler_data.x) > 70 || std::fabs(euler_data.y) > 70) {
-			while (true);
-		}
+		IMU::Instance().Get_Gyro(gyro);
+
+		float errors[PID3::AXES] = {
+			this->rate_setpoint[Roll] - gyro.x,
+			this->rate_setpoint[Pitch] - gyro.y,
+			this->rate_setpoint[Yaw] - gyro.z
+		};
 
-		roll_correction = this->roll_PID.Get_PID(0 - euler_data.x);
-		pitch_correction = this->pitch_PID.Get_PID(0 - euler_data.y);
-		yaw_correction = this->yaw_PID.Get_PID(0 - euler_data.z);
+		this->rate_PID.Update(Timer::Get_Tick_Count(), errors, corrections);
 
 		// not sure about yaw signs
-		if (!this->invert_yaw) {
-			this->motor_FL = throttle - roll_correction - pitch_correction - yaw_correction; // PB2
-			this->motor_BL = throttle - roll_correction + pitch_correction + yaw_correction; // PA15
-			this->motor_FR = throttle + roll_correction - pitch_correction + yaw_correction; // PB10
-			this->motor_BR = throttle + roll_correction + pitch_correction - yaw_correction; // PA1
-		}
-		else {
-			this->motor_FL = throttle - roll_correction - pitch_correction + yaw_correction; // PB2
-			this->motor_BL = throttle - roll_correction + pitch_correction - yaw_correction; // PA15
-			this->motor_FR = throttle + roll_correction - pitch_correction - yaw_correction; // PB10
-			this->motor_BR = throttle + roll_correction + pitch_correction + yaw_correction; // PA1
+		if (this->invert_yaw)
+			corrections[Yaw] = -corrections[Yaw];
+
+		Frame_Mixer::Mix(this->throttle, corrections[Roll], corrections[Pitch], corrections[Yaw],
+				this->MOTOR_IDLE, this->MOTOR_MAX, outputs);
+
+		for (uint8_t i = 0; i < Frame_Mixer::MOTORS; i++) {
+			this->motors[i] = outputs[i];
+			PWM_generator.SetPulse(this->motors[i], Frame_Mixer::Get_Channel(i));
 		}
 
-		if (this->motor_FL > 2000)
-			this->motor_FL = 2000;
-		else if (this->motor_FL < 1050)
-			this->motor_FL = 940;
-
-		if (this->motor_BL > 2000)
-			this->motor_BL = 2000;
-		else if (this->motor_BL < 1050)
-			this->motor_BL = 940;
-
-		if (this->motor_FR > 2000)
-			this->motor_FR = 2000;
-		else if (this->motor_FR < 1050)
-			this->motor_FR = 940;
-
-		if (this->motor_BR > 2000)
-			this->motor_BR = 2000;
-		else if (this->motor_BR < 1050)
-			this->motor_BR = 940;
-
-		PWM_generator.SetPulse(this->motor_FL, 3);
-		PWM_generator.SetPulse(this->motor_BL, 2);
-		PWM_generator.SetPulse(this->motor_FR, 4);
-		PWM_generator.SetPulse(this->motor_BR, 1);
+		this->sample_age = IMU::Instance().Get_Sample_Age();
+		sample_age_probe.Add(this->sample_age * Timing_Probe::Get_Ticks_Per_us());
 	}
 	else {
-		MPU6050::Instance().Reset_Integrators();
+		IMU::Instance().Reset_Integrators();
 
-		PWM_generator.SetPulse(940, 1);
-		PWM_generator.SetPulse(940, 2);
-		PWM_generator.SetPulse(940, 3);
-		PWM_generator.SetPulse(940, 4);
+		for (uint8_t i = 0; i < Frame_Mixer::MOTORS; i++) {
+			this->motors[i] = this->MOTOR_OFF;
+			PWM_generator.SetPulse(this->MOTOR_OFF, Frame_Mixer::Get_Channel(i));
+		}
 	}
 }
 
@@ -128,20 +157,41 @@ uint16_t Motors_Controller::Get_Throttle() {
 	return this->throttle;
 }
 
+bool Motors_Controller::Get_Tilt_Lock() {
+	return this->tilt_lock;
+}
+
+bool Motors_Controller::Get_Motors_Off() {
+	return this->throttle < this->MOTOR_IDLE || this->tilt_lock;
+}
+
+uint32_t Motors_Controller::Get_Sample_Age() {
+	return this->sample_age;
+}
+
+// in order of Frame_Geometry table
+uint16_t Motors_Controller::Get_Motor(uint8_t index) {
+	if (index >= Frame_Mixer::MOTORS)
+		return 0;
+
+	return this->motors[index];
+}
+
+// quad X names, FL, BL, FR, BR is the table order
 uint16_t Motors_Controller::Get_Motor_FL() {
-	return this->motor_FL;
+	return this->Get_Motor(0);
 }
 
 uint16_t Motors_Controller::Get_Motor_FR() {
-	return this->motor_FR;
+	return this->Get_Motor(2);
 }
 
 uint16_t Motors_Controller::Get_Motor_BL() {
-	return this->motor_BL;
+	return this->Get_Motor(1);
 }
 
 uint16_t Motors_Controller::Get_Motor_BR() {
-	return this->motor_BR;
+	return this->Get_Motor(3);
 }
 
 } /* namespace flyhero */
@@ -89,4 +89,8 @@ void PID::Set_I_Max(float i_max) {
 	this->i_max = i_max;
 }
 
+void PID::Set_D_Term_LPF(float sample_frequency, float cut_frequency) {
+	this->d_term_lpf.Set_Coefficients(Biquad_Filter::FILTER_LOW_PASS, sample_frequency, cut_frequency);
+}
+
 } /* namespace flyhero */
@@ -0,0 +1,102 @@
+/*
+ * PID3.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "PID3.h"
+
+namespace flyhero {
+
+PID3::PID3(uint16_t rate, float d_term_cut_frequency)
+	: d_term_lpf(Biquad_Filter::FILTER_LOW_PASS, rate, d_term_cut_frequency)
+{
+	this->max_dt = float(this->MAX_DT_PERIODS) / rate;
+
+	for (uint8_t i = 0; i < this->AXES; i++) {
+		this->Kp[i] = 0;
+		this->Ki[i] = 0;
+		this->Kd[i] = 0;
+		this->i_max[i] = 0;
+	}
+
+	this->Reset();
+}
+
+void PID3::Update(uint32_t timestamp, const float error[AXES], float output[AXES]) {
+	float dt = (timestamp - this->last_t) * 0.000001f;
+
+	// first run after a pause is P only
+	if (this->last_t == 0 || dt > this->max_dt) {
+		this->Reset();
+		dt = 0;
+	}
+
+	this->last_t = timestamp;
+
+	if (dt <= 0) {
+		for (uint8_t i = 0; i < this->AXES; i++) {
+			output[i] = error[i] * this->Kp[i];
+			this->last_error[i] = error[i];
+		}
+
+		return;
+	}
+
+	float inv_dt = 1 / dt;
+	float derivative[AXES];
+
+	for (uint8_t i = 0; i < this->AXES; i++) {
+		derivative[i] = (error[i] - this->last_error[i]) * inv_dt;
+		this->last_error[i] = error[i];
+	}
+
+	this->d_term_lpf.Apply_Filter(derivative, derivative);
+
+	for (uint8_t i = 0; i < this->AXES; i++) {
+		this->integrator[i] += error[i] * this->Ki[i] * dt;
+
+		if (this->integrator[i] < -this->i_max[i])
+			this->integrator[i] = -this->i_max[i];
+		if (this->integrator[i] > this->i_max[i])
+			this->integrator[i] = this->i_max[i];
+
+		output[i] = error[i] * this->Kp[i] + this->integrator[i] + derivative[i] * this->Kd[i];
+	}
+}
+
+void PID3::Reset() {
+	this->last_t = 0;
+
+	for (uint8_t i = 0; i < this->AXES; i++) {
+		this->integrator[i] = 0;
+		this->last_error[i] = 0;
+	}
+
+	// stale derivative would kick the first output after rearming
+	this->d_term_lpf.Reset();
+}
+
+// also resets D term filters
+void PID3::Set_Rate(uint16_t rate, float d_term_cut_frequency) {
+	this->max_dt = float(this->MAX_DT_PERIODS) / rate;
+
+	this->d_term_lpf.Set_Coefficients(Biquad_Filter::FILTER_LOW_PASS, rate, d_term_cut_frequency);
+}
+
+void PID3::Set_Constants(uint8_t axis, float Kp, float Ki, float Kd) {
+	if (axis >= this->AXES)
+		return;
+
+	this->Kp[axis] = Kp;
+	this->Ki[axis] = Ki;
+	this->Kd[axis] = Kd;
+}
+
+void PID3::Set_I_Max(float i_max) {
+	for (uint8_t i = 0; i < this->AXES; i++)
+		this->i_max[i] = i_max;
+}
+
+} /* namespace flyhero */
@@ -0,0 +1,201 @@
+/*
+ * Scheduler.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Scheduler.h"
+
+namespace flyhero {
+
+Scheduler& Scheduler::Instance() {
+	static Scheduler instance;
+
+	return instance;
+}
+
+Scheduler::Scheduler() {
+	this->task_count = 0;
+}
+
+HAL_StatusTypeDef Scheduler::Init(const Task *tasks, uint8_t count) {
+	if (count > this->MAX_TASKS)
+		return HAL_ERROR;
+
+	uint32_t now = Timer::Get_Tick_Count();
+
+	for (uint8_t i = 0; i < count; i++) {
+		if (tasks[i].function == NULL || tasks[i].period_us == 0)
+			return HAL_ERROR;
+
+		this->tasks[i].task = tasks[i];
+		this->tasks[i].due_us = now;
+		this->tasks[i].last_start_us = 0;
+		this->tasks[i].trigger_us = 0;
+		this->tasks[i].pending = false;
+		this->tasks[i].started = false;
+		this->tasks[i].deferred = false;
+	}
+
+	this->task_count = count;
+	this->Reset_Statistics();
+
+	return HAL_OK;
+}
+
+// called from interrupt
+void Scheduler::Trigger(uint8_t task) {
+	Task_State& state = this->tasks[task];
+
+	// previous trigger was not served yet
+	if (state.pending)
+		state.statistics.misses++;
+
+	state.trigger_us = Timer::Get_Tick_Count();
+	state.pending = true;
+}
+
+bool Scheduler::fits(uint32_t budget_us, uint32_t now) {
+	for (uint8_t i = 0; i < this->task_count; i++) {
+		Task_State& state = this->tasks[i];
+
+		if (!state.task.triggered || !state.task.enabled || !state.started)
+			continue;
+		if (state.pending)
+			return false;
+
+		uint32_t since_trigger = now - state.trigger_us;
+
+		// trigger source stopped, do not starve the rest
+		if (since_trigger > 2 * state.task.period_us)
+			continue;
+
+		if (since_trigger + budget_us + this->TRIGGER_MARGIN_US > state.task.period_us)
+			return false;
+	}
+
+	return true;
+}
+
+void Scheduler::execute(Task_State& state, uint32_t due_us, uint32_t now) {
+	Task_Statistics& statistics = state.statistics;
+
+	uint32_t latency = now - due_us;
+
+	if (latency > statistics.max_latency_us)
+		statistics.max_latency_us = latency;
+
+	if (state.started) {
+		uint32_t interval = now - state.last_start_us;
+		uint32_t jitter = interval > state.task.period_us ? interval - state.task.period_us : state.task.period_us - interval;
+
+		if (jitter > statistics.max_jitter_us)
+			statistics.max_jitter_us = jitter;
+
+		statistics.jitter_sum_us += jitter;
+	}
+
+	state.last_start_us = now;
+	state.started = true;
+	state.deferred = false;
+
+	state.task.function();
+
+	uint32_t duration = Timer::Get_Tick_Count() - now;
+
+	statistics.runs++;
+	statistics.last_duration_us = duration;
+
+	if (duration > statistics.max_duration_us)
+		statistics.max_duration_us = duration;
+	if (duration > state.task.budget_us)
+		statistics.overruns++;
+}
+
+// runs the first ready task, returns false when there was nothing to do
+bool Scheduler::Run() {
+	uint32_t now = Timer::Get_Tick_Count();
+
+	for (uint8_t i = 0; i < this->task_count; i++) {
+		Task_State& state = this->tasks[i];
+
+		if (!state.task.enabled)
+			continue;
+
+		if (state.task.triggered) {
+			if (!state.pending)
+				continue;
+
+			state.pending = false;
+			this->execute(state, state.trigger_us, now);
+
+			return true;
+		}
+
+		if (int32_t(now - state.due_us) < 0)
+			continue;
+
+		if (!this->fits(state.task.budget_us, now)) {
+			if (!state.deferred)
+				state.statistics.deferrals++;
+
+			state.deferred = true;
+			continue;
+		}
+
+		uint32_t due = state.due_us;
+		uint32_t lost = (now - due) / state.task.period_us;
+
+		state.statistics.misses += lost;
+		state.due_us += (lost + 1) * state.task.period_us;
+
+		this->execute(state, due, now);
+
+		return true;
+	}
+
+	return false;
+}
+
+void Scheduler::Set_Enabled(uint8_t task, bool enabled) {
+	Task_State& state = this->tasks[task];
+
+	if (enabled && !state.task.enabled) {
+		state.due_us = Timer::Get_Tick_Count();
+		state.pending = false;
+		state.started = false;
+	}
+
+	state.task.enabled = enabled;
+}
+
+uint8_t Scheduler::Get_Task_Count() {
+	return this->task_count;
+}
+
+const Scheduler::Task& Scheduler::Get_Task(uint8_t task) {
+	return this->tasks[task].task;
+}
+
+const Scheduler::Task_Statistics& Scheduler::Get_Statistics(uint8_t task) {
+	return this->tasks[task].statistics;
+}
+
+uint32_t Scheduler::Get_Average_Jitter_us(uint8_t task) {
+	const Task_Statistics& statistics = this->tasks[task].statistics;
+
+	if (statistics.runs < 2)
+		return 0;
+
+	return uint32_t(statistics.jitter_sum_us / (statistics.runs - 1));
+}
+
+void Scheduler::Reset_Statistics() {
+	for (uint8_t i = 0; i < this->task_count; i++) {
+		this->tasks[i].statistics = Task_Statistics();
+		this->tasks[i].started = false;
+	}
+}
+
+} /* namespace flyhero */
@@ -0,0 +1,105 @@
+/*
+ * Timing_Probe.cpp
+ *
+ *  Created on: 18. 10. 2026
+ *      Author: michp
+ */
+
+#include "Timing_Probe.h"
+
+namespace flyhero {
+
+Timing_Probe *Timing_Probe::probes[Timing_Probe::MAX_PROBES];
+uint8_t Timing_Probe::probe_count = 0;
+uint32_t Timing_Probe::ticks_per_us = 1;
+
+Timing_Probe::Timing_Probe(const char *name, uint32_t bin_width_us) {
+	this->name = name;
+	this->bin_width_us = bin_width_us != 0 ? bin_width_us : 1;
+	this->start_ticks = 0;
+	this->Reset();
+
+	// probes are globals or members of singletons, registry is never shrunk
+	if (Timing_Probe::probe_count < Timing_Probe::MAX_PROBES) {
+		Timing_Probe::probes[Timing_Probe::probe_count] = this;
+		Timing_Probe::probe_count++;
+	}
+}
+
+void Timing_Probe::Init() {
+#ifdef SIL
+	Timing_Probe::ticks_per_us = 1000;
+#else
+	// enable DWT cycle counter
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	Timing_Probe::ticks_per_us = SystemCoreClock / 1000000;
+#endif
+}
+
+uint32_t Timing_Probe::Get_Ticks_Per_us() {
+	return Timing_Probe::ticks_per_us;
+}
+
+uint8_t Timing_Probe::Get_Probe_Count() {
+	return Timing_Probe::probe_count;
+}
+
+Timing_Probe* Timing_Probe::Get_Probe(uint8_t index) {
+	if (index >= Timing_Probe::probe_count)
+		return NULL;
+
+	return Timing_Probe::probes[index];
+}
+
+void Timing_Probe::Add(uint32_t ticks) {
+	if (this->statistics.count == 0 || ticks < this->statistics.min)
+		this->statistics.min = ticks;
+	if (ticks > this->statistics.max)
+		this->statistics.max = ticks;
+
+	this->statistics.count++;
+	this->statistics.sum += ticks;
+
+	uint32_t bin = ticks / (this->bin_width_us * Timing_Probe::ticks_per_us);
+
+	if (bin >= this->HISTOGRAM_BINS)
+		bin = this->HISTOGRAM_BINS - 1;
+
+	this->statistics.histogram[bin]++;
+}
+
+void Timing_Probe::Reset() {
+	this->statistics = Statistics();
+}
+
+const char* Timing_Probe::Get_Name() {
+	return this->name;
+}
+
+uint32_t Timing_Probe::Get_Bin_Width_us() {
+	return this->bin_width_us;
+}
+
+const Timing_Probe::Statistics& Timing_Probe::Get_Statistics() {
+	return this->statistics;
+}
+
+float Timing_Probe::Get_Min_us() {
+	return float(this->statistics.min) / Timing_Probe::ticks_per_us;
+}
+
+float Timing_Probe::Get_Average_us() {
+	if (this->statistics.count == 0)
+		return 0;
+
+	return float(this->statistics.sum) / this->statistics.count / Timing_Probe::ticks_per_us;
+}
+
+float Timing_Probe::Get_Max_us() {
+	return float(this->statistics.max) / Timing_Probe::ticks_per_us;
+}
+
+} /* namespace flyhero */
@@ -8,16 +8,24 @@
   ******************************************************************************
 */
 
+#include <string.h>
 #include "PWM_Generator.h"
 #include "ESP.h"
 #include "MS5611.h"
-#include "MPU6050.h"
+#include "IMU.h"
 #include "LEDs.h"
 #include "NEO_M8N.h"
 #include "PID.h"
 #include "Logger.h"
 #include "Timer.h"
 #include "ESP_Connection.h"
+#include "Scheduler.h"
+#include "Timing_Probe.h"
+#include "Flash_Storage.h"
+#include "SPI_Flash.h"
+#include "Blackbox.h"
+#include "Telemetry_Capture.h"
+#include "CRC_Calculator.h"
 
 using namespace flyhero;
 
@@ -25,26 +33,117 @@ using namespace flyhero;
 extern "C" void initialise_monitor_handles(void);
 #endif
 
+// MPU6000 or ICM-20602 on SPI, MPU6050 on I2C
+const IMU_Type IMU_DEVICE = IMU_MPU6050;
+
 ESP& esp = ESP::Create_Instance(ESP8266);
 PWM_Generator& pwm = PWM_Generator::Instance();
-MPU6050& mpu = MPU6050::Instance();
+IMU& mpu = IMU::Create_Instance(IMU_DEVICE);
 MS5611& ms5611 = MS5611::Instance();
 NEO_M8N& neo = NEO_M8N::Instance();
 Logger& logger = Logger::Instance();
 Motors_Controller& motors_controller = Motors_Controller::Instance();
+Scheduler& scheduler = Scheduler::Instance();
+Flash_Storage& storage = Flash_Storage::Instance();
+SPI_Flash& flash = SPI_Flash::Instance();
+Blackbox& blackbox = Blackbox::Instance();
+Telemetry_Capture& capture = Telemetry_Capture::Instance();
+
+Timing_Probe start_read_probe("imu_start", 25);
+Timing_Probe control_probe("control", 25);
+Timing_Probe complete_read_probe("imu_read", 5);
+Timing_Probe ahrs_probe("ahrs", 10);
+Timing_Probe motors_probe("motors", 10);
 
 void Arm_Callback();
 void IPD_Callback(uint8_t link_ID, uint8_t *data, uint16_t length);
 void IMU_Data_Ready_Callback();
 void IMU_Data_Read_Callback();
+void Control_Task();
+void IMU_Task();
+void Notch_Task();
+void Calibration_Task();
+void Telemetry_Task();
+void Barometer_Task();
+void GPS_Task();
+void WiFi_Task();
+void Blackbox_Task();
+void Blackbox_Reply();
+
+// SPI reads every sample on data ready, 15 B at 11.25 MHz take ~11 us
+// I2C uses FIFO burst of 2 samples, count and data reads take ~830 us at 400 kHz
+const uint16_t SAMPLE_RATE = IMU_DEVICE == IMU_MPU6000 ? 8000 : 2000;
+const uint16_t RATE_LOOP_RATE = 1000;
+const bool IMU_FIFO = IMU_DEVICE == IMU_MPU6050;
+// samples come down to rate loop rate in the sample ISR, CIC2 rejects more
+// of what would alias from 8 kHz, boxcar is what FIFO averaging did before
+const IMU::Sample_Decimator::Order IMU_DECIMATION = IMU_DEVICE == IMU_MPU6000
+		? IMU::Sample_Decimator::ORDER_CIC2 : IMU::Sample_Decimator::ORDER_BOXCAR;
+// accel corrects attitude at angle loop rate, rate loops between only integrate gyro
+const uint16_t ANGLE_LOOP_RATE = 1000;
+// attitude rotated ahead by sample age, new compare values wait for the next
+// 2 kHz PWM update, half a period on average; off until tried in flight
+const bool LATENCY_COMPENSATION = false;
+const uint32_t PWM_OUTPUT_DELAY_US = 250;
+
+// sector 7 is reserved in LinkerScript.ld
+const uint32_t STORAGE_SECTOR = FLASH_SECTOR_7;
+const uint32_t STORAGE_ADDRESS = 0x08060000;
+const uint32_t STORAGE_SIZE = 128 * 1024;
+// erased at boot below that, records written until next boot have to fit
+const uint32_t STORAGE_RESERVE = 16 * 1024;
+const uint16_t CALIBRATION_KEY = 0x0001;
+const uint16_t GYRO_BIAS_KEY = 0x0002;
+// the bias model changes slowly, flash does not have to follow every update
+const uint32_t GYRO_BIAS_STORE_INTERVAL = 60000;	// [ms]
+
+// every control loop, 84 B frames fill 16 MB of flash in 200 s
+const Logger::Data_Type BLACKBOX_DATA = Logger::Accel_All | Logger::Gyro_All | Logger::Euler_All
+		| Logger::Throttle | Logger::Motors_All | Logger::Sample_Age;
+// read back over the telemetry link, the ground stops telemetry first;
+// replies end with CRC32 as telemetry frames do
+// a chunk is a blocking read of ~190 us, less than a control period
+const uint16_t BLACKBOX_CHUNK_SIZE = 512;
+enum Blackbox_Command { BLACKBOX_INFO, BLACKBOX_READ, BLACKBOX_ERASE, BLACKBOX_STOP };
+
+enum Task_ID { CONTROL_TASK, IMU_TASK, NOTCH_TASK, CALIBRATION_TASK, TELEMETRY_TASK, BLACKBOX_TASK, BAROMETER_TASK, GPS_TASK, WIFI_TASK };
+
+// in priority order, must match Task_ID
+const Scheduler::Task TASKS[] = {
+	// name			function			period	budget	triggered	enabled
+	{ "control",	&Control_Task,		1000,	150,	true,		true },
+	// starts FIFO burst read, replaces data ready interrupt
+	{ "imu",		&IMU_Task,			1000,	20,		false,		IMU_FIFO },
+	// one FFT stage per run, an axis is analysed every 10 ms
+	{ "notch",		&Notch_Task,		1000,	25,		false,		true },
+	// offsets when none are stored, then gyro bias over temperature, storing overruns
+	{ "calibration",	&Calibration_Task,	10000,	20,		false,		true },
+	{ "telemetry",	&Telemetry_Task,	1000,	250,	false,		true },
+	// starts programming of filled pages, polls the flash otherwise
+	{ "blackbox",	&Blackbox_Task,		1000,	20,		false,		true },
+	// not fitted yet, ConvertD1() has to be issued before enabling
+	{ "barometer",	&Barometer_Task,	10000,	100,	false,		false },
+	{ "gps",		&GPS_Task,			100000,	300,	false,		false },
+	{ "wifi",		&WiFi_Task,			100,	100,	false,		true },
+};
+
+static_assert(sizeof(TASKS) / sizeof(TASKS[0]) <= Scheduler::MAX_TASKS, "scheduler cannot take all tasks");
 
 bool connected = false;
 bool start = false;
+// offsets are taken this boot, not loaded
+bool calibrating = false;
 bool inverse_yaw = false;
 IWDG_HandleTypeDef hiwdg;
 
 volatile bool data_received = false;
-volatile bool log_flag = false;
+int32_t temperature, pressure;
+
+// the last command waits for the link to be free
+volatile bool blackbox_request = false;
+uint8_t blackbox_command;
+uint32_t blackbox_offset;
+uint8_t blackbox_reply[8 + BLACKBOX_CHUNK_SIZE + 4];
 
 int main(void)
 {
@@ -52,6 +151,7 @@ int main(void)
 #ifdef LOG
 	initialise_monitor_handles();
 #endif
+	Timing_Probe::Init();
 
 	uint32_t timestamp;
 
@@ -60,7 +160,7 @@ int main(void)
 	hiwdg.Instance = IWDG;
 	hiwdg.Init.Prescaler = IWDG_PRESCALER_32;
 	hiwdg.Init.Reload = 480;
-	// timeout after 2 s
+	// timeout after 480 ms, too short for a flash sector erase
 
 	// reset gyro
 	if (mpu.Init()) {
@@ -68,7 +168,27 @@ int main(void)
 		while (true);
 	}
 
+	// offsets stored by a previous boot make calibration unnecessary
+	IMU::Calibration calibration;
+	Gyro_Bias_Model::Table gyro_bias;
+
+	// may erase, watchdog is not running yet
+	if (storage.Init(STORAGE_SECTOR, STORAGE_ADDRESS, STORAGE_SIZE, STORAGE_RESERVE) == HAL_OK) {
+		if (storage.Read(CALIBRATION_KEY, &calibration, sizeof(calibration)) == HAL_OK)
+			mpu.Set_Calibration(calibration);
+
+		if (storage.Read(GYRO_BIAS_KEY, &gyro_bias, sizeof(gyro_bias)) == HAL_OK)
+			mpu.Get_Gyro_Bias_Model().Set_Table(gyro_bias);
+	}
+
 	logger.Init();
+
+	// flies without, only nothing is recorded
+	if (blackbox.Init(&flash) != HAL_OK)
+		LEDs::TurnOn(LEDs::Orange);
+
+	blackbox.Set_Data_Type(BLACKBOX_DATA);
+
 	esp.Init(&IPD_Callback);
 
 	timestamp = HAL_GetTick();
@@ -86,11 +206,6 @@ int main(void)
 	pwm.Init();
 	pwm.Arm(&Arm_Callback);
 
-	if (mpu.Calibrate() != HAL_OK) {
-		LEDs::TurnOn(LEDs::Yellow);
-		while (true);
-	}
-
 	pwm.SetPulse(1100, 1);
 	pwm.SetPulse(1100, 2);
 	pwm.SetPulse(1100, 3);
@@ -114,25 +229,57 @@ int main(void)
 
 	LEDs::TurnOn(LEDs::Green);
 
+	if (mpu.Set_Sample_Rate(SAMPLE_RATE) || mpu.Set_FIFO_Mode(IMU_FIFO)
+			|| mpu.Set_Decimation(SAMPLE_RATE / RATE_LOOP_RATE, IMU_DECIMATION)) {
+		LEDs::TurnOn(LEDs::Yellow);
+		while (true);
+	}
+
+	mpu.Set_Read_Rate(RATE_LOOP_RATE);
+	mpu.Set_Latency_Compensation(LATENCY_COMPENSATION, PWM_OUTPUT_DELAY_US);
+	// gyro LPF stays at 60 Hz until raised cut is tried in flight
+	mpu.Set_Dynamic_Notch(true);
+	motors_controller.Set_Loop_Rates(RATE_LOOP_RATE, ANGLE_LOOP_RATE);
+
 #ifndef LOG
 	HAL_IWDG_Init(&hiwdg);
 #endif
 
+	if (scheduler.Init(TASKS, sizeof(TASKS) / sizeof(TASKS[0])) != HAL_OK) {
+		LEDs::TurnOn(LEDs::Yellow);
+		while (true);
+	}
+
+	// runs from the sample stream, motors stay off until it is done
+	if (mpu.Get_Calibration_State() != IMU::CALIBRATION_DONE) {
+		mpu.Start_Calibration();
+		calibrating = true;
+	}
+
 	mpu.Data_Ready_Callback = &IMU_Data_Ready_Callback;
 	mpu.Data_Read_Callback = &IMU_Data_Read_Callback;
 
-	while (true) {
-		if (log_flag) {
-			log_flag = false;
+	// fails when flash is missing or full
+	blackbox.Start();
 
-			// 200 us
-			logger.Send_Data();
-		}
-		esp.Get_Connection('4')->Connection_Send_Continue();
-	}
+	while (true)
+		scheduler.Run();
 }
 
 void IPD_Callback(uint8_t link_ID, uint8_t *data, uint16_t length) {
+	uint32_t crc;
+
+	// commands end with CRC32 of the bytes before it, the same one telemetry
+	// frames carry, a damaged command is ignored
+	if (length <= 4)
+		return;
+
+	length -= 4;
+	memcpy(&crc, data + length, 4);
+
+	if (crc != CRC_Calculator::Instance().Calculate(data, length))
+		return;
+
 	switch (length) {
 	case 22:
 		// around 75 us
@@ -186,6 +333,19 @@ void IPD_Callback(uint8_t link_ID, uint8_t *data, uint16_t length) {
 			motors_controller.Set_Invert_Yaw(data[21] == 0x01);
 		}
 		break;
+	case 19:
+		// rate loop constants, angle loop ones come with throttle
+		if (data[0] == 0x6D) {
+			uint16_t constants[9];
+
+			for (uint8_t i = 0; i < 9; i++)
+				constants[i] = (data[2 * i + 1] << 8) | data[2 * i + 2];
+
+			motors_controller.Set_Rate_PID_Constants(Roll, constants[0] * 0.001f, constants[1] * 0.001f, constants[2] * 0.001f);
+			motors_controller.Set_Rate_PID_Constants(Pitch, constants[3] * 0.001f, constants[4] * 0.001f, constants[5] * 0.001f);
+			motors_controller.Set_Rate_PID_Constants(Yaw, constants[6] * 0.001f, constants[7] * 0.001f, constants[8] * 0.001f);
+		}
+		break;
 	case 3:
 		if (data[0] == 0x3D) {
 			start = true;
@@ -197,6 +357,23 @@ void IPD_Callback(uint8_t link_ID, uint8_t *data, uint16_t length) {
 			logger.Set_Data_Type(Logger::WiFi, (Logger::Data_Type)log_options);
 		}
 		break;
+	case 5:
+		// log options including the extended data types
+		if (data[0] == 0x5D) {
+			connected = true;
+			uint32_t log_options = (data[1] << 24) | (data[2] << 16) | (data[3] << 8) | data[4];
+
+			logger.Set_Data_Type(Logger::WiFi, (Logger::Data_Type)log_options);
+		}
+		break;
+	case 6:
+		// blackbox command, offset of read
+		if (data[0] == 0x7E) {
+			blackbox_command = data[1];
+			blackbox_offset = (data[2] << 24) | (data[3] << 16) | (data[4] << 8) | data[5];
+			blackbox_request = true;
+		}
+		break;
 	}
 }
 
@@ -206,22 +383,210 @@ void Arm_Callback() {
 }
 
 void IMU_Data_Ready_Callback() {
-	// 160 us
+	start_read_probe.Start();
+
 	if (mpu.Start_Read() != HAL_OK)
 		LEDs::TurnOn(LEDs::Orange);
+
+	start_read_probe.Stop();
 }
 
-// IMU_Data_Ready_Callback() -> 340 us -> IMU_Data_Read_Callback()
+// IMU_Data_Ready_Callback() -> 340 us I2C, 11 us SPI -> IMU_Data_Read_Callback()
+// FIFO mode: IMU_Task() -> count -> burst -> IMU_Data_Read_Callback()
 
 void IMU_Data_Read_Callback() {
+	static uint8_t samples = 0;
+
+	// burst holds everything sampled since the last read
+	if (mpu.Get_FIFO_Mode()) {
+		scheduler.Trigger(CONTROL_TASK);
+		return;
+	}
+
+	// IMU may sample faster than control runs
+	samples++;
+
+	if (samples >= mpu.Get_Output_Rate() / RATE_LOOP_RATE) {
+		samples = 0;
+		scheduler.Trigger(CONTROL_TASK);
+	}
+}
+
+void Control_Task() {
+	static uint8_t rate_loops = 0;
+
+	control_probe.Start();
+
 	if (data_received)
 		HAL_IWDG_Refresh(&hiwdg);
 	data_received = false;
-	log_flag = true;
 
+	complete_read_probe.Start();
 	mpu.Complete_Read();
-	mpu.Compute_Mahony();
-	//mpu.Compute_Euler();
+	complete_read_probe.Stop();
 
+	if (mpu.Get_Calibration_State() != IMU::CALIBRATION_DONE) {
+		capture.Push();
+		control_probe.Stop();
+		return;
+	}
+
+	rate_loops++;
+
+	if (rate_loops >= RATE_LOOP_RATE / ANGLE_LOOP_RATE) {
+		rate_loops = 0;
+
+		ahrs_probe.Start();
+		mpu.Compute_Attitude();
+		motors_controller.Update_Angle_Loop();
+		ahrs_probe.Stop();
+	}
+	else
+		mpu.Predict_Attitude();
+
+	motors_probe.Start();
 	motors_controller.Update_Motors();
+	motors_probe.Stop();
+
+	// telemetry of this cycle, sent and recorded in the background
+	capture.Push();
+
+	control_probe.Stop();
+}
+
+void IMU_Task() {
+	start_read_probe.Start();
+
+	if (mpu.Start_Read() != HAL_OK)
+		LEDs::TurnOn(LEDs::Orange);
+
+	start_read_probe.Stop();
+}
+
+void Notch_Task() {
+	mpu.Get_Dynamic_Notch().Step();
+}
+
+void Calibration_Task() {
+	static uint32_t gyro_bias_updates = 0;
+	static uint32_t gyro_bias_ticks = 0;
+	IMU::Calibration calibration;
+	Gyro_Bias_Model::Table gyro_bias;
+	// a smooth turn in flight looks stationary, flash writes stall the control loop
+	bool motors_off = motors_controller.Get_Motors_Off();
+
+	mpu.Set_Bias_Learning(motors_off);
+
+	if (mpu.Update_Calibration() != IMU::CALIBRATION_DONE)
+		return;
+
+	if (calibrating) {
+		calibrating = false;
+
+		if (!mpu.Get_Calibration(calibration) || storage.Write(CALIBRATION_KEY, &calibration, sizeof(calibration)))
+			LEDs::TurnOn(LEDs::Orange);
+	}
+
+	Gyro_Bias_Model& model = mpu.Get_Gyro_Bias_Model();
+
+	// the first update this boot is stored right away
+	if (!motors_off || model.Get_Updates() == gyro_bias_updates
+			|| (gyro_bias_updates != 0 && HAL_GetTick() - gyro_bias_ticks < GYRO_BIAS_STORE_INTERVAL))
+		return;
+
+	gyro_bias_updates = model.Get_Updates();
+	gyro_bias_ticks = HAL_GetTick();
+
+	model.Get_Table(gyro_bias);
+
+	if (storage.Write(GYRO_BIAS_KEY, &gyro_bias, sizeof(gyro_bias)))
+		LEDs::TurnOn(LEDs::Orange);
+}
+
+void Telemetry_Task() {
+	logger.Send_Data();
+}
+
+void Barometer_Task() {
+	if (ms5611.D1_Ready())
+		ms5611.ConvertD2();
+	else if (ms5611.D2_Ready()) {
+		ms5611.GetData(&temperature, &pressure);
+		ms5611.ConvertD1();
+	}
+}
+
+void GPS_Task() {
+	neo.ParseData();
+}
+
+void WiFi_Task() {
+	ESP_Connection *connection = esp.Get_Connection('4');
+
+	if (blackbox_request && connection->Get_State() == CONNECTION_READY)
+		Blackbox_Reply();
+
+	connection->Connection_Send_Continue();
+}
+
+void Blackbox_Task() {
+	blackbox.Process();
+}
+
+// 0x7E, command, offset (uint32), length (uint16), data, CRC32; big endian
+// but CRC, which is the little endian one of telemetry frames
+// info: recorded size as offset, capacity as data
+// read: up to BLACKBOX_CHUNK_SIZE bytes from offset, none past the end
+void Blackbox_Reply() {
+	uint32_t offset = blackbox_offset;
+	uint16_t length = 0;
+
+	blackbox_request = false;
+
+	switch (blackbox_command) {
+	case BLACKBOX_INFO: {
+		uint32_t capacity = blackbox.Get_Capacity();
+
+		offset = blackbox.Get_Size();
+		blackbox_reply[8] = capacity >> 24;
+		blackbox_reply[9] = capacity >> 16;
+		blackbox_reply[10] = capacity >> 8;
+		blackbox_reply[11] = capacity;
+		length = 4;
+		break;
+	}
+	case BLACKBOX_READ:
+		if (offset < blackbox.Get_Size()) {
+			length = blackbox.Get_Size() - offset < BLACKBOX_CHUNK_SIZE
+					? blackbox.Get_Size() - offset : BLACKBOX_CHUNK_SIZE;
+
+			if (blackbox.Read(offset, blackbox_reply + 8, length) != HAL_OK)
+				length = 0;
+		}
+		break;
+	case BLACKBOX_ERASE:
+		// about 40 s, info shows size 0 once done
+		if (blackbox.Erase() != HAL_OK)
+			return;
+		break;
+	case BLACKBOX_STOP:
+		blackbox.Stop();
+		break;
+	default:
+		return;
+	}
+
+	blackbox_reply[0] = 0x7E;
+	blackbox_reply[1] = blackbox_command;
+	blackbox_reply[2] = offset >> 24;
+	blackbox_reply[3] = offset >> 16;
+	blackbox_reply[4] = offset >> 8;
+	blackbox_reply[5] = offset;
+	blackbox_reply[6] = length >> 8;
+	blackbox_reply[7] = length;
+
+	uint32_t crc = CRC_Calculator::Instance().Calculate(blackbox_reply, 8 + length);
+	memcpy(blackbox_reply + 8 + length, &crc, 4);
+
+	esp.Get_Connection('4')->Connection_Send_Begin(blackbox_reply, 8 + length + 4);
 }
@@ -8,6 +8,7 @@
 #include <ESP.h>
 #include "ESP32.h"
 #include "ESP8266.h"
+#include "Timing_Probe.h"
 
 namespace flyhero {
 
@@ -32,6 +33,8 @@ extern "C" {
 
 ESP_Device ESP::device = NONE;
 
+static Timing_Probe process_probe("esp", 5);
+
 ESP& ESP::Create_Instance(ESP_Device dev) {
 	switch (dev) {
 	case ESP8266:
@@ -169,6 +172,8 @@ uint32_t ESP::bytes_available() {
 }
 
 void ESP::Process_Data() {
+	process_probe.Start();
+
 	if (this->bytes_available() > 0) {
 
 		if (this->inIPD && this->IPD_received < this->IPD_size) {
@@ -247,6 +252,8 @@ void ESP::Process_Data() {
 			}
 		}
 	}
+
+	process_probe.Stop();
 }
 
 void ESP::parse(char *str, uint16_t length) {